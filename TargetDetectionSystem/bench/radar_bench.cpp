@@ -0,0 +1,746 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+#include "CudaBackend.h"
+#include "DetectionBackend.h"
+#include "DetectionKernel.h"
+#include "FrameRecorder.h"
+#include "FrameReplay.h"
+#include "FusionEngine.h"
+#include "RadarFrame.h"
+#include "ScenarioGenerator.h"
+#include "ShardedDetection.h"
+#include "TargetDetector.h"
+#include "TargetHistory.h"
+#include "TargetSink.h"
+#include "TargetTracker.h"
+#include "ThreadPool.h"
+
+// Frame sizes sweep 10 .. 1M returns; the second argument picks a threat mix.
+//  Mixed   - the demo's uniform +/-2500 m cube, +/-400 m/s.
+//  Hostile - most returns inside 1000 m and fast, many CRITICAL.
+//  Clutter - mostly distant, slow returns that fail the threshold.
+namespace {
+
+enum class ThreatMix : int {
+    Mixed = 0,
+    Hostile = 1,
+    Clutter = 2
+};
+
+constexpr double kThreshold = 0.4;
+constexpr std::int64_t kMinReturns = 10;
+constexpr std::int64_t kMaxReturns = 1'000'000;
+
+RadarFrame makeFrame(std::size_t count, ThreatMix mix) {
+    std::mt19937_64 gen(0x5e17'1e1ULL + count * 3 + static_cast<std::size_t>(mix));
+    std::uniform_real_distribution<> unit(-1.0, 1.0);
+
+    double pos_span = 2500.0;
+    double vel_span = 400.0;
+    switch (mix) {
+        case ThreatMix::Mixed:   break;
+        case ThreatMix::Hostile: pos_span = 700.0; vel_span = 350.0; break;
+        case ThreatMix::Clutter: pos_span = 6000.0; vel_span = 40.0; break;
+    }
+
+    RadarFrame frame(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double x = unit(gen) * pos_span;
+        const double y = unit(gen) * pos_span;
+        const double z = unit(gen) * pos_span;
+        frame.push(x, y, z, unit(gen) * vel_span);
+    }
+    return frame;
+}
+
+const char* mixName(ThreatMix mix) {
+    switch (mix) {
+        case ThreatMix::Mixed:   return "mixed";
+        case ThreatMix::Hostile: return "hostile";
+        case ThreatMix::Clutter: return "clutter";
+    }
+    return "unknown";
+}
+
+void frameArguments(benchmark::internal::Benchmark* bench) {
+    for (int mix = 0; mix <= 2; ++mix) {
+        for (std::int64_t n = kMinReturns; n <= kMaxReturns; n *= 10) {
+            bench->Args({n, mix});
+        }
+    }
+    bench->ArgNames({"returns", "mix"});
+}
+
+void setCounters(benchmark::State& state, std::size_t returns) {
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * returns));
+    state.SetLabel(mixName(static_cast<ThreatMix>(state.range(1))));
+}
+
+void BM_CalculateThreat(benchmark::State& state) {
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    std::vector<double> distance(frame.size());
+    for (std::size_t i = 0; i < frame.size(); ++i) {
+        distance[i] = std::sqrt(frame.x[i] * frame.x[i] + frame.y[i] * frame.y[i] + frame.z[i] * frame.z[i]);
+    }
+
+    for (auto _ : state) {
+        unsigned acc = 0;
+        for (std::size_t i = 0; i < frame.size(); ++i) {
+            acc += static_cast<unsigned>(DetectionKernel::calculateThreat(frame.velocity[i], distance[i]));
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    setCounters(state, frame.size());
+}
+
+// The per-return signal processing stage (range, confidence, threshold,
+// threat) on one kernel backend; Scalar is the old processSignal loop.
+template <KernelBackend Backend>
+void BM_ProcessSignal(benchmark::State& state) {
+    if (!DetectionKernel::isSupported(Backend)) {
+        state.SkipWithError("backend not supported on this CPU");
+        return;
+    }
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    KernelScratch scratch;
+    const KernelOutput out = scratch.prepare(frame.size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DetectionKernel::run(Backend, frame, kThreshold, out));
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, frame.size());
+}
+
+// The same stage in single precision.
+template <KernelBackend Backend>
+void BM_ProcessSignalF32(benchmark::State& state) {
+    if (!DetectionKernel::isSupported(Backend)) {
+        state.SkipWithError("backend not supported on this CPU");
+        return;
+    }
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    KernelScratch scratch;
+    const KernelOutput out = scratch.prepare(frame.size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DetectionKernel::run(Backend, frame, kThreshold, out, KernelPrecision::Float32));
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, frame.size());
+}
+
+// Accuracy of the float32 kernel against the double path where it matters:
+// every return lies within half a metre of a doctrine range (500 m,
+// 1000 m) or the 1500 m threshold range, and within 0.5 m/s of a doctrine
+// speed (50, 100 m/s). Times the float32 kernel and reports, as counters,
+// the share of threat levels and threshold decisions that differ and the
+// worst range and confidence errors.
+RadarFrame makeBoundaryFrame(std::size_t count) {
+    constexpr double kRanges[] = {500.0, 1000.0, 1500.0};
+    constexpr double kSpeeds[] = {50.0, 100.0};
+    std::mt19937_64 gen(0xb0da + count);
+    std::uniform_real_distribution<> unit(-1.0, 1.0);
+    RadarFrame frame(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double range = kRanges[i % 3] + 0.5 * unit(gen);
+        const double azimuth = std::numbers::pi * unit(gen);
+        const double elevation = 0.5 * std::numbers::pi * unit(gen);
+        const double speed = kSpeeds[(i / 3) % 2] + 0.5 * unit(gen);
+        frame.push(range * std::cos(elevation) * std::cos(azimuth), range * std::cos(elevation) * std::sin(azimuth),
+                   range * std::sin(elevation), i % 2 ? -speed : speed);
+    }
+    return frame;
+}
+
+void BM_PrecisionBoundaries(benchmark::State& state) {
+    const RadarFrame frame = makeBoundaryFrame(static_cast<std::size_t>(state.range(0)));
+    KernelScratch exact_scratch;
+    KernelScratch single_scratch;
+    const KernelOutput exact = exact_scratch.prepare(frame.size());
+    const KernelOutput single = single_scratch.prepare(frame.size());
+    const std::size_t exact_count = DetectionKernel::run(frame, kThreshold, exact);
+
+    std::size_t single_count = 0;
+    for (auto _ : state) {
+        single_count = DetectionKernel::run(DetectionKernel::activeBackend(), frame, kThreshold, single,
+                                            KernelPrecision::Float32);
+        benchmark::ClobberMemory();
+    }
+
+    std::vector<std::uint8_t> kept(frame.size(), 0);
+    for (std::size_t k = 0; k < exact_count; ++k) kept[exact.selected[k]] ^= 1;
+    for (std::size_t k = 0; k < single_count; ++k) kept[single.selected[k]] ^= 2;
+    std::size_t threat_flips = 0;
+    std::size_t threshold_flips = 0;
+    double range_error = 0.0;
+    double confidence_error = 0.0;
+    for (std::size_t i = 0; i < frame.size(); ++i) {
+        threat_flips += exact.threat[i] != single.threat[i];
+        threshold_flips += kept[i] == 1 || kept[i] == 2;
+        range_error = std::max(range_error, std::abs(exact.range[i] - single.range[i]));
+        confidence_error = std::max(confidence_error, std::abs(exact.confidence[i] - single.confidence[i]));
+    }
+    const double n = static_cast<double>(frame.size());
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * frame.size()));
+    state.counters["threat_flip_ppm"] = 1e6 * static_cast<double>(threat_flips) / n;
+    state.counters["threshold_flip_ppm"] = 1e6 * static_cast<double>(threshold_flips) / n;
+    state.counters["max_range_err_m"] = range_error;
+    state.counters["max_conf_err"] = confidence_error;
+}
+
+template <TargetOrdering Ordering>
+void BM_Sort(benchmark::State& state) {
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    TargetDetector detector(kThreshold);
+    detector.setOrdering(TargetOrdering::None);
+    const auto unordered = detector.detectRadarTargets(frame);
+
+    detector.setOrdering(Ordering, 20);
+    std::vector<Target> targets;
+    // The copy is timed too; the None instantiation measures it alone.
+    for (auto _ : state) {
+        targets = unordered;
+        detector.orderTargets(targets);
+        benchmark::DoNotOptimize(targets.data());
+    }
+    setCounters(state, unordered.size());
+}
+
+void BM_DetectRadarTargets(benchmark::State& state) {
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    TargetDetector detector(kThreshold);
+    std::vector<Target> out;
+
+    for (auto _ : state) {
+        detector.scan(frame, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    setCounters(state, frame.size());
+}
+
+// Same scan behind the prefilter's threshold range gate alone, which
+// leaves the result unchanged; the clutter mix is where it pays off.
+void BM_DetectPrefiltered(benchmark::State& state) {
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    TargetDetector detector(kThreshold);
+    detector.setPrefilter(PrefilterConfig{});
+    std::vector<Target> out;
+
+    for (auto _ : state) {
+        detector.scan(frame, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    setCounters(state, frame.size());
+}
+
+void BM_DetectRadarTargetsParallel(benchmark::State& state) {
+    static ThreadPool pool;
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    TargetDetector detector(kThreshold);
+    detector.setThreadPool(&pool);
+    std::vector<Target> out;
+
+    for (auto _ : state) {
+        detector.scan(frame, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    setCounters(state, frame.size());
+    state.counters["threads"] = static_cast<double>(pool.participantCount());
+}
+
+// A doctrine outside the threshold family: threat scales with closing time
+// rather than fixed range bands, so it runs the inlined scalar kernel.
+struct ClosingTimePolicy {
+    static constexpr ThreatLevel classify(double velocity, double distance) noexcept {
+        const double speed = velocity < 0.0 ? -velocity : velocity;
+        if (distance < 5.0 * speed) return ThreatLevel::CRITICAL;
+        if (distance < 15.0 * speed) return ThreatLevel::HIGH;
+        if (distance < 30.0 * speed) return ThreatLevel::MEDIUM;
+        return ThreatLevel::LOW;
+    }
+};
+
+void BM_DetectRadarTargetsCustomPolicy(benchmark::State& state) {
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    BasicTargetDetector<ClosingTimePolicy> detector(kThreshold);
+    std::vector<Target> out;
+
+    for (auto _ : state) {
+        detector.scan(frame, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    setCounters(state, frame.size());
+}
+
+// Legacy nested-vector ingest, for comparison with the SoA path above.
+void BM_DetectRadarTargetsNested(benchmark::State& state) {
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), static_cast<ThreatMix>(state.range(1)));
+    std::vector<std::vector<double>> nested;
+    nested.reserve(frame.size());
+    for (std::size_t i = 0; i < frame.size(); ++i) {
+        nested.push_back({frame.x[i], frame.y[i], frame.z[i], frame.velocity[i]});
+    }
+    TargetDetector detector(kThreshold);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detector.detectRadarTargets(nested));
+    }
+    setCounters(state, frame.size());
+}
+
+// One tracker scan over a dense scene of slowly drifting objects: predict,
+// grid association against every live track, correct and lifecycle.
+void BM_TrackerUpdate(benchmark::State& state) {
+    const auto objects = static_cast<std::size_t>(state.range(0));
+    std::mt19937_64 gen(0x7ac4ULL + objects);
+    std::uniform_real_distribution<> unit(-1.0, 1.0);
+
+    std::vector<Target> scene(objects);
+    for (auto& target : scene) {
+        target.x = unit(gen) * 2500.0;
+        target.y = unit(gen) * 2500.0;
+        target.z = unit(gen) * 2500.0;
+    }
+    TargetTracker tracker;
+    std::vector<Target> detections;
+    auto stamp = std::chrono::system_clock::time_point{};
+
+    for (auto _ : state) {
+        detections = scene;
+        tracker.update(detections, stamp);
+        stamp += std::chrono::seconds(1);
+        benchmark::DoNotOptimize(detections.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * objects));
+    state.counters["tracks"] = static_cast<double>(tracker.trackCount());
+}
+
+// Replays a recorded sequence of frames from a memory mapping straight into
+// the detector, wrapping around at end of file: the deterministic
+// disk-bandwidth path for reproducing recorded scenes.
+void BM_ReplayScan(benchmark::State& state) {
+    constexpr std::size_t kFrames = 16;
+    const auto returns = static_cast<std::size_t>(state.range(0));
+    const auto mix = static_cast<ThreatMix>(state.range(1));
+    const auto path = std::filesystem::temp_directory_path() / "radar_bench_replay.rec";
+
+    FrameRecorder recorder;
+    if (!recorder.open(path.string())) {
+        state.SkipWithError("cannot write recording");
+        return;
+    }
+    const auto frame = makeFrame(returns, mix);
+    for (std::size_t f = 0; f < kFrames; ++f) {
+        recorder.write(frame, std::chrono::system_clock::time_point(std::chrono::milliseconds(100 * f)));
+    }
+    recorder.close();
+
+    FrameReplay replay(ReplayMode::AsFastAsPossible);
+    if (!replay.open(path.string())) {
+        state.SkipWithError("cannot map recording");
+        return;
+    }
+    TargetDetector detector(kThreshold);
+    std::vector<Target> out;
+
+    for (auto _ : state) {
+        auto next = replay.next();
+        if (!next) {
+            replay.seek(0);
+            next = replay.next();
+        }
+        detector.scan(next->view, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    setCounters(state, returns);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * frameRecordBytes(returns)));
+
+    replay.close();
+    std::filesystem::remove(path);
+}
+
+// Scenario generation throughput: one frame of returns (a fifth of them
+// tracked objects, the rest clutter) per iteration, serial and on the pool.
+ScenarioConfig scenarioFor(std::size_t returns) {
+    ScenarioConfig config;
+    config.objects = returns / 5;
+    config.clutter_per_frame = returns - config.objects;
+    return config;
+}
+
+void BM_GenerateScenario(benchmark::State& state) {
+    static ThreadPool pool;
+    const auto returns = static_cast<std::size_t>(state.range(0));
+    const ScenarioGenerator generator(scenarioFor(returns), state.range(1) ? &pool : nullptr);
+    RadarFrame frame;
+    std::uint64_t index = 0;
+
+    for (auto _ : state) {
+        generator.generate(index, 0.1 * static_cast<double>(index), frame);
+        ++index;
+        benchmark::DoNotOptimize(frame.x.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * returns));
+}
+
+// End-to-end detection on generated scenes rather than the uniform cube.
+void BM_DetectScenario(benchmark::State& state) {
+    const auto returns = static_cast<std::size_t>(state.range(0));
+    const ScenarioGenerator generator(scenarioFor(returns));
+    RadarFrame frame;
+    generator.generate(0, 0.0, frame);
+    TargetDetector detector(kThreshold);
+    std::vector<Target> out;
+
+    for (auto _ : state) {
+        detector.scan(frame, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * returns));
+}
+
+// One distributed scan over a moving scenario split across a grid of
+// shards on an in-process network: every worker's detect, track and
+// handoff pass plus the coordinator's merge, run back to back. Against
+// shards=1 it shows the cost of cutting the scene; handed-off tracks per
+// scan are reported as a counter.
+void BM_ShardedScan(benchmark::State& state) {
+    constexpr std::size_t kFrames = 8;
+    const auto returns = static_cast<std::size_t>(state.range(0));
+    const auto side = static_cast<std::uint32_t>(state.range(1));
+    ShardLayout layout;
+    layout.columns = side;
+    layout.rows = side;
+    const std::uint32_t shards = layout.shardCount();
+
+    const ScenarioGenerator generator(scenarioFor(returns));
+    std::vector<std::vector<RadarFrame>> frames(kFrames, std::vector<RadarFrame>(shards));
+    RadarFrame scene;
+    for (std::size_t f = 0; f < kFrames; ++f) {
+        generator.generate(f, static_cast<double>(f), scene);
+        layout.route(scene, frames[f]);
+    }
+
+    LoopbackShardNetwork network(shards);
+    std::vector<std::unique_ptr<TargetDetector>> detectors;
+    std::vector<std::unique_ptr<TargetTracker>> trackers;
+    std::vector<std::unique_ptr<ShardWorker>> workers;
+    for (std::uint32_t s = 0; s < shards; ++s) {
+        detectors.push_back(std::make_unique<TargetDetector>(kThreshold));
+        trackers.push_back(std::make_unique<TargetTracker>(ShardWorker::trackerConfig(layout, s)));
+        workers.push_back(std::make_unique<ShardWorker>(layout, s, *detectors[s], *trackers[s], network.endpoint(s)));
+    }
+    ShardCoordinator coordinator(shards);
+    auto stamp = std::chrono::system_clock::time_point{};
+    std::size_t frame = 0;
+
+    for (auto _ : state) {
+        for (std::uint32_t s = 0; s < shards; ++s) workers[s]->scan(frames[frame][s], stamp);
+        coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+        benchmark::DoNotOptimize(coordinator.topThreats().data());
+        frame = (frame + 1) % kFrames;
+        stamp += std::chrono::seconds(1);
+    }
+    std::uint64_t handoffs = 0;
+    for (const auto& worker : workers) handoffs += worker->stats().handoffs_sent;
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * returns));
+    state.counters["handoffs_per_scan"] = static_cast<double>(handoffs) / static_cast<double>(state.iterations());
+}
+
+// One fusion window over a moving scenario seen by sensors sensors, each
+// reporting returns returns: per-sensor detection, fanned out on the pool
+// when parallel is set, then one prediction and a correction per sensor.
+// Time per item stays flat as sensors grow if a sensor costs only its own
+// returns.
+void BM_Fusion(benchmark::State& state) {
+    static ThreadPool pool;
+    constexpr std::size_t kFrames = 8;
+    const auto returns = static_cast<std::size_t>(state.range(0));
+    const auto sensors = static_cast<std::size_t>(state.range(1));
+
+    const ScenarioGenerator generator(scenarioFor(returns));
+    std::vector<RadarFrame> frames(kFrames);
+    for (std::size_t f = 0; f < kFrames; ++f) generator.generate(f, static_cast<double>(f) * 0.1, frames[f]);
+
+    constexpr auto kWindow = std::chrono::milliseconds(100);
+    FusionEngine engine(kWindow);
+    if (state.range(2) != 0) engine.setThreadPool(&pool);
+    for (std::size_t s = 0; s < sensors; ++s) {
+        SensorSpec spec;
+        spec.name = "sensor" + std::to_string(s);
+        spec.position_sigma = {10.0 + 5.0 * static_cast<double>(s), 10.0, 10.0};
+        spec.confidence_threshold = kThreshold;
+        engine.addSensor(spec);
+    }
+    auto stamp = std::chrono::system_clock::time_point{};
+    std::size_t frame = 0;
+
+    for (auto _ : state) {
+        for (std::size_t s = 0; s < sensors; ++s) engine.submit(s, stamp, frames[frame].view());
+        stamp += kWindow;
+        engine.fuse(stamp);
+        benchmark::DoNotOptimize(engine.lastWindow().targets.data());
+        frame = (frame + 1) % kFrames;
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * returns * sensors));
+    state.counters["tracks"] = static_cast<double>(engine.tracker().trackCount());
+}
+
+// Detection with the clustering stage: every object in the mixed cube
+// shows up as four returns within a few metres, so a correct clusterer
+// yields about a quarter as many targets.
+RadarFrame makeSplitFrame(std::size_t returns) {
+    const RadarFrame objects = makeFrame(std::max<std::size_t>(returns / 4, 1), ThreatMix::Mixed);
+    std::mt19937_64 gen(0xc105 + returns);
+    std::uniform_real_distribution<> jitter(-3.0, 3.0);
+    RadarFrame frame(returns);
+    for (std::size_t i = 0; i < returns; ++i) {
+        const std::size_t o = i % objects.size();
+        frame.push(objects.x[o] + jitter(gen), objects.y[o] + jitter(gen), objects.z[o] + jitter(gen),
+                   objects.velocity[o] + jitter(gen));
+    }
+    return frame;
+}
+
+void BM_DetectClustered(benchmark::State& state) {
+    static ThreadPool pool;
+    const auto returns = static_cast<std::size_t>(state.range(0));
+    const RadarFrame frame = makeSplitFrame(returns);
+    TargetDetector detector(kThreshold);
+    ClusterConfig config;
+    config.epsilon = 10.0;
+    detector.setClustering(config);
+    if (state.range(1)) detector.setThreadPool(&pool);
+    std::vector<Target> out;
+
+    for (auto _ : state) {
+        detector.scan(frame, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * returns));
+    state.counters["targets"] = static_cast<double>(out.size());
+}
+
+// Where offload pays: one full scan per frame size on the chunked CPU
+// detector (0), the same on the thread pool (1) or offloaded whole to the
+// CUDA backend (2, skipped without a device). The frame size at which (2)
+// overtakes the best CPU row is the crossover to pass to setOffload() or
+// --offload; TargetDetector::kDefaultOffloadCrossover is only a placeholder.
+void BM_Backend(benchmark::State& state) {
+    static ThreadPool pool;
+    static const std::unique_ptr<CudaBackend> cuda = CudaBackend::create();
+    const auto frame = makeFrame(static_cast<std::size_t>(state.range(0)), ThreatMix::Mixed);
+    TargetDetector detector(kThreshold);
+    switch (state.range(1)) {
+        case 1: detector.setThreadPool(&pool); break;
+        case 2:
+            if (!cuda) {
+                state.SkipWithError("no CUDA device");
+                return;
+            }
+            detector.setOffload(cuda.get(), 0);
+            break;
+        default: break;
+    }
+    std::vector<Target> out;
+
+    for (auto _ : state) {
+        detector.scan(frame, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * frame.size()));
+}
+
+// History of a tracked scenario: one scan per 100 ms, detected and run
+// through the tracker so rows carry track ids, as the pipeline stores them.
+std::vector<std::vector<Target>> trackedScans(std::size_t returns, std::size_t scans) {
+    const ScenarioGenerator generator(scenarioFor(returns));
+    TargetDetector detector(kThreshold);
+    TargetTracker tracker;
+    RadarFrame frame;
+    std::vector<std::vector<Target>> history(scans);
+    auto stamp = std::chrono::system_clock::time_point{} + std::chrono::hours(24 * 365);
+    for (std::size_t i = 0; i < scans; ++i) {
+        generator.generate(i, 0.1 * static_cast<double>(i), frame);
+        detector.scan(frame, history[i]);
+        for (auto& target : history[i]) target.detection_time = stamp;
+        tracker.update(history[i], stamp);
+        stamp += std::chrono::milliseconds(100);
+    }
+    return history;
+}
+
+HistoryConfig historyConfig(bool quantized) {
+    HistoryConfig config;
+    if (quantized) {
+        config.position_quantum = 0.01;
+        config.velocity_quantum = 0.01;
+        config.confidence_quantum = 1e-4;
+    }
+    return config;
+}
+
+void setHistoryCounters(benchmark::State& state, const TargetHistory& history) {
+    const HistoryStats stats = history.stats();
+    state.counters["bytes_per_row"] = static_cast<double>(stats.bytes) / static_cast<double>(std::max<std::uint64_t>(stats.rows, 1));
+    state.counters["vs_raw"] = static_cast<double>(stats.raw_bytes) / static_cast<double>(std::max<std::size_t>(stats.bytes, 1));
+}
+
+// Appending five minutes of tracked scans, sealing a chunk every 10 s,
+// exact or quantised to a centimetre.
+void BM_HistoryAppend(benchmark::State& state) {
+    const HistoryConfig config = historyConfig(state.range(1) != 0);
+    const auto scans = trackedScans(static_cast<std::size_t>(state.range(0)), 3000);
+    std::size_t rows = 0;
+    for (const auto& scan : scans) rows += scan.size();
+
+    for (auto _ : state) {
+        TargetHistory history(config);
+        for (const auto& scan : scans) history.append(scan);
+        benchmark::DoNotOptimize(&history);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rows));
+    TargetHistory history(config);
+    for (const auto& scan : scans) history.append(scan);
+    setHistoryCounters(state, history);
+}
+
+// Queries over the same five minutes, quantised. query 0 counts CRITICAL rows across
+// all of it, 1 pulls positions for a 30 s window and 2 every column of the
+// longest track, so each decodes a different set of columns and chunks.
+void BM_HistoryQuery(benchmark::State& state) {
+    const auto scans = trackedScans(static_cast<std::size_t>(state.range(0)), 3000);
+    TargetHistory history(historyConfig(true));
+    for (const auto& scan : scans) history.append(scan);
+    const auto start = scans.front().front().detection_time;
+
+    HistoryQuery query;
+    std::uint32_t columns = kHistoryAll;
+    if (state.range(1) == 1) {
+        query.from = start + std::chrono::seconds(95);
+        query.to = query.from + std::chrono::seconds(30);
+        columns = kHistoryStamp | kHistoryId | kHistoryPosition;
+    } else if (state.range(1) == 2) {
+        // The longest-lived track.
+        std::vector<std::uint32_t> ids;
+        for (const auto& scan : scans) {
+            for (const auto& target : scan) ids.push_back(target.id);
+        }
+        std::ranges::sort(ids);
+        std::size_t best = 0;
+        for (std::size_t i = 0, run = 0; i < ids.size(); ++i) {
+            run = i > 0 && ids[i] == ids[i - 1] ? run + 1 : 1;
+            if (run > best) {
+                best = run;
+                query.id = ids[i];
+            }
+        }
+    }
+    std::vector<Target> out;
+    std::size_t rows = 0;
+    for (auto _ : state) {
+        if (state.range(1) == 0) {
+            query.min_threat = ThreatLevel::CRITICAL;
+            rows = history.count(query);
+        } else {
+            out.clear();
+            rows = history.query(query, out, columns);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rows));
+    state.counters["rows"] = static_cast<double>(rows);
+    setHistoryCounters(state, history);
+}
+
+// Output cost per scan: one frame's detections handed to a sink. Stream
+// sinks write to the null device so only formatting and stdio are timed.
+#ifdef _WIN32
+constexpr const char* kNullDevice = "NUL";
+#else
+constexpr const char* kNullDevice = "/dev/null";
+#endif
+
+std::vector<Target> sinkTargets(std::size_t returns) {
+    TargetDetector detector(kThreshold);
+    std::vector<Target> targets;
+    detector.scan(makeFrame(returns, ThreatMix::Mixed), targets);
+    return targets;
+}
+
+template <SinkFormat Format>
+void BM_StreamSink(benchmark::State& state) {
+    const auto targets = sinkTargets(static_cast<std::size_t>(state.range(0)));
+    StreamSink sink(Format);
+    if (!sink.open(kNullDevice)) {
+        state.SkipWithError("cannot open null device");
+        return;
+    }
+    std::uint64_t sequence = 0;
+    for (auto _ : state) {
+        sink.write(targets, sequence++);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * targets.size()));
+}
+
+void BM_SharedRingSink(benchmark::State& state) {
+    const auto targets = sinkTargets(static_cast<std::size_t>(state.range(0)));
+    const auto path = std::filesystem::temp_directory_path() / "radar_bench_sink.ring";
+    SharedRingSink sink(std::max<std::size_t>(targets.size(), 1) * 4);
+    if (!sink.open(path.string())) {
+        state.SkipWithError("cannot map ring");
+        return;
+    }
+    std::uint64_t sequence = 0;
+    for (auto _ : state) {
+        sink.write(targets, sequence++);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * targets.size()));
+
+    sink.close();
+    std::filesystem::remove(path);
+}
+
+} // namespace
+
+BENCHMARK(BM_CalculateThreat)->Apply(frameArguments);
+BENCHMARK(BM_ProcessSignal<KernelBackend::Scalar>)->Apply(frameArguments);
+BENCHMARK(BM_ProcessSignal<KernelBackend::AVX2>)->Apply(frameArguments);
+BENCHMARK(BM_ProcessSignal<KernelBackend::AVX512>)->Apply(frameArguments);
+BENCHMARK(BM_ProcessSignalF32<KernelBackend::Scalar>)->Apply(frameArguments);
+BENCHMARK(BM_ProcessSignalF32<KernelBackend::AVX2>)->Apply(frameArguments);
+BENCHMARK(BM_ProcessSignalF32<KernelBackend::AVX512>)->Apply(frameArguments);
+BENCHMARK(BM_PrecisionBoundaries)->Arg(1'000'000)->ArgName("returns");
+BENCHMARK(BM_Sort<TargetOrdering::FullSort>)->Apply(frameArguments);
+BENCHMARK(BM_Sort<TargetOrdering::ThreatBuckets>)->Apply(frameArguments);
+BENCHMARK(BM_Sort<TargetOrdering::None>)->Apply(frameArguments);
+BENCHMARK(BM_DetectRadarTargets)->Apply(frameArguments);
+BENCHMARK(BM_DetectPrefiltered)->Apply(frameArguments);
+BENCHMARK(BM_DetectRadarTargetsParallel)->Apply(frameArguments)->UseRealTime();
+BENCHMARK(BM_DetectRadarTargetsNested)->Apply(frameArguments);
+BENCHMARK(BM_DetectRadarTargetsCustomPolicy)->Apply(frameArguments);
+BENCHMARK(BM_ReplayScan)->Apply(frameArguments);
+BENCHMARK(BM_GenerateScenario)->ArgsProduct({{1'000, 100'000, 1'000'000}, {0, 1}})->ArgNames({"returns", "parallel"})->UseRealTime();
+BENCHMARK(BM_DetectScenario)->RangeMultiplier(10)->Range(1'000, 1'000'000)->ArgName("returns");
+BENCHMARK(BM_DetectClustered)->ArgsProduct({{1'000, 100'000, 1'000'000}, {0, 1}})->ArgNames({"returns", "parallel"})->UseRealTime();
+BENCHMARK(BM_ShardedScan)->ArgsProduct({{10'000, 100'000}, {1, 2, 4}})->ArgNames({"returns", "side"});
+BENCHMARK(BM_Fusion)->ArgsProduct({{10'000, 100'000}, {1, 2, 4}, {0, 1}})->ArgNames({"returns", "sensors", "parallel"})->UseRealTime();
+BENCHMARK(BM_Backend)->ArgsProduct({{10'000, 100'000, 1'000'000, 4'000'000}, {0, 1, 2}})->ArgNames({"returns", "backend"})->UseRealTime();
+BENCHMARK(BM_StreamSink<SinkFormat::Text>)->RangeMultiplier(10)->Range(100, 100'000)->ArgName("returns");
+BENCHMARK(BM_StreamSink<SinkFormat::Binary>)->RangeMultiplier(10)->Range(100, 100'000)->ArgName("returns");
+BENCHMARK(BM_SharedRingSink)->RangeMultiplier(10)->Range(100, 100'000)->ArgName("returns");
+BENCHMARK(BM_HistoryAppend)->ArgsProduct({{1'000, 10'000}, {0, 1}})->ArgNames({"returns", "quantized"})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HistoryQuery)->ArgsProduct({{1'000, 10'000}, {0, 1, 2}})->ArgNames({"returns", "query"});
+BENCHMARK(BM_TrackerUpdate)->RangeMultiplier(10)->Range(100, 100'000)->ArgName("objects");
+
+BENCHMARK_MAIN();
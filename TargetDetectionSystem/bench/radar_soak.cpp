@@ -0,0 +1,509 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DetectionPipeline.h"
+#include "Instrumentation.h"
+#include "RadarFrame.h"
+#include "RecordingFormat.h"
+#include "ScanArena.h"
+#include "ScanScheduler.h"
+#include "ScenarioGenerator.h"
+#include "TargetDetector.h"
+#include "TargetTracker.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+// Long-running regression harness. Drives the detector, tracker and
+// pipeline from the scenario generator in two phases:
+//
+//   cycle     detect + track back to back on one thread, frames on a
+//             ScanArena; times each cycle and digests the first scans
+//   pipeline  the three-stage pipeline at a fixed scan rate; times each
+//             result from ingest to output
+//
+// After a warm-up, memory must stay flat: no growth in the detector's
+// result capacity, the arena's block or overflows, and resident memory
+// within the tolerance. Cycle and end-to-end p99 must stay within any
+// absolute budgets given, and within the tolerance of a stored baseline
+// along with throughput; the golden digest must match it exactly. Exits
+// non-zero on any failure.
+//
+// Usage: radar_soak [--duration SECONDS] [--returns N] [--rate HZ] [--golden SCANS]
+//                   [--tolerance PERCENT] [--budget-cycle-p99 US] [--budget-pipeline-p99 US]
+//                   [--baseline FILE] [--write-baseline FILE]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kThreshold = 0.4;
+// Scenario time between scans. The cycle phase runs faster than this, the
+// pipeline phase at --rate; either way the scene is the same.
+constexpr double kScanPeriodS = 0.1;
+// Detection stamps are synthetic so the golden digest does not depend on
+// the wall clock or on how fast the machine is.
+const auto kEpoch = std::chrono::system_clock::time_point{} + std::chrono::seconds(1'700'000'000);
+
+struct SoakConfig {
+    // Per phase.
+    double duration_s{30.0};
+    std::size_t returns{10'000};
+    double rate_hz{10.0};
+    std::uint64_t golden_scans{1000};
+    double tolerance_pct{10.0};
+    double budget_cycle_p99_us{0.0};
+    double budget_pipeline_p99_us{0.0};
+    std::string baseline_path;
+    std::string write_baseline_path;
+};
+
+// The figures a baseline stores.
+struct SoakResult {
+    std::size_t returns{};
+    std::uint64_t golden_scans{};
+    std::uint64_t golden{};
+    // Every golden line of a baseline file. The scene's trigonometry goes
+    // through libm, so a digest-only file may list one per toolchain.
+    std::vector<std::uint64_t> accepted_golden;
+    double cycle_p99_us{};
+    double scans_per_s{};
+    double pipeline_p99_us{};
+};
+
+struct MemoryMark {
+    std::size_t target_capacity{};
+    std::size_t arena_capacity{};
+    std::size_t arena_overflows{};
+    std::size_t resident_bytes{};
+};
+
+class LatencyHistogram {
+public:
+    void record(Clock::duration elapsed) noexcept {
+        const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 0));
+        ++histogram_.buckets[LatencyBuckets::index(ns)];
+        ++histogram_.count;
+        histogram_.sum_ns += ns;
+        histogram_.max_ns = std::max(histogram_.max_ns, ns);
+    }
+
+    std::uint64_t count() const noexcept { return histogram_.count; }
+    double meanUs() const noexcept { return histogram_.meanNs() / 1000.0; }
+    double percentileUs(double q) const noexcept { return static_cast<double>(histogram_.percentileNs(q)) / 1000.0; }
+    double maxUs() const noexcept { return static_cast<double>(histogram_.max_ns) / 1000.0; }
+
+private:
+    HistogramSnapshot histogram_{};
+};
+
+std::size_t residentBytes() {
+#ifdef __linux__
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    unsigned long pages = 0;
+    unsigned long resident = 0;
+    const bool parsed = std::fscanf(statm, "%lu %lu", &pages, &resident) == 2;
+    std::fclose(statm);
+    return parsed ? static_cast<std::size_t>(resident) * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+// FNV-1a over every field of every target, scan by scan.
+class Digest {
+public:
+    void add(std::span<const Target> targets) noexcept {
+        const std::uint64_t count = targets.size();
+        mix(&count, sizeof(count));
+        for (const Target& target : targets) {
+            const std::int64_t stamp = toStampNs(target.detection_time);
+            mix(&target.id, sizeof(target.id));
+            mix(&target.description_id, sizeof(target.description_id));
+            mix(&target.threat_level, sizeof(target.threat_level));
+            mix(&target.x, sizeof(target.x));
+            mix(&target.y, sizeof(target.y));
+            mix(&target.z, sizeof(target.z));
+            mix(&target.velocity, sizeof(target.velocity));
+            mix(&target.confidence, sizeof(target.confidence));
+            mix(&stamp, sizeof(stamp));
+        }
+    }
+
+    std::uint64_t value() const noexcept { return hash_; }
+
+private:
+    std::uint64_t hash_{0xcbf29ce484222325ULL};
+
+    void mix(const void* data, std::size_t size) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) hash_ = (hash_ ^ bytes[i]) * 0x100000001b3ULL;
+    }
+};
+
+ScenarioConfig scenarioFor(std::size_t returns) {
+    ScenarioConfig config;
+    config.objects = std::max<std::size_t>(returns / 5, 1);
+    config.clutter_per_frame = returns - std::min(returns, config.objects);
+    return config;
+}
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void progress(const char* phase, std::uint64_t scans, Clock::time_point start, const LatencyHistogram& latency) {
+    std::printf("  %s: %.0f s, %" PRIu64 " scans, p99 %.1f us, max %.1f us, rss %.1f MiB\n", phase,
+                secondsSince(start), scans, latency.percentileUs(0.99), latency.maxUs(),
+                static_cast<double>(residentBytes()) / (1024.0 * 1024.0));
+    std::fflush(stdout);
+}
+
+class Checks {
+public:
+    void expect(bool ok, const char* what, const char* detail) {
+        std::printf("%s %s: %s\n", ok ? "PASS" : "FAIL", what, detail);
+        failures_ += ok ? 0 : 1;
+    }
+
+    // value must not exceed limit, or fall below it when lower is worse.
+    void limit(const char* what, double value, double limit, bool higher_is_worse = true) {
+        char detail[128];
+        std::snprintf(detail, sizeof(detail), "%.2f against %s %.2f", value, higher_is_worse ? "at most" : "at least",
+                      limit);
+        expect(higher_is_worse ? value <= limit : value >= limit, what, detail);
+    }
+
+    int failures() const noexcept { return failures_; }
+
+private:
+    int failures_{0};
+};
+
+void checkMemory(Checks& checks, const MemoryMark& warm, const MemoryMark& end, double tolerance_pct,
+                 const char* phase) {
+    char what[64];
+    char detail[128];
+    if (warm.target_capacity || end.target_capacity) {
+        std::snprintf(what, sizeof(what), "%s result capacity", phase);
+        std::snprintf(detail, sizeof(detail), "%zu after warm-up, %zu at end", warm.target_capacity,
+                      end.target_capacity);
+        checks.expect(end.target_capacity <= warm.target_capacity, what, detail);
+    }
+    if (warm.arena_capacity || end.arena_capacity) {
+        std::snprintf(what, sizeof(what), "%s arena", phase);
+        std::snprintf(detail, sizeof(detail), "%zu B block, %zu overflows after warm-up; %zu B, %zu at end",
+                      warm.arena_capacity, warm.arena_overflows, end.arena_capacity, end.arena_overflows);
+        checks.expect(end.arena_capacity <= warm.arena_capacity && end.arena_overflows == warm.arena_overflows, what,
+                      detail);
+    }
+    if (warm.resident_bytes > 0) {
+        std::snprintf(what, sizeof(what), "%s resident MiB", phase);
+        checks.limit(what, static_cast<double>(end.resident_bytes) / (1024.0 * 1024.0),
+                     static_cast<double>(warm.resident_bytes) / (1024.0 * 1024.0) * (1.0 + tolerance_pct / 100.0));
+    }
+}
+
+// Detect and track back to back. Runs at least golden_scans scans, then
+// until the deadline; the first tenth of the phase is warm-up.
+SoakResult runCycles(const SoakConfig& config, Checks& checks) {
+    const ScenarioGenerator generator(scenarioFor(config.returns));
+    TargetDetector detector(kThreshold);
+    TargetTracker tracker;
+    ScanArena arena;
+    std::vector<Target> tracked;
+    LatencyHistogram latency;
+    Digest digest;
+    MemoryMark warm;
+    bool warmed = false;
+
+    const auto start = Clock::now();
+    const auto warm_at = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(config.duration_s / 10.0));
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(config.duration_s));
+    auto next_report = start + std::chrono::minutes(1);
+    std::uint64_t scan = 0;
+    for (; scan < config.golden_scans || Clock::now() < deadline; ++scan) {
+        arena.reset();
+        const auto stamp = kEpoch + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::duration<double>(kScanPeriodS * static_cast<double>(scan)));
+        {
+            RadarFrame frame{RadarFrame::allocator_type(&arena)};
+            generator.generate(scan, kScanPeriodS * static_cast<double>(scan), frame);
+
+            const auto cycle_start = Clock::now();
+            const auto targets = detector.scan(frame.view());
+            tracked.assign(targets.begin(), targets.end());
+            for (Target& target : tracked) target.detection_time = stamp;
+            tracker.update(tracked, stamp);
+            const auto cycle_end = Clock::now();
+
+            if (warmed) latency.record(cycle_end - cycle_start);
+            if (scan < config.golden_scans) digest.add(tracked);
+            if (!warmed && cycle_end >= warm_at && scan >= 100) {
+                warm = {detector.getTargetCapacity(), arena.capacity(), arena.overflowCount(), residentBytes()};
+                warmed = true;
+            }
+            if (cycle_end >= next_report) {
+                progress("cycle", scan + 1, start, latency);
+                next_report += std::chrono::minutes(1);
+            }
+        }
+    }
+    // The last reset() is where an overflow in the final cycle would show.
+    arena.reset();
+    const double elapsed_s = secondsSince(start);
+    if (!warmed) {
+        warm = {detector.getTargetCapacity(), arena.capacity(), arena.overflowCount(), residentBytes()};
+    }
+    const MemoryMark end{detector.getTargetCapacity(), arena.capacity(), arena.overflowCount(), residentBytes()};
+
+    std::printf("cycle: %" PRIu64 " scans of %zu returns in %.1f s, %zu live tracks\n", scan, config.returns, elapsed_s,
+                tracker.trackCount());
+    std::printf("cycle latency: mean %.1f us, p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+                latency.meanUs(), latency.percentileUs(0.5), latency.percentileUs(0.99),
+                latency.percentileUs(0.999), latency.maxUs());
+    checkMemory(checks, warm, end, config.tolerance_pct, "cycle");
+
+    SoakResult result;
+    result.returns = config.returns;
+    result.golden_scans = config.golden_scans;
+    result.golden = digest.value();
+    result.cycle_p99_us = latency.percentileUs(0.99);
+    result.scans_per_s = static_cast<double>(scan) / elapsed_s;
+    return result;
+}
+
+ScanScheduler::Task feed(ScanScheduler& scheduler, std::size_t cadence, Clock::time_point deadline,
+                         DetectionPipeline& pipeline, const DetectionPipeline::FrameSource& fill) {
+    for (;;) {
+        const bool running = co_await scheduler.tick(cadence);
+        if (!running) break;
+        if (Clock::now() >= deadline || !pipeline.submit(fill)) scheduler.requestStop();
+    }
+}
+
+// The pipeline at a fixed scan rate, blocking rather than dropping at
+// either queue, so every scan is timed.
+double runPipeline(const SoakConfig& config, Checks& checks) {
+    const ScenarioGenerator generator(scenarioFor(config.returns));
+    TargetDetector detector(kThreshold);
+    TargetTracker tracker;
+    PipelineConfig pipeline_config;
+    pipeline_config.result_policy = BackpressurePolicy::Block;
+    DetectionPipeline pipeline(detector, pipeline_config);
+    pipeline.setTracker(&tracker);
+
+    const auto start = Clock::now();
+    const auto warm_at = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(config.duration_s / 10.0));
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(config.duration_s));
+
+    // Touched only on the output thread until wait() returns.
+    LatencyHistogram latency;
+    MemoryMark warm;
+    bool warmed = false;
+    std::uint64_t results = 0;
+    auto next_report = start + std::chrono::minutes(1);
+    pipeline.start([&](const ScanResult& result) {
+        const auto now = Clock::now();
+        ++results;
+        if (warmed) latency.record(now - result.ingested_at);
+        if (!warmed && now >= warm_at && results >= 10) {
+            warm.resident_bytes = residentBytes();
+            warmed = true;
+        }
+        if (now >= next_report) {
+            progress("pipeline", results, start, latency);
+            next_report += std::chrono::minutes(1);
+        }
+    });
+
+    std::uint64_t index = 0;
+    const DetectionPipeline::FrameSource fill = [&](RadarFrame& frame) {
+        generator.generate(index, kScanPeriodS * static_cast<double>(index), frame);
+        ++index;
+        return true;
+    };
+    ScanScheduler scheduler;
+    scheduler.spawn(feed(scheduler,
+                         scheduler.addCadence(std::chrono::duration_cast<ScanScheduler::Clock::duration>(
+                             std::chrono::duration<double>(1.0 / config.rate_hz))),
+                         deadline, pipeline, fill));
+    scheduler.run();
+    pipeline.finish();
+    pipeline.wait();
+
+    const PipelineStats stats = pipeline.stats();
+    const CadenceStats cadence = scheduler.stats(0);
+    MemoryMark end;
+    end.resident_bytes = residentBytes();
+    if (!warmed) warm = end;
+
+    std::printf("pipeline: %" PRIu64 " scans at %.1f Hz, %" PRIu64 " overruns, detect mean %.1f us, max %.1f us\n",
+                results, config.rate_hz, cadence.overruns, stats.detect.mean_us, stats.detect.max_us);
+    std::printf("pipeline latency: mean %.1f us, p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+                latency.meanUs(), latency.percentileUs(0.5), latency.percentileUs(0.99),
+                latency.percentileUs(0.999), latency.maxUs());
+    char detail[96];
+    std::snprintf(detail, sizeof(detail), "%" PRIu64 " frames, %" PRIu64 " results dropped", stats.frames_dropped,
+                  stats.results_dropped);
+    checks.expect(stats.frames_dropped == 0 && stats.results_dropped == 0 && results == index, "pipeline drops",
+                  detail);
+    checkMemory(checks, warm, end, config.tolerance_pct, "pipeline");
+    return latency.percentileUs(0.99);
+}
+
+// Baselines are "key value" lines; unknown keys are ignored. returns,
+// golden_scans and golden are required; golden may repeat, and any listed
+// digest matches. The timing keys are optional, and a baseline without
+// them, like the checked-in bench/soak.golden, checks only the digest and
+// memory.
+bool readBaseline(const std::string& path, SoakResult& baseline) {
+    std::FILE* in = std::fopen(path.c_str(), "r");
+    if (!in) return false;
+    char key[64];
+    char value[64];
+    int identity = 0;
+    while (std::fscanf(in, "%63s %63s", key, value) == 2) {
+        const std::string_view name = key;
+        if (name == "returns") {
+            baseline.returns = std::strtoull(value, nullptr, 10);
+            ++identity;
+        } else if (name == "golden_scans") {
+            baseline.golden_scans = std::strtoull(value, nullptr, 10);
+            ++identity;
+        } else if (name == "golden") {
+            baseline.golden = std::strtoull(value, nullptr, 16);
+            if (baseline.accepted_golden.empty()) ++identity;
+            baseline.accepted_golden.push_back(baseline.golden);
+        } else if (name == "cycle_p99_us") {
+            baseline.cycle_p99_us = std::atof(value);
+        } else if (name == "scans_per_s") {
+            baseline.scans_per_s = std::atof(value);
+        } else if (name == "pipeline_p99_us") {
+            baseline.pipeline_p99_us = std::atof(value);
+        }
+    }
+    std::fclose(in);
+    return identity == 3;
+}
+
+bool writeBaseline(const std::string& path, const SoakResult& result) {
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) return false;
+    std::fprintf(out, "returns %zu\ngolden_scans %" PRIu64 "\ngolden %016" PRIx64 "\n", result.returns,
+                 result.golden_scans, result.golden);
+    std::fprintf(out, "cycle_p99_us %.3f\nscans_per_s %.3f\npipeline_p99_us %.3f\n", result.cycle_p99_us,
+                 result.scans_per_s, result.pipeline_p99_us);
+    return std::fclose(out) == 0;
+}
+
+void compareBaseline(Checks& checks, const SoakResult& result, const SoakResult& baseline, double tolerance_pct) {
+    char detail[128];
+    if (baseline.returns != result.returns || baseline.golden_scans != result.golden_scans) {
+        std::snprintf(detail, sizeof(detail), "recorded with --returns %zu --golden %" PRIu64, baseline.returns,
+                      baseline.golden_scans);
+        checks.expect(false, "baseline", detail);
+        return;
+    }
+    const auto& accepted = baseline.accepted_golden;
+    std::snprintf(detail, sizeof(detail), "%016" PRIx64 " against %016" PRIx64 "%s", result.golden, accepted.front(),
+                  accepted.size() > 1 ? " and others" : "");
+    checks.expect(std::find(accepted.begin(), accepted.end(), result.golden) != accepted.end(), "golden digest",
+                  detail);
+    const double slack = tolerance_pct / 100.0;
+    if (baseline.cycle_p99_us > 0.0) {
+        checks.limit("cycle p99 us vs baseline", result.cycle_p99_us, baseline.cycle_p99_us * (1.0 + slack));
+    }
+    if (baseline.scans_per_s > 0.0) {
+        checks.limit("scans/s vs baseline", result.scans_per_s, baseline.scans_per_s * (1.0 - slack), false);
+    }
+    if (baseline.pipeline_p99_us > 0.0) {
+        checks.limit("pipeline p99 us vs baseline", result.pipeline_p99_us,
+                     baseline.pipeline_p99_us * (1.0 + slack));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SoakConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--duration" && i + 1 < argc) {
+            config.duration_s = std::max(std::atof(argv[++i]), 1.0);
+        } else if (arg == "--returns" && i + 1 < argc) {
+            config.returns = static_cast<std::size_t>(std::max(std::atol(argv[++i]), 1L));
+        } else if (arg == "--rate" && i + 1 < argc) {
+            config.rate_hz = std::atof(argv[++i]);
+            if (!(config.rate_hz > 0.0)) {
+                std::fprintf(stderr, "invalid rate %s\n", argv[i]);
+                return 2;
+            }
+        } else if (arg == "--golden" && i + 1 < argc) {
+            config.golden_scans = static_cast<std::uint64_t>(std::max(std::atol(argv[++i]), 0L));
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            config.tolerance_pct = std::max(std::atof(argv[++i]), 0.0);
+        } else if (arg == "--budget-cycle-p99" && i + 1 < argc) {
+            config.budget_cycle_p99_us = std::max(std::atof(argv[++i]), 0.0);
+        } else if (arg == "--budget-pipeline-p99" && i + 1 < argc) {
+            config.budget_pipeline_p99_us = std::max(std::atof(argv[++i]), 0.0);
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            config.baseline_path = argv[++i];
+        } else if (arg == "--write-baseline" && i + 1 < argc) {
+            config.write_baseline_path = argv[++i];
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--duration SECONDS] [--returns N] [--rate HZ] [--golden SCANS] "
+                         "[--tolerance PERCENT] [--budget-cycle-p99 US] [--budget-pipeline-p99 US] "
+                         "[--baseline FILE] [--write-baseline FILE]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    SoakResult baseline;
+    if (!config.baseline_path.empty() && !readBaseline(config.baseline_path, baseline)) {
+        std::fprintf(stderr, "cannot read baseline %s\n", config.baseline_path.c_str());
+        return 2;
+    }
+
+    std::printf("soak: %zu returns per scan, %.0f s per phase\n", config.returns, config.duration_s);
+    Checks checks;
+    SoakResult result = runCycles(config, checks);
+    result.pipeline_p99_us = runPipeline(config, checks);
+    std::printf("golden digest of %" PRIu64 " scans: %016" PRIx64 "\n", result.golden_scans, result.golden);
+
+    if (config.budget_cycle_p99_us > 0.0) {
+        checks.limit("cycle p99 us budget", result.cycle_p99_us, config.budget_cycle_p99_us);
+    }
+    if (config.budget_pipeline_p99_us > 0.0) {
+        checks.limit("pipeline p99 us budget", result.pipeline_p99_us, config.budget_pipeline_p99_us);
+    }
+    if (!config.baseline_path.empty()) compareBaseline(checks, result, baseline, config.tolerance_pct);
+    if (!config.write_baseline_path.empty()) {
+        if (!writeBaseline(config.write_baseline_path, result)) {
+            std::fprintf(stderr, "cannot write baseline %s\n", config.write_baseline_path.c_str());
+            return 2;
+        }
+        std::printf("baseline written to %s\n", config.write_baseline_path.c_str());
+    }
+
+    std::printf("%s: %d check%s failed\n", checks.failures() ? "FAILED" : "PASSED", checks.failures(),
+                checks.failures() == 1 ? "" : "s");
+    return checks.failures() ? 1 : 0;
+}
@@ -0,0 +1,33 @@
+# Training run for RADAR_PGO=GENERATE, invoked by the radar_pgo_train
+# target: clears old profiles, drives the instrumented radar_detection over
+# generated scenes on the paths a deployment exercises, then, for Clang,
+# merges the raw profiles into the file RADAR_PGO=USE reads.
+
+file(REMOVE_RECURSE ${PGO_DIR})
+file(MAKE_DIRECTORY ${PGO_DIR})
+
+set(RUNS
+    "--scenario 2000 --rate 100 --scans 1500"
+    "--scenario 2000 --rate 100 --scans 1000 --prefilter --history 0"
+    "--scenario 500 --rate 100 --scans 1000 --cluster 25 --float32")
+foreach(run IN LISTS RUNS)
+    message(STATUS "radar_detection ${run}")
+    separate_arguments(args UNIX_COMMAND "${run}")
+    execute_process(COMMAND ${RADAR_DETECTION} ${args} OUTPUT_QUIET RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "training run failed: ${result}")
+    endif()
+endforeach()
+
+if(COMPILER_ID MATCHES "Clang")
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "llvm-profdata not found; cannot merge the Clang profiles")
+    endif()
+    file(GLOB raw ${PGO_DIR}/*.profraw)
+    execute_process(COMMAND ${LLVM_PROFDATA} merge -output=${PGO_DIR}/radar.profdata ${raw}
+                    RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "llvm-profdata merge failed: ${result}")
+    endif()
+endif()
+message(STATUS "profiles written to ${PGO_DIR}; reconfigure with -DRADAR_PGO=USE and rebuild")
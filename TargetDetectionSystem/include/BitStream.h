@@ -0,0 +1,56 @@
+#ifndef BIT_STREAM_H
+#define BIT_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// LSB-first bit stream over 64-bit words, as used by the history codecs.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<std::uint64_t>& words) : words_(words) { words_.clear(); }
+
+    // Writes the low bits of value; bits is 1..64.
+    void put(std::uint64_t value, unsigned bits) {
+        if (bits < 64) value &= (std::uint64_t{1} << bits) - 1;
+        const unsigned offset = used_ % 64;
+        if (offset == 0) words_.push_back(0);
+        words_.back() |= value << offset;
+        if (offset + bits > 64) words_.push_back(value >> (64 - offset));
+        used_ += bits;
+    }
+
+    std::size_t bits() const noexcept { return used_; }
+
+private:
+    std::vector<std::uint64_t>& words_;
+    std::size_t used_{0};
+};
+
+// Reads what a BitWriter wrote, in the same order. No bounds checks: the
+// caller knows how many values the stream holds.
+class BitReader {
+public:
+    explicit BitReader(std::span<const std::uint64_t> words) noexcept : words_(words) {}
+
+    // bits is 1..64.
+    std::uint64_t get(unsigned bits) noexcept {
+        const std::size_t word = used_ / 64;
+        const unsigned offset = used_ % 64;
+        std::uint64_t value = words_[word] >> offset;
+        if (offset + bits > 64) value |= words_[word + 1] << (64 - offset);
+        used_ += bits;
+        return bits == 64 ? value : value & ((std::uint64_t{1} << bits) - 1);
+    }
+
+    bool bit() noexcept { return get(1) != 0; }
+
+    std::size_t bits() const noexcept { return used_; }
+
+private:
+    std::span<const std::uint64_t> words_;
+    std::size_t used_{0};
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef CUDA_BACKEND_H
+#define CUDA_BACKEND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include "DetectionBackend.h"
+
+struct CudaBackendConfig {
+    int device{0};
+    // Returns per transfer slice. Two slices are in flight at once, so the
+    // copy of one overlaps the kernel and copy-back of the other.
+    std::size_t slice_returns{std::size_t{1} << 20};
+};
+
+// CUDA implementation of the detection pass. Frames are cut into slices
+// and streamed through two pinned staging buffers on two streams, so one
+// slice's transfers overlap the other's kernels. Each slice is classified
+// by a kernel that matches the CPU arithmetic (no FMA contraction, IEEE
+// sqrt and divide) and its survivors are compacted on the device with
+// cub::DeviceSelect, preserving input order.
+// Available when built with -DRADAR_CUDA=ON; create() returns nullptr
+// otherwise, or when no device is present. A device error mid-frame
+// disables the backend and the frame is finished on the CPU kernel.
+// Experimental: the device path has not yet been built against a real
+// toolkit or checked against DetectionKernel on a device.
+class CudaBackend final : public DetectionBackend {
+public:
+    static std::unique_ptr<CudaBackend> create(const CudaBackendConfig& config = {});
+    ~CudaBackend() override;
+
+    CudaBackend(const CudaBackend&) = delete;
+    CudaBackend& operator=(const CudaBackend&) = delete;
+
+    std::string_view name() const noexcept override { return "cuda"; }
+
+    std::size_t runThreshold(const ThresholdKernelParams& params, const RadarFrameView& frame,
+                             double confidence_threshold, const KernelOutput& out,
+                             KernelPrecision precision) override;
+
+    bool isHealthy() const noexcept { return healthy_; }
+
+private:
+    struct Impl;
+
+    explicit CudaBackend(std::unique_ptr<Impl> impl) noexcept;
+
+    std::unique_ptr<Impl> impl_;
+    bool healthy_{true};
+};
+
+#endif
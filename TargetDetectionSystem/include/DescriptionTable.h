@@ -0,0 +1,42 @@
+#ifndef DESCRIPTION_TABLE_H
+#define DESCRIPTION_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Interns description strings so hot records can carry a 16-bit id instead
+// of an owning std::string. Id 0 is reserved for "no description".
+class DescriptionTable {
+public:
+    static constexpr std::uint16_t kNone = 0;
+
+    DescriptionTable();
+
+    // The index keys are views into entries_, so a copy would point back
+    // into the source. A move hands over the deque's blocks with the
+    // strings still in place, which keeps them valid. Not noexcept: the
+    // libstdc++ deque allocates a fresh map for the moved-from side. A
+    // moved-from table is empty and usable.
+    DescriptionTable(const DescriptionTable&) = delete;
+    DescriptionTable& operator=(const DescriptionTable&) = delete;
+    DescriptionTable(DescriptionTable&&) = default;
+    DescriptionTable& operator=(DescriptionTable&&) = default;
+
+    // Returns the id for text, adding it on first use. Returns kNone once
+    // the id space is exhausted.
+    std::uint16_t intern(std::string_view text);
+
+    // Empty view for kNone or unknown ids.
+    std::string_view lookup(std::uint16_t id) const noexcept;
+
+    std::size_t size() const noexcept { return entries_.empty() ? 0 : entries_.size() - 1; }
+
+private:
+    std::deque<std::string> entries_;
+    std::unordered_map<std::string_view, std::uint16_t> index_;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef DETECTION_BACKEND_H
+#define DETECTION_BACKEND_H
+
+#include <cstddef>
+#include <string_view>
+#include "DetectionKernel.h"
+#include "RadarFrame.h"
+
+// Where a whole frame's range, confidence, threshold and threat pass runs
+// when the detector offloads it (TargetDetectorCore::setOffload). Same
+// contract as KernelDispatch::runThreshold: every output column is indexed
+// like the frame, selected receives surviving indices in input order, and
+// the return value is how many survived.
+class DetectionBackend {
+public:
+    virtual ~DetectionBackend() = default;
+
+    virtual std::string_view name() const noexcept = 0;
+
+    virtual std::size_t runThreshold(const ThresholdKernelParams& params, const RadarFrameView& frame,
+                                     double confidence_threshold, const KernelOutput& out,
+                                     KernelPrecision precision) = 0;
+};
+
+// The in-process SIMD kernel behind the backend interface: the reference
+// every other backend is compared against, and a stand-in offload target
+// on machines without an accelerator.
+class CpuBackend final : public DetectionBackend {
+public:
+    explicit CpuBackend(KernelBackend backend = KernelDispatch::activeBackend()) noexcept
+        : backend_(backend) {}
+
+    std::string_view name() const noexcept override { return KernelDispatch::backendName(backend_); }
+
+    std::size_t runThreshold(const ThresholdKernelParams& params, const RadarFrameView& frame,
+                             double confidence_threshold, const KernelOutput& out,
+                             KernelPrecision precision) override {
+        return KernelDispatch::runThreshold(backend_, params, frame, confidence_threshold, out, precision);
+    }
+
+private:
+    KernelBackend backend_;
+};
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef DETECTION_KERNEL_H
+#define DETECTION_KERNEL_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "RadarFrame.h"
+#include "ThreatLevel.h"
+#include "ThreatPolicy.h"
+
+enum class KernelBackend {
+    Scalar,
+    AVX2,
+    AVX512
+};
+
+// Arithmetic of the threshold-family backends. Float32 rounds coordinates
+// and doctrine constants to float and evaluates range, confidence and
+// threat in single precision: twice the lanes per vector instruction, at
+// about 1e-7 relative error, far below sensor resolution. The frame and
+// the output columns stay double either way. Float64 is exact.
+enum class KernelPrecision {
+    Float64,
+    Float32
+};
+
+// Per-return columns written by the kernel. range/confidence/threat are
+// indexed like the input frame; selected receives the indices of returns
+// that passed the confidence threshold, in input order. Every span must hold
+// at least frame.size() elements.
+struct KernelOutput {
+    std::span<double> range{};
+    std::span<double> confidence{};
+    std::span<std::uint8_t> threat{};
+    std::span<std::uint32_t> selected{};
+
+    [[nodiscard]] KernelOutput subspan(std::size_t offset, std::size_t count) const noexcept {
+        return {range.subspan(offset, count), confidence.subspan(offset, count),
+                threat.subspan(offset, count), selected.subspan(offset, count)};
+    }
+};
+
+// Reusable storage for KernelOutput. Columns only ever grow, so a scratch
+// kept across scans stops allocating once it has seen the largest frame.
+struct KernelScratch {
+    std::vector<double> range;
+    std::vector<double> confidence;
+    std::vector<std::uint8_t> threat;
+    std::vector<std::uint32_t> selected;
+
+    KernelOutput prepare(std::size_t count) {
+        if (range.size() < count) {
+            range.resize(count);
+            confidence.resize(count);
+            threat.resize(count);
+            selected.resize(count);
+        }
+        return {
+            std::span(range).first(count),
+            std::span(confidence).first(count),
+            std::span(threat).first(count),
+            std::span(selected).first(count)
+        };
+    }
+};
+
+// Constants of a ThresholdThreatPolicy / InverseRangeConfidence pair, as
+// consumed by the vector backends. They are loop invariants, broadcast once
+// per call.
+struct ThresholdKernelParams {
+    double range_scale;
+    double critical_range;
+    double critical_speed;
+    double high_range;
+    double medium_speed;
+};
+
+// Backend selection shared by every kernel instantiation.
+class KernelDispatch {
+public:
+    // Widest backend supported by the running CPU, resolved once.
+    static KernelBackend activeBackend() noexcept;
+    static bool isSupported(KernelBackend backend) noexcept;
+    static std::string_view backendName(KernelBackend backend) noexcept;
+    static std::string_view precisionName(KernelPrecision precision) noexcept;
+
+    // Scalar, AVX2 and AVX-512 implementations of the threshold doctrine
+    // family; each agrees with the scalar path of the same precision bit
+    // for bit.
+    static std::size_t runThreshold(KernelBackend backend, const ThresholdKernelParams& params,
+                                    const RadarFrameView& frame, double confidence_threshold,
+                                    const KernelOutput& out,
+                                    KernelPrecision precision = KernelPrecision::Float64);
+};
+
+// Range, confidence, threshold and threat classification over one frame,
+// specialised at compile time on a threat policy and confidence model.
+// Threshold-family policies dispatch to the vector backends; any other
+// policy gets a scalar double loop with the policy inlined, whatever the
+// requested precision.
+template <ThreatPolicy Policy = DefaultThreatPolicy, ConfidenceModel Model = DefaultConfidenceModel>
+class BasicDetectionKernel : public KernelDispatch {
+public:
+    static constexpr bool kVectorized =
+        IsThresholdThreatPolicy<Policy>::value && IsInverseRangeConfidence<Model>::value;
+
+    // Scalar reference classification.
+    static ThreatLevel calculateThreat(double velocity, double distance) noexcept {
+        return Policy::classify(velocity, distance);
+    }
+
+    // Doctrine constants as handed to the vector and offload backends.
+    static constexpr ThresholdKernelParams thresholdParams() noexcept requires kVectorized {
+        return {Model::kRangeScale, Policy::kCriticalRange, Policy::kCriticalSpeed,
+                Policy::kHighRange, Policy::kMediumSpeed};
+    }
+
+    // Largest range whose confidence can still reach threshold, or
+    // infinity when the model has no closed-form inverse. Solved at a
+    // slightly lowered threshold, one part in 1e9 or 1e5 for float, so
+    // rounding in the kernel can never accept a return beyond it.
+    static double thresholdRange(double threshold,
+                                 KernelPrecision precision = KernelPrecision::Float64) noexcept {
+        if constexpr (IsInverseRangeConfidence<Model>::value) {
+            if (!(threshold > 0.0)) return std::numeric_limits<double>::infinity();
+            const double slack = precision == KernelPrecision::Float32 ? 1e-5 : 1e-9;
+            return (1.0 / (threshold * (1.0 - slack)) - 1.0) / Model::kRangeScale;
+        } else {
+            return std::numeric_limits<double>::infinity();
+        }
+    }
+
+    // Returns the number of selected returns.
+    static std::size_t run(const RadarFrameView& frame, double confidence_threshold,
+                           const KernelOutput& out) {
+        return run(activeBackend(), frame, confidence_threshold, out);
+    }
+
+    static std::size_t run(KernelBackend backend, const RadarFrameView& frame,
+                           double confidence_threshold, const KernelOutput& out,
+                           [[maybe_unused]] KernelPrecision precision = KernelPrecision::Float64) {
+        if constexpr (kVectorized) {
+            return runThreshold(backend, thresholdParams(), frame, confidence_threshold, out, precision);
+        } else {
+            return runGeneric(frame, confidence_threshold, out);
+        }
+    }
+
+private:
+    static std::size_t runGeneric(const RadarFrameView& frame, double threshold, const KernelOutput& out) {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < frame.size(); ++i) {
+            const double x = frame.x[i];
+            const double y = frame.y[i];
+            const double z = frame.z[i];
+            const double distance = std::sqrt(x*x + y*y + z*z);
+            const double confidence = Model::confidence(distance);
+
+            out.range[i] = distance;
+            out.confidence[i] = confidence;
+            out.threat[i] = static_cast<std::uint8_t>(Policy::classify(frame.velocity[i], distance));
+
+            out.selected[count] = static_cast<std::uint32_t>(i);
+            count += !(confidence < threshold);
+        }
+        return count;
+    }
+};
+
+using DetectionKernel = BasicDetectionKernel<>;
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef DETECTION_PIPELINE_H
+#define DETECTION_PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "RadarFrame.h"
+#include "RingBuffer.h"
+#include "ScanArena.h"
+#include "TargetDetector.h"
+#include "TargetTracker.h"
+
+struct PipelineConfig {
+    std::size_t frame_queue_depth{8};
+    std::size_t result_queue_depth{8};
+    // Blocking on frames keeps every return; dropping stale results means a
+    // slow output stage can never stall detection.
+    BackpressurePolicy frame_policy{BackpressurePolicy::Block};
+    BackpressurePolicy result_policy{BackpressurePolicy::DropOldest};
+    // CPU to pin each stage to; -1 leaves the stage unpinned.
+    int producer_cpu{-1};
+    int detector_cpu{-1};
+    int output_cpu{-1};
+    // Initial size of each frame slot's arena; it regrows to the largest
+    // frame seen.
+    std::size_t frame_arena_bytes{ScanArena::kDefaultBytes};
+};
+
+struct ScanResult {
+    std::uint64_t sequence{};
+    std::size_t raw_count{};
+    std::vector<Target> targets;
+    // The detector's aggregates as of this scan.
+    DetectionStats stats{};
+    std::chrono::steady_clock::time_point ingested_at{};
+    double detect_ms{};
+};
+
+struct StageTiming {
+    std::uint64_t count{};
+    double mean_us{};
+    double max_us{};
+};
+
+struct PipelineStats {
+    StageTiming ingest;
+    StageTiming detect;
+    StageTiming output;
+    StageTiming end_to_end;
+    std::size_t frame_queue_depth{};
+    std::size_t result_queue_depth{};
+    std::uint64_t frames_dropped{};
+    std::uint64_t results_dropped{};
+};
+
+// Three-stage runtime: a producer fills frames, the detector scans them and
+// an output stage consumes results, each on its own thread. Stages exchange
+// slot indices through lock-free rings. Frames and results are
+// preallocated and recycled, so steady-state operation allocates nothing:
+// each frame slot builds its frame on its own ScanArena, reset whenever
+// the slot is refilled.
+class DetectionPipeline {
+public:
+    // Fills the frame; returning false ends the stream.
+    using FrameSource = std::function<bool(RadarFrame&)>;
+    using ResultSink = std::function<void(const ScanResult&)>;
+
+    explicit DetectionPipeline(TargetDetector& detector, PipelineConfig config = {});
+    ~DetectionPipeline();
+
+    DetectionPipeline(const DetectionPipeline&) = delete;
+    DetectionPipeline& operator=(const DetectionPipeline&) = delete;
+
+    // Optional tracking stage run on the detector thread right after each
+    // scan, so results carry stable track ids. Set before start().
+    void setTracker(TargetTracker* tracker) { tracker_ = tracker; }
+
+    void start(FrameSource source, ResultSink sink);
+    // Push mode: no producer thread. The caller feeds frames with submit()
+    // from one thread, at its own pace, and ends the stream with finish().
+    void start(ResultSink sink);
+    // Fills a free frame slot and queues it for detection, blocking or
+    // recycling the oldest queued frame per frame_policy. False once
+    // stopped, or when fill returns false.
+    bool submit(const FrameSource& fill);
+    void finish() { producer_done_.store(true, std::memory_order_release); }
+    // Stops the producer and lets queued frames drain before joining.
+    void stop();
+    // Joins after the source reports end of stream, or after finish().
+    void wait();
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    PipelineStats stats() const;
+
+private:
+    struct FrameSlot {
+        std::unique_ptr<ScanArena> arena;
+        // Rebuilt on the arena for every fill; a pmr frame cannot be
+        // assigned onto a new resource.
+        std::optional<RadarFrame> frame;
+        std::uint64_t sequence{};
+        std::chrono::steady_clock::time_point ingested_at{};
+    };
+
+    struct StageCounters {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> total_ns{0};
+        std::atomic<std::uint64_t> max_ns{0};
+
+        void record(std::chrono::nanoseconds elapsed);
+        StageTiming snapshot() const;
+    };
+
+    TargetDetector& detector_;
+    TargetTracker* tracker_{nullptr};
+    PipelineConfig config_;
+
+    std::vector<FrameSlot> frames_;
+    std::vector<ScanResult> results_;
+    RingBuffer<std::uint32_t> free_frames_;
+    RingBuffer<std::uint32_t> ready_frames_;
+    RingBuffer<std::uint32_t> free_results_;
+    RingBuffer<std::uint32_t> ready_results_;
+
+    FrameSource source_;
+    ResultSink sink_;
+    std::thread producer_thread_;
+    std::thread detector_thread_;
+    std::thread output_thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_requested_{false};
+    std::atomic<bool> producer_done_{false};
+    std::atomic<bool> detector_done_{false};
+
+    StageCounters ingest_;
+    StageCounters detect_;
+    StageCounters output_;
+    StageCounters end_to_end_;
+    std::atomic<std::uint64_t> frames_dropped_{0};
+    std::atomic<std::uint64_t> results_dropped_{0};
+    std::uint64_t next_sequence_{0};
+
+    void launch(ResultSink sink);
+    void producerLoop();
+    void detectorLoop();
+    void outputLoop();
+    bool acquireSlot(RingBuffer<std::uint32_t>& free_slots, RingBuffer<std::uint32_t>& ready_slots,
+                     BackpressurePolicy policy, std::atomic<std::uint64_t>& drops,
+                     const std::atomic<bool>& abort, std::uint32_t& slot);
+    static void pinCurrentThread(int cpu);
+};
+
+#endif
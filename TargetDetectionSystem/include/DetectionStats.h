@@ -0,0 +1,55 @@
+#ifndef DETECTION_STATS_H
+#define DETECTION_STATS_H
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+// Count, mean and sum of squared deviations of a sample, mergeable in any
+// grouping (Chan et al.), so per-chunk moments fold into per-scan and
+// lifetime moments without revisiting the data.
+struct RunningMoments {
+    std::uint64_t count{};
+    double mean{};
+    double m2{};
+
+    void merge(const RunningMoments& other) noexcept {
+        if (other.count == 0) return;
+        const double total = static_cast<double>(count + other.count);
+        const double delta = other.mean - mean;
+        mean += delta * static_cast<double>(other.count) / total;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+        count += other.count;
+    }
+
+    double variance() const noexcept { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+    double stddev() const noexcept { return std::sqrt(variance()); }
+};
+
+inline constexpr std::size_t kThreatLevels = 4;
+
+// Aggregates a detector maintains as it classifies, published once per
+// scan. Threat arrays are indexed by ThreatLevel.
+struct DetectionStats {
+    std::uint64_t scans{};
+    std::uint64_t total_detections{};
+    std::array<std::uint64_t, kThreatLevels> total_threats{};
+    // Lifetime moments over every detection.
+    RunningMoments confidence{};
+    RunningMoments velocity{};
+
+    // The latest scan.
+    std::uint64_t last_returns{};
+    std::uint64_t last_targets{};
+    std::array<std::uint32_t, kThreatLevels> last_threats{};
+    RunningMoments last_confidence{};
+    RunningMoments last_velocity{};
+    std::chrono::system_clock::time_point last_scan_time{};
+
+    // Wall time of classify through ordering, and its moving average.
+    double last_cycle_ms{};
+    double cycle_ewma_ms{};
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "RadarFrame.h"
+#include "RecordingFormat.h"
+
+// Appends frames to a recording file (see RecordingFormat.h). Writes are
+// buffered by stdio; close() appends the frame index and patches the header.
+// Every call reports failure through its return value.
+class FrameRecorder {
+public:
+    FrameRecorder() = default;
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    bool open(const std::string& path);
+    bool write(const RadarFrameView& frame, std::chrono::system_clock::time_point stamp);
+    bool close();
+
+    bool isOpen() const noexcept { return file_ != nullptr; }
+    std::uint64_t frameCount() const noexcept { return offsets_.size(); }
+    std::uint64_t bytesWritten() const noexcept { return offset_; }
+
+private:
+    std::FILE* file_{nullptr};
+    std::uint64_t offset_{0};
+    std::vector<std::uint64_t> offsets_;
+    bool failed_{false};
+
+    bool put(const void* data, std::size_t bytes);
+};
+
+#endif
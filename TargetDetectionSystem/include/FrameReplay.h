@@ -0,0 +1,89 @@
+#ifndef FRAME_REPLAY_H
+#define FRAME_REPLAY_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "RadarFrame.h"
+#include "RecordingFormat.h"
+
+// How next() paces frames.
+//  RealTime         - frames are released at their recorded spacing, scaled
+//                     by the speed factor, relative to the first frame read.
+//  AsFastAsPossible - no pacing; replay runs at mapping / disk bandwidth.
+enum class ReplayMode {
+    RealTime,
+    AsFastAsPossible
+};
+
+struct ReplayFrame {
+    std::size_t index{};
+    std::chrono::system_clock::time_point stamp{};
+    // Aliases the mapping; valid while the replay stays open.
+    RadarFrameView view;
+};
+
+// Memory-maps a recording and hands out frames as zero-copy spans into the
+// mapping. Seeking is O(1) by frame and O(log n) by time through the frame
+// index, which is rebuilt by walking the file if the recorder never closed.
+class FrameReplay {
+public:
+    explicit FrameReplay(ReplayMode mode = ReplayMode::AsFastAsPossible);
+    ~FrameReplay();
+
+    FrameReplay(const FrameReplay&) = delete;
+    FrameReplay& operator=(const FrameReplay&) = delete;
+
+    // Fails on an unreadable file or a malformed header.
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const noexcept { return data_ != nullptr; }
+
+    void setMode(ReplayMode mode) noexcept { mode_ = mode; }
+    ReplayMode getMode() const noexcept { return mode_; }
+    // RealTime playback rate; 2.0 plays twice as fast as recorded.
+    void setSpeed(double speed) noexcept { speed_ = speed > 0.0 ? speed : 1.0; }
+
+    std::size_t frameCount() const noexcept { return offsets_.size(); }
+    std::size_t position() const noexcept { return cursor_; }
+
+    // Moves the cursor; both restart RealTime pacing from the new frame.
+    bool seek(std::size_t frame_index);
+    // First frame stamped at or after stamp.
+    bool seekTime(std::chrono::system_clock::time_point stamp);
+
+    // Returns the frame at the cursor and advances it, or nullopt at end.
+    std::optional<ReplayFrame> next();
+    // Random access, ignoring the cursor and pacing.
+    ReplayFrame frame(std::size_t frame_index) const;
+
+    // Pipeline adapter: copies the next frame into an owned frame.
+    bool fill(RadarFrame& frame);
+
+private:
+    ReplayMode mode_;
+    double speed_{1.0};
+    const std::byte* data_{nullptr};
+    std::size_t size_{0};
+#ifdef _WIN32
+    void* file_handle_{nullptr};
+    void* mapping_handle_{nullptr};
+#endif
+    std::vector<std::uint64_t> offsets_;
+    std::size_t cursor_{0};
+    bool pacing_started_{false};
+    std::chrono::steady_clock::time_point pace_origin_{};
+    std::int64_t pace_stamp_ns_{0};
+
+    bool map(const std::string& path);
+    void unmap();
+    bool loadIndex();
+    const FrameRecordHeader& recordAt(std::uint64_t offset) const noexcept;
+    bool validRecord(std::uint64_t offset) const noexcept;
+    void pace(std::int64_t stamp_ns);
+};
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef FUSION_ENGINE_H
+#define FUSION_ENGINE_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DescriptionTable.h"
+#include "RadarFrame.h"
+#include "TargetDetector.h"
+#include "TargetTracker.h"
+#include "ThreadPool.h"
+
+enum class SensorKind : std::uint8_t {
+    Radar,
+    ElectroOptical,
+    AdsB
+};
+
+constexpr std::string_view sensorKindName(SensorKind kind) noexcept {
+    switch (kind) {
+        case SensorKind::Radar:          return "radar";
+        case SensorKind::ElectroOptical: return "eo/ir";
+        case SensorKind::AdsB:           return "ads-b";
+    }
+    return "unknown";
+}
+
+struct SensorSpec {
+    std::string name;
+    SensorKind kind{SensorKind::Radar};
+    // Per-axis position noise in metres: the diagonal of the sensor's
+    // measurement covariance.
+    std::array<double, 3> position_sigma{10.0, 10.0, 10.0};
+    // Returns below this confidence never reach fusion. Cooperative
+    // sources such as ADS-B usually pass 0 to keep every report.
+    double confidence_threshold{0.4};
+};
+
+// One fused time window. targets are every sensor's detections in the
+// window, stamped with the window time, tagged with the sensor's name as
+// description and carrying their track id. Valid until the next fuse().
+struct FusionWindow {
+    std::chrono::system_clock::time_point start{};
+    std::chrono::system_clock::time_point end{};
+    std::size_t sensors{};
+    std::span<const Target> targets;
+};
+
+// Fuses several sensor streams into one track picture. Reports are queued
+// per sensor and cut into fixed windows on a shared time grid; fuse()
+// processes every window that ends at or before the caller's watermark.
+// Within a window the per-sensor detection stages run in parallel, then the
+// tracker predicts once and each sensor corrects it in turn with its own
+// covariance, so a sensor adds only the cost of its own returns.
+//
+// All predictions in a window use its latest report time; the window
+// length bounds the resulting misalignment.
+class FusionEngine {
+public:
+    using WindowSink = std::function<void(const FusionWindow&)>;
+
+    explicit FusionEngine(std::chrono::milliseconds window = std::chrono::milliseconds(100),
+                          TrackerConfig tracker = {});
+
+    // Parallelises the per-sensor detection stage; nullptr runs it serially.
+    void setThreadPool(ThreadPool* pool) { pool_ = pool; }
+
+    std::size_t addSensor(SensorSpec spec);
+    std::size_t sensorCount() const noexcept { return sensors_.size(); }
+    const SensorSpec& sensor(std::size_t index) const { return sensors_[index]->spec; }
+
+    // Queues one report. Reports must arrive in time order per sensor;
+    // anything older than the sensor's last report or than an already
+    // fused window is rejected and counted as late.
+    bool submit(std::size_t sensor, std::chrono::system_clock::time_point stamp, const RadarFrameView& frame);
+
+    // Fuses every complete window ending at or before until, in order, and
+    // returns how many were fused.
+    std::size_t fuse(std::chrono::system_clock::time_point until, const WindowSink& on_window = {});
+
+    const FusionWindow& lastWindow() const noexcept { return last_window_; }
+    const TargetTracker& tracker() const noexcept { return tracker_; }
+    const DescriptionTable& getDescriptions() const noexcept { return descriptions_; }
+    std::uint64_t lateReports() const noexcept { return late_reports_; }
+
+private:
+    struct Report {
+        std::chrono::system_clock::time_point stamp;
+        std::size_t end;
+    };
+
+    struct Sensor {
+        SensorSpec spec;
+        std::uint16_t description{DescriptionTable::kNone};
+        TargetDetector detector;
+        RadarFrame pending;
+        std::vector<Report> reports;
+        std::chrono::system_clock::time_point last_stamp{};
+        // Consumed prefix of pending / reports, compacted after fuse().
+        std::size_t consumed_points{0};
+        std::size_t consumed_reports{0};
+        // The slice of pending that falls in the window being fused.
+        std::size_t window_points{0};
+        std::size_t window_reports{0};
+        std::vector<Target> detections;
+
+        explicit Sensor(SensorSpec spec);
+    };
+
+    std::chrono::milliseconds window_;
+    TargetTracker tracker_;
+    ThreadPool* pool_{nullptr};
+    DescriptionTable descriptions_;
+    std::vector<std::unique_ptr<Sensor>> sensors_;
+    std::vector<Sensor*> active_;
+    std::vector<Target> picture_;
+    FusionWindow last_window_{};
+
+    bool has_epoch_{false};
+    std::chrono::system_clock::time_point epoch_{};
+    std::chrono::system_clock::time_point fused_until_{};
+    std::uint64_t late_reports_{0};
+
+    bool nextWindow(std::chrono::system_clock::time_point& start) const;
+    void fuseWindow(std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end);
+    static void compact(Sensor& sensor);
+};
+
+#endif
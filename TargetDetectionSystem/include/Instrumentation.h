@@ -0,0 +1,158 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+// Build with -DRADAR_INSTRUMENTATION=0 to compile every probe out: the
+// macros below then expand to nothing and snapshots read as empty.
+#ifndef RADAR_INSTRUMENTATION
+#define RADAR_INSTRUMENTATION 1
+#endif
+
+enum class Stage : std::uint8_t {
+    Ingest,
+    Detect,
+    Sort,
+    Track,
+    Render,
+    Count
+};
+
+enum class Counter : std::uint8_t {
+    Frames,
+    Returns,
+    Targets,
+    Prefiltered,
+    Count
+};
+
+constexpr std::string_view stageName(Stage stage) noexcept {
+    switch (stage) {
+        case Stage::Ingest: return "ingest";
+        case Stage::Detect: return "detect";
+        case Stage::Sort:   return "sort";
+        case Stage::Track:  return "track";
+        case Stage::Render: return "render";
+        case Stage::Count:  break;
+    }
+    return "unknown";
+}
+
+constexpr std::string_view counterName(Counter counter) noexcept {
+    switch (counter) {
+        case Counter::Frames:  return "frames";
+        case Counter::Returns: return "returns";
+        case Counter::Targets: return "targets";
+        case Counter::Prefiltered: return "prefiltered";
+        case Counter::Count:   break;
+    }
+    return "unknown";
+}
+
+inline constexpr std::size_t kStageCount = static_cast<std::size_t>(Stage::Count);
+inline constexpr std::size_t kCounterCount = static_cast<std::size_t>(Counter::Count);
+
+// HDR-style log-linear bucketing of nanosecond latencies: exact below 32 ns,
+// then 32 sub-buckets per power of two, so every bucket is within ~3% of
+// the values it holds. Covers up to 2^45 ns (about 9.7 hours); longer
+// samples land in the last bucket.
+struct LatencyBuckets {
+    static constexpr unsigned kSubBits = 5;
+    static constexpr std::uint64_t kSubCount = std::uint64_t{1} << kSubBits;
+    static constexpr unsigned kMaxExponent = 44;
+    static constexpr std::size_t kCount = (kMaxExponent - kSubBits + 2) * kSubCount;
+
+    static constexpr std::size_t index(std::uint64_t ns) noexcept {
+        if (ns < kSubCount) return static_cast<std::size_t>(ns);
+        const unsigned exponent = static_cast<unsigned>(std::bit_width(ns)) - 1;
+        if (exponent > kMaxExponent) return kCount - 1;
+        const std::uint64_t sub = (ns >> (exponent - kSubBits)) - kSubCount;
+        return static_cast<std::size_t>((exponent - kSubBits + 1) * kSubCount + sub);
+    }
+
+    // Largest value that maps to bucket.
+    static constexpr std::uint64_t upperBound(std::size_t bucket) noexcept {
+        if (bucket < kSubCount) return bucket;
+        const unsigned exponent = static_cast<unsigned>(bucket / kSubCount) + kSubBits - 1;
+        const std::uint64_t sub = bucket % kSubCount;
+        return ((kSubCount + sub + 1) << (exponent - kSubBits)) - 1;
+    }
+};
+
+// Merged view of one stage's histogram across all threads.
+struct HistogramSnapshot {
+    std::array<std::uint64_t, LatencyBuckets::kCount> buckets{};
+    std::uint64_t count{};
+    std::uint64_t sum_ns{};
+    std::uint64_t max_ns{};
+
+    double meanNs() const noexcept {
+        return count ? static_cast<double>(sum_ns) / static_cast<double>(count) : 0.0;
+    }
+    // Upper bound of the bucket holding quantile q in [0, 1], capped at the
+    // largest sample; 0 when empty.
+    std::uint64_t percentileNs(double q) const noexcept;
+};
+
+struct LatencySummary {
+    std::uint64_t count{};
+    double mean_us{};
+    double p50_us{};
+    double p99_us{};
+    double p999_us{};
+    double max_us{};
+};
+
+// Process-wide probe registry. Each thread records into its own shard,
+// allocated on first use, with plain relaxed loads and stores: no shared
+// cache lines and no read-modify-write on the hot path. Readers merge the
+// shards; a read racing a writer may miss that writer's latest sample.
+class Instrumentation {
+public:
+    static constexpr bool kEnabled = RADAR_INSTRUMENTATION != 0;
+
+    static void record(Stage stage, std::chrono::nanoseconds elapsed) noexcept;
+    static void count(Counter counter, std::uint64_t amount = 1) noexcept;
+
+    static HistogramSnapshot snapshot(Stage stage);
+    static LatencySummary summary(Stage stage);
+    static std::uint64_t counter(Counter counter) noexcept;
+
+    // Machine-readable dump: one JSON object with every stage summary and
+    // counter.
+    static bool writeJson(std::FILE* out);
+};
+
+// Records the lifetime of the scope into a stage histogram.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage) noexcept
+        : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { Instrumentation::record(stage_, std::chrono::steady_clock::now() - start_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Stage stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define RADAR_PROFILE_CONCAT_INNER(a, b) a##b
+#define RADAR_PROFILE_CONCAT(a, b) RADAR_PROFILE_CONCAT_INNER(a, b)
+
+#if RADAR_INSTRUMENTATION
+#define PROFILE_SCOPE(stage) const ScopedTimer RADAR_PROFILE_CONCAT(profile_scope_, __LINE__)(stage)
+#define PROFILE_COUNT(counter, amount) Instrumentation::count((counter), (amount))
+#else
+#define PROFILE_SCOPE(stage) static_cast<void>(0)
+#define PROFILE_COUNT(counter, amount) static_cast<void>(0)
+#endif
+
+#endif
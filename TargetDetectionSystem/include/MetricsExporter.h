@@ -0,0 +1,84 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "DetectionPipeline.h"
+#include "DetectionStats.h"
+#include "TripleBuffer.h"
+#include "UdpIngest.h"
+
+struct MetricsConfig {
+    std::string bind_address{"0.0.0.0"};
+    // 0 lets the kernel pick; see MetricsExporter::boundPort().
+    std::uint16_t port{9464};
+    // How often the idle server rechecks stop().
+    std::chrono::milliseconds poll_interval{100};
+};
+
+// Everything one scrape reports besides the stage histograms, which are
+// read straight from Instrumentation.
+struct MetricsSnapshot {
+    DetectionStats detection{};
+    // Over the last rate window of roughly one second.
+    double targets_per_second{};
+    PipelineStats pipeline{};
+    bool has_ingest{false};
+    UdpIngestStats ingest{};
+};
+
+// Prometheus text-format endpoint on GET /metrics. The detection side
+// publishes MetricsSnapshots through a triple buffer and never blocks; a
+// dedicated server thread picks up the newest one per scrape, so a slow or
+// stuck scraper cannot stall a scan. Linux only; start() fails elsewhere.
+class MetricsExporter {
+public:
+    explicit MetricsExporter(MetricsConfig config = {});
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Binds the listening socket and starts the server thread.
+    bool start();
+    void stop();
+    bool isRunning() const noexcept { return running_.load(std::memory_order_acquire); }
+    std::uint16_t boundPort() const noexcept { return bound_port_; }
+
+    // Publishes the detector's aggregates for one scan with the pipeline
+    // and optional ingest counters at that moment. O(1) in the scan size;
+    // safe to call from exactly one thread.
+    void update(const DetectionStats& detection, const PipelineStats& pipeline,
+                const UdpIngestStats* ingest = nullptr);
+
+    // Appends the exposition for snapshot plus the current stage
+    // histograms to out.
+    static void writeExposition(const MetricsSnapshot& snapshot, std::string& out);
+
+private:
+    MetricsConfig config_;
+    int fd_{-1};
+    std::uint16_t bound_port_{0};
+    std::atomic<bool> running_{false};
+    std::thread server_thread_;
+    TripleBuffer<MetricsSnapshot> snapshots_;
+
+    // Publisher-side rate window.
+    bool rate_started_{false};
+    std::chrono::steady_clock::time_point rate_since_{};
+    std::uint64_t rate_base_{0};
+    double targets_per_second_{0.0};
+
+    // Server-thread state.
+    std::string request_;
+    std::string response_;
+    std::string body_;
+
+    void serveLoop();
+    void serveClient(int client);
+};
+
+#endif
@@ -4,47 +4,64 @@
 #include <chrono>
 #include <string>
 #include <vector>
+#include <span>
 #include <thread>
 #include <atomic>
-#include <iomanip>
 #include "TargetDetector.h"
+#include "TripleBuffer.h"
 
+// Background console renderer. The detection side hands over snapshots
+// through a triple buffer and never blocks; a dedicated thread redraws at
+// most refresh_hz times per second using ANSI cursor control.
 class MonitorInterface {
 public:
-    MonitorInterface();
+    explicit MonitorInterface(double refresh_hz = 10.0, std::size_t max_rows = 20);
     ~MonitorInterface();
 
-    void startMonitoring(TargetDetector& detector);
+    void startMonitoring();
     void stopMonitoring();
-    void updateDisplay(const std::vector<Target>& targets, double detection_time_ms);
+
+    // Publishes one scan with the detector's aggregates for it. Copies at
+    // most max_rows targets into the preallocated back buffer; every
+    // statistic comes from stats, so the cost does not grow with the scan.
+    // Safe to call from exactly one thread.
+    void updateDisplay(std::span<const Target> targets, const DetectionStats& stats);
+
+    void setRefreshRate(double refresh_hz);
     bool isRunning() const { return running_; }
 
 private:
+    struct Snapshot {
+        DetectionStats stats{};
+        std::vector<Target> targets;
+    };
+
     std::atomic<bool> running_;
     std::thread monitor_thread_;
-    TargetDetector* detector_ptr_;
     std::chrono::system_clock::time_point start_time_;
-    int total_detections_{0};
-    double avg_detection_time_{0.0};
-
-    void displayHeader() const;
-    void displayStats(const std::vector<Target>& targets, double detection_time_ms);
-    void displayTargets(const std::vector<Target>& targets);
-    void displayProgressBar(double percentage) const;
-    std::string getColorCode(ThreatLevel level) const;
-    std::string resetColor() const;
+    std::atomic<std::int64_t> refresh_period_ns_;
+    std::size_t max_rows_;
+    TripleBuffer<Snapshot> snapshots_;
+
+    // Render-thread state.
+    std::string frame_;
+
+    void renderLoop();
+    void render(const Snapshot& snapshot);
+    void displayHeader();
+    void displayStats(const Snapshot& snapshot);
+    void displayTargets(const Snapshot& snapshot);
+    // Per-stage p50/p99/p999 from Instrumentation, skipping idle stages.
+    void displayLatencies();
+    void displayProgressBar(double percentage);
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    void appendLine(const char* format, ...);
+    std::string_view getColorCode(ThreatLevel level) const;
+    std::string_view resetColor() const;
     void clearScreen() const;
     std::string formatTime(std::chrono::system_clock::time_point time) const;
-    
-    #ifndef _WIN32
-    int getch();
-    #endif
-
-    struct ThreatStats {
-        int critical{0}, high{0}, medium{0}, low{0};
-    };
-    
-    ThreatStats calculateThreatStats(const std::vector<Target>& targets) const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,67 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3"). Output is a pure function of (key,
+// counter), so any thread can draw the numbers for any element directly,
+// in any order, and get the same stream as a serial run.
+class Philox4x32 {
+public:
+    using Block = std::array<std::uint32_t, 4>;
+
+    explicit constexpr Philox4x32(std::uint64_t seed) noexcept
+        : key0_(static_cast<std::uint32_t>(seed)), key1_(static_cast<std::uint32_t>(seed >> 32)) {}
+
+    constexpr Block operator()(Block counter) const noexcept {
+        std::uint32_t k0 = key0_;
+        std::uint32_t k1 = key1_;
+        for (int round = 0; round < 10; ++round) {
+            const std::uint64_t p0 = std::uint64_t{kMul0} * counter[0];
+            const std::uint64_t p1 = std::uint64_t{kMul1} * counter[2];
+            counter = {static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ k0, static_cast<std::uint32_t>(p1),
+                       static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ k1, static_cast<std::uint32_t>(p0)};
+            k0 += kWeyl0;
+            k1 += kWeyl1;
+        }
+        return counter;
+    }
+
+    // Counter for element `index` of `stream` in a given frame.
+    static constexpr Block counter(std::uint64_t index, std::uint64_t frame, std::uint32_t stream) noexcept {
+        return {static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+                static_cast<std::uint32_t>(frame), static_cast<std::uint32_t>(frame >> 32) ^ (stream << 24)};
+    }
+
+    // Uniform in [0, 1) at 32-bit resolution.
+    static constexpr double unit(std::uint32_t bits) noexcept {
+        return bits * 0x1p-32;
+    }
+
+    // Uniform in (-1, 1).
+    static constexpr double signedUnit(std::uint32_t bits) noexcept {
+        return (bits + 0.5) * 0x1p-31 - 1.0;
+    }
+
+    // Two independent standard normals from two words (Box-Muller).
+    static std::array<double, 2> normals(std::uint32_t a, std::uint32_t b) noexcept {
+        const double radius = std::sqrt(-2.0 * std::log((a + 0.5) * 0x1p-32));
+        const double angle = 2.0 * std::numbers::pi * unit(b);
+        return {radius * std::cos(angle), radius * std::sin(angle)};
+    }
+
+private:
+    static constexpr std::uint32_t kMul0 = 0xD2511F53;
+    static constexpr std::uint32_t kMul1 = 0xCD9E8D57;
+    static constexpr std::uint32_t kWeyl0 = 0x9E3779B9;
+    static constexpr std::uint32_t kWeyl1 = 0xBB67AE85;
+
+    std::uint32_t key0_;
+    std::uint32_t key1_;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef RADAR_FRAME_H
+#define RADAR_FRAME_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Non-owning view over one scan worth of radar returns, stored as parallel
+// x/y/z/velocity columns. All four spans have the same length.
+struct RadarFrameView {
+    std::span<const double> x{};
+    std::span<const double> y{};
+    std::span<const double> z{};
+    std::span<const double> velocity{};
+
+    [[nodiscard]] std::size_t size() const noexcept { return x.size(); }
+    [[nodiscard]] bool empty() const noexcept { return x.empty(); }
+
+    [[nodiscard]] RadarFrameView subview(std::size_t offset, std::size_t count) const noexcept {
+        return {x.subspan(offset, count), y.subspan(offset, count),
+                z.subspan(offset, count), velocity.subspan(offset, count)};
+    }
+};
+
+// Owning structure-of-arrays frame. Columns keep their capacity across
+// clear() so a frame reused every scan stops allocating once warmed up.
+// Allocator-aware: a frame built on a ScanArena draws its columns from it.
+struct RadarFrame {
+    static constexpr std::size_t kStride = 4;
+
+    using allocator_type = std::pmr::polymorphic_allocator<double>;
+    using Column = std::pmr::vector<double>;
+
+    Column x{};
+    Column y{};
+    Column z{};
+    Column velocity{};
+
+    RadarFrame() = default;
+
+    explicit RadarFrame(const allocator_type& alloc)
+        : x(alloc), y(alloc), z(alloc), velocity(alloc) {}
+
+    explicit RadarFrame(std::size_t capacity, const allocator_type& alloc = {})
+        : RadarFrame(alloc) { reserve(capacity); }
+
+    // Builds a frame from interleaved x,y,z,velocity quadruples; a trailing
+    // partial quadruple is ignored.
+    explicit RadarFrame(std::span<const double> interleaved, const allocator_type& alloc = {})
+        : RadarFrame(alloc) { assign(interleaved); }
+
+    RadarFrame(const RadarFrame& other, const allocator_type& alloc)
+        : x(other.x, alloc), y(other.y, alloc), z(other.z, alloc), velocity(other.velocity, alloc) {}
+
+    RadarFrame(RadarFrame&& other, const allocator_type& alloc)
+        : x(std::move(other.x), alloc), y(std::move(other.y), alloc),
+          z(std::move(other.z), alloc), velocity(std::move(other.velocity), alloc) {}
+
+    RadarFrame(const RadarFrame&) = default;
+    RadarFrame(RadarFrame&&) noexcept = default;
+    RadarFrame& operator=(const RadarFrame&) = default;
+    RadarFrame& operator=(RadarFrame&&) = default;
+
+    allocator_type get_allocator() const noexcept { return x.get_allocator(); }
+
+    void reserve(std::size_t capacity) {
+        x.reserve(capacity);
+        y.reserve(capacity);
+        z.reserve(capacity);
+        velocity.reserve(capacity);
+    }
+
+    void clear() noexcept {
+        x.clear();
+        y.clear();
+        z.clear();
+        velocity.clear();
+    }
+
+    void push(double px, double py, double pz, double v) {
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        velocity.push_back(v);
+    }
+
+    void assign(std::span<const double> interleaved) {
+        clear();
+        const std::size_t count = interleaved.size() / kStride;
+        reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const double* p = interleaved.data() + i * kStride;
+            push(p[0], p[1], p[2], p[3]);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return x.size(); }
+    [[nodiscard]] bool empty() const noexcept { return x.empty(); }
+
+    [[nodiscard]] RadarFrameView view() const noexcept {
+        return {x, y, z, velocity};
+    }
+
+    operator RadarFrameView() const noexcept { return view(); }
+};
+
+#endif
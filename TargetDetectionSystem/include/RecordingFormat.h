@@ -0,0 +1,54 @@
+#ifndef RECORDING_FORMAT_H
+#define RECORDING_FORMAT_H
+
+#include <chrono>
+#include <cstdint>
+
+// On-disk layout of a radar recording, in host byte order:
+//
+//     RecordingHeader
+//     frame 0: FrameRecordHeader, then x[count], y[count], z[count], velocity[count]
+//     frame 1: ...
+//     frame index: std::uint64_t offset per frame
+//
+// Every block is a multiple of 8 bytes, so with a page-aligned mapping the
+// columns are naturally aligned doubles and can be viewed in place. The
+// index and the header's frame_count / index_offset are written when the
+// recorder closes; an unfinished file is still readable by walking frames.
+struct RecordingHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_bytes;
+    std::uint64_t frame_count;
+    std::uint64_t index_offset;
+    std::uint64_t reserved[4];
+};
+
+struct FrameRecordHeader {
+    std::uint32_t magic;
+    std::uint32_t count;
+    // system_clock time since epoch, in nanoseconds.
+    std::int64_t stamp_ns;
+};
+
+static_assert(sizeof(RecordingHeader) == 64);
+static_assert(sizeof(FrameRecordHeader) == 16);
+
+inline constexpr char kRecordingMagic[8] = {'S', 'F', 'S', 'R', 'E', 'C', '0', '1'};
+inline constexpr std::uint32_t kRecordingVersion = 1;
+inline constexpr std::uint32_t kFrameMagic = 0x304d5246; // "FRM0"
+
+constexpr std::uint64_t frameRecordBytes(std::uint64_t count) noexcept {
+    return sizeof(FrameRecordHeader) + 4 * count * sizeof(double);
+}
+
+inline std::int64_t toStampNs(std::chrono::system_clock::time_point stamp) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(stamp.time_since_epoch()).count();
+}
+
+inline std::chrono::system_clock::time_point fromStampNs(std::int64_t ns) noexcept {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef RETURN_CLUSTERER_H
+#define RETURN_CLUSTERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "SpatialGrid.h"
+#include "ThreadPool.h"
+#include "ThreatLevel.h"
+
+struct ClusterConfig {
+    // Returns closer than this, in metres, are taken to be one object.
+    double epsilon{25.0};
+    // DBSCAN density threshold, counting the return itself. 1 merges every
+    // epsilon-connected group and drops nothing; higher values also discard
+    // returns with too few neighbours as noise.
+    std::size_t min_points{1};
+    // Returns per parallel task.
+    std::size_t chunk_size{4096};
+};
+
+// Per-return columns to be clustered; every span has the same length.
+struct ClusterInput {
+    std::span<const double> x;
+    std::span<const double> y;
+    std::span<const double> z;
+    std::span<const double> velocity;
+    std::span<const double> confidence;
+    std::span<const std::uint8_t> threat;
+
+    std::size_t size() const noexcept { return x.size(); }
+};
+
+// One fused detection. Position and velocity are confidence-weighted means
+// of the members; confidence is 1 - prod(1 - c), the chance that at least
+// one member is real; the threat level is the most severe member's.
+struct ReturnCluster {
+    double x{}, y{}, z{};
+    double velocity{};
+    double confidence{};
+    ThreatLevel threat_level{ThreatLevel::LOW};
+    std::uint32_t size{};
+};
+
+// DBSCAN over one frame's returns, backed by a SpatialGrid with epsilon
+// sized cells so each neighbourhood query touches a 3x3x3 block: O(n)
+// expected time for bounded return density. The density and merge passes
+// run in parallel chunks on an optional pool, merging clusters through a
+// lock-free union-find; border returns join their nearest core return.
+// Clusters are numbered by their lowest-index member, so the result is the
+// same with or without a pool.
+class ReturnClusterer {
+public:
+    static constexpr std::uint32_t kNoise = ~std::uint32_t{0};
+
+    explicit ReturnClusterer(ClusterConfig config = {});
+
+    void setConfig(const ClusterConfig& config) noexcept { config_ = config; }
+    const ClusterConfig& config() const noexcept { return config_; }
+
+    // Valid until the next call.
+    std::span<const ReturnCluster> cluster(const ClusterInput& input, ThreadPool* pool = nullptr);
+    // Cluster index of every input return in the last call, or kNoise.
+    std::span<const std::uint32_t> labels() const noexcept { return labels_; }
+
+private:
+    ClusterConfig config_;
+    SpatialGrid grid_;
+    std::vector<std::uint8_t> core_;
+    std::vector<std::uint32_t> parent_;
+    std::vector<std::uint32_t> labels_;
+    std::vector<ReturnCluster> clusters_;
+    // Running sums, one per cluster, folded into clusters_ at the end.
+    std::vector<double> weight_;
+    std::vector<double> miss_;
+
+    std::uint32_t find(std::uint32_t node) noexcept;
+    void unite(std::uint32_t a, std::uint32_t b) noexcept;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef RETURN_PREFILTER_H
+#define RETURN_PREFILTER_H
+
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+#include "DetectionKernel.h"
+#include "RadarFrame.h"
+
+// Axis-aligned region whose returns are dropped, e.g. a known clutter
+// source. Bounds are inclusive, in metres.
+struct ExclusionBox {
+    double min_x{}, min_y{}, min_z{};
+    double max_x{}, max_y{}, max_z{};
+};
+
+struct PrefilterConfig {
+    // Slant-range gate in metres.
+    double min_range{0.0};
+    double max_range{std::numeric_limits<double>::infinity()};
+    // Also cap max_range at the range beyond which the detector's confidence
+    // model cannot reach its threshold. That gate is conservative: it never
+    // drops a return the threshold would have kept.
+    bool gate_on_threshold{true};
+    // Azimuth sector, degrees counter-clockwise from +x, swept from
+    // azimuth_min to azimuth_max. A sweep of 360 or more disables it.
+    double azimuth_min{-180.0};
+    double azimuth_max{180.0};
+    // Elevation above the x/y plane, degrees.
+    double elevation_min{-90.0};
+    double elevation_max{90.0};
+    std::vector<ExclusionBox> exclusions;
+};
+
+// Writable columns receiving the returns that pass, each at least as long
+// as the input view.
+struct PrefilterColumns {
+    std::span<double> x{};
+    std::span<double> y{};
+    std::span<double> z{};
+    std::span<double> velocity{};
+
+    [[nodiscard]] PrefilterColumns subspan(std::size_t offset, std::size_t count) const noexcept {
+        return {x.subspan(offset, count), y.subspan(offset, count),
+                z.subspan(offset, count), velocity.subspan(offset, count)};
+    }
+
+    [[nodiscard]] RadarFrameView view(std::size_t count) const noexcept {
+        return {x.first(count), y.first(count), z.first(count), velocity.first(count)};
+    }
+};
+
+// Grow-only storage for PrefilterColumns, like KernelScratch.
+struct PrefilterScratch {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<double> velocity;
+
+    PrefilterColumns prepare(std::size_t count) {
+        if (x.size() < count) {
+            x.resize(count);
+            y.resize(count);
+            z.resize(count);
+            velocity.resize(count);
+        }
+        return {std::span(x).first(count), std::span(y).first(count),
+                std::span(z).first(count), std::span(velocity).first(count)};
+    }
+};
+
+// Early rejection ahead of the detection kernel. Range, sector and
+// exclusion tests are reduced at configuration time to squared distances
+// and direction cross products, so a return is judged with multiplies and
+// compares only: no sqrt, divide or trigonometry per return. Survivors are
+// compacted in input order, which keeps target ids the same as an
+// unfiltered scan of the surviving returns. A return with a NaN coordinate
+// is never rejected here; the kernel decides what to do with it.
+class ReturnPrefilter {
+public:
+    explicit ReturnPrefilter(PrefilterConfig config = {});
+
+    const PrefilterConfig& config() const noexcept { return config_; }
+
+    // Caps the range gate below config().max_range; infinity lifts the
+    // cap, a negative limit rejects every return.
+    void setRangeLimit(double max_range) noexcept;
+
+    // Copies the returns of frame that pass every gate to the front of
+    // out and returns how many did.
+    std::size_t apply(const RadarFrameView& frame, const PrefilterColumns& out) const noexcept {
+        return apply(KernelDispatch::activeBackend(), frame, out);
+    }
+    std::size_t apply(KernelBackend backend, const RadarFrameView& frame,
+                      const PrefilterColumns& out) const noexcept;
+
+    // Accepts z * z_scale >= rho * sin, with rho the planar range, by
+    // comparing squares; z_scale is cos for a lower bound and -cos for an
+    // upper bound, which is a lower bound on -z.
+    struct ElevationBound {
+        bool enabled{false};
+        double z_scale{1.0};
+        double sin_sq{0.0};
+        bool positive_sin{false};
+    };
+
+    // Loop invariants of the gates, as consumed by the backends.
+    struct Gates {
+        double min_range_sq{0.0};
+        double max_range_sq{std::numeric_limits<double>::infinity()};
+        bool sector{false};
+        // Sweeps wider than 180 degrees accept either half plane.
+        bool wide_sector{false};
+        double from_x{1.0}, from_y{0.0};
+        double to_x{1.0}, to_y{0.0};
+        ElevationBound lower{};
+        ElevationBound upper{};
+    };
+
+private:
+    PrefilterConfig config_;
+    double range_limit_{std::numeric_limits<double>::infinity()};
+    Gates gates_{};
+
+    void updateRangeGate() noexcept;
+};
+
+#endif
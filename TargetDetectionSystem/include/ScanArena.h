@@ -0,0 +1,54 @@
+#ifndef SCAN_ARENA_H
+#define SCAN_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// Per-scan monotonic arena. Everything allocated from it during a cycle is
+// released together by reset(). The arena keeps one contiguous block; if a
+// cycle spills past it, the next reset() regrows the block to the observed
+// high-water mark, so steady-state cycles never touch the upstream resource
+// and reset() is O(1).
+class ScanArena : public std::pmr::memory_resource {
+public:
+    explicit ScanArena(std::size_t initial_bytes = kDefaultBytes,
+                       std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~ScanArena() override;
+
+    ScanArena(const ScanArena&) = delete;
+    ScanArena& operator=(const ScanArena&) = delete;
+
+    // Uninitialised storage for count objects of T, valid until reset().
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void reset();
+
+    std::size_t bytesUsed() const noexcept { return bytes_used_; }
+    std::size_t capacity() const noexcept { return block_size_; }
+    std::size_t highWaterMark() const noexcept { return high_water_; }
+    std::size_t overflowCount() const noexcept { return overflows_; }
+
+    static constexpr std::size_t kDefaultBytes = std::size_t{1} << 20;
+
+private:
+    std::pmr::memory_resource* upstream_;
+    std::size_t block_size_;
+    std::unique_ptr<std::byte[]> block_;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic_;
+    std::size_t bytes_used_{0};
+    std::size_t high_water_{0};
+    std::size_t overflows_{0};
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef SCAN_SCHEDULER_H
+#define SCAN_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+struct SchedulerConfig {
+    // Timer slack requested for the thread that calls run(), in
+    // nanoseconds; Linux rounds timer expiries up by this much. 0 keeps
+    // the thread's current slack.
+    std::uint64_t timer_slack_ns{1000};
+};
+
+struct CadenceStats {
+    std::uint64_t ticks{};
+    // Cycles that ran past their next deadline, and the deadlines skipped
+    // as a result.
+    std::uint64_t overruns{};
+    std::uint64_t skipped{};
+    // Resume time past each deadline.
+    double mean_lateness_us{};
+    double max_lateness_us{};
+};
+
+// Single-threaded timer loop driving scan cycles written as coroutines:
+//
+//     ScanScheduler::Task sensor(ScanScheduler& s, std::size_t cadence) {
+//         for (;;) {
+//             const bool running = co_await s.tick(cadence);
+//             if (!running) break;
+//             ...one scan...
+//         }
+//     }
+//     scheduler.spawn(sensor(scheduler, scheduler.addCadence(10ms)));
+//     scheduler.run();
+//
+// A cadence is a fixed-rate timeline: deadline k is first + k * period,
+// so cycle time never accumulates into drift. A cycle that runs past its
+// next deadline is an overrun; the deadlines it missed are skipped rather
+// than run back to back, keeping the phase. Each coroutine can follow its
+// own cadence, one per sensor.
+//
+// Cancellation is cooperative: after requestStop(), every pending and
+// future tick() resumes at once with false and the coroutine returns in
+// its own time. run() returns when every spawned coroutine has.
+//
+// Await tick() into a local as above: GCC 12.2 miscompiles a co_await
+// used directly in an if or while condition, and the loop body never
+// runs. test/scan_scheduler.cpp reproduces it and skips where it applies.
+class ScanScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Coroutine return type. Starts suspended; spawn() hands it over and
+    // the scheduler destroys the frame once the coroutine returns.
+    class Task {
+    public:
+        struct promise_type {
+            Task get_return_object() noexcept {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+
+        Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (handle_) handle_.destroy();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+        ~Task() {
+            if (handle_) handle_.destroy();
+        }
+
+    private:
+        friend class ScanScheduler;
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    // co_await result: true at the deadline, false once stop is requested.
+    class TickAwaiter {
+    public:
+        bool await_ready() const noexcept { return scheduler_.stopRequested(); }
+        void await_suspend(std::coroutine_handle<> handle) { scheduler_.arm(cadence_, handle); }
+        bool await_resume() const noexcept { return !scheduler_.stopRequested(); }
+
+    private:
+        friend class ScanScheduler;
+        TickAwaiter(ScanScheduler& scheduler, std::size_t cadence) noexcept
+            : scheduler_(scheduler), cadence_(cadence) {}
+
+        ScanScheduler& scheduler_;
+        std::size_t cadence_;
+    };
+
+    explicit ScanScheduler(SchedulerConfig config = {});
+    ~ScanScheduler();
+
+    ScanScheduler(const ScanScheduler&) = delete;
+    ScanScheduler& operator=(const ScanScheduler&) = delete;
+
+    // Adds a timeline ticking every period; its first tick() resumes at
+    // once and fixes the phase. Returns the id to pass to tick().
+    std::size_t addCadence(Clock::duration period);
+    TickAwaiter tick(std::size_t cadence) noexcept { return {*this, cadence}; }
+
+    void spawn(Task task);
+    // Runs the loop on the calling thread until every coroutine returned.
+    void run();
+
+    // Safe from any thread, and from a signal handler on Linux.
+    void requestStop() noexcept;
+    bool stopRequested() const noexcept { return stop_requested_.load(std::memory_order_acquire); }
+
+    // Read from a coroutine or after run() returns.
+    CadenceStats stats(std::size_t cadence) const noexcept;
+
+private:
+    struct Cadence {
+        Clock::duration period{};
+        Clock::time_point next{};
+        bool started{false};
+        CadenceStats stats{};
+        double lateness_total_us{0.0};
+    };
+
+    struct Timer {
+        Clock::time_point deadline;
+        std::uint64_t order;
+        std::size_t cadence;
+        std::coroutine_handle<> handle;
+    };
+
+    SchedulerConfig config_;
+    std::vector<Cadence> cadences_;
+    // Min-heap on (deadline, order): equal deadlines resume in arming order.
+    std::vector<Timer> timers_;
+    std::vector<std::coroutine_handle<Task::promise_type>> tasks_;
+    std::uint64_t armed_{0};
+    std::atomic<bool> stop_requested_{false};
+    // timerfd and eventfd on Linux; unused elsewhere.
+    int timer_fd_{-1};
+    int wake_fd_{-1};
+
+    void arm(std::size_t cadence, std::coroutine_handle<> handle);
+    void resume(const Timer& timer);
+    // Waits until deadline or a stop request; false if woken early.
+    bool waitUntil(Clock::time_point deadline);
+    void reap();
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SCENARIO_GENERATOR_H
+#define SCENARIO_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Philox.h"
+#include "RadarFrame.h"
+#include "ThreadPool.h"
+
+enum class TrajectoryKind : std::uint8_t {
+    Straight,
+    Turning,
+    Diving
+};
+
+struct ScenarioConfig {
+    std::uint64_t seed{1};
+    std::size_t objects{1000};
+    std::size_t clutter_per_frame{4000};
+    // Half-width of the scene cube in metres; objects wrap at its faces.
+    double extent{2500.0};
+    double min_speed{50.0};
+    double max_speed{400.0};
+    // Trajectory mix; whatever remains after these two is diving.
+    double straight_fraction{0.6};
+    double turning_fraction{0.25};
+    // Upper bounds, drawn per object: turn rate in rad/s, dive acceleration
+    // in m/s^2.
+    double max_turn_rate{0.3};
+    double max_dive_acceleration{30.0};
+    // Per-axis measurement noise on object returns, in metres.
+    double position_noise{5.0};
+    // Clutter radial velocities are uniform in +/- this, in m/s.
+    double clutter_speed{20.0};
+};
+
+// Deterministic synthetic radar scenes. Object motion is closed form in
+// time, so any frame can be generated directly without stepping through
+// the ones before it, and all randomness comes from a Philox stream keyed
+// by the seed and counted by (frame, return). A frame is therefore
+// identical whether it is filled serially or in parallel chunks, on any
+// number of threads.
+//
+// Frames hold every object return, then the clutter returns. The velocity
+// column is radial velocity, negative when closing.
+class ScenarioGenerator {
+public:
+    explicit ScenarioGenerator(ScenarioConfig config = {}, ThreadPool* pool = nullptr);
+
+    void setThreadPool(ThreadPool* pool) noexcept { pool_ = pool; }
+
+    // Fills frame with scene frame_index as seen at time_s seconds.
+    void generate(std::uint64_t frame_index, double time_s, RadarFrame& frame) const;
+
+    std::size_t returnsPerFrame() const noexcept { return config_.objects + config_.clutter_per_frame; }
+    TrajectoryKind trajectory(std::size_t object) const noexcept { return kind_[object]; }
+    const ScenarioConfig& config() const noexcept { return config_; }
+
+    static constexpr std::size_t kChunkSize = 16384;
+
+private:
+    ScenarioConfig config_;
+    Philox4x32 rng_;
+    ThreadPool* pool_;
+
+    // Per-object trajectory parameters, column-wise.
+    std::vector<double> x0_, y0_, z0_;
+    std::vector<double> vx_, vy_, vz_;
+    std::vector<double> turn_rate_;
+    std::vector<double> dive_acceleration_;
+    std::vector<TrajectoryKind> kind_;
+
+    void fillObjects(std::uint64_t frame_index, double time_s, std::size_t begin, std::size_t end,
+                     RadarFrame& frame) const;
+    void fillClutter(std::uint64_t frame_index, std::size_t begin, std::size_t end, RadarFrame& frame) const;
+    double wrap(double v) const noexcept;
+};
+
+#endif
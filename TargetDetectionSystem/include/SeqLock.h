@@ -0,0 +1,62 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// Single-writer / many-reader snapshot of a small trivially copyable value.
+// store() never waits; load() retries only while a store is in flight, so
+// any number of readers can poll without ever delaying the writer. The
+// value is kept in relaxed atomic words, which makes torn reads detectable
+// rather than undefined.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    SeqLock() noexcept { store(T{}); }
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Writer side; exactly one thread.
+    void store(const T& value) noexcept {
+        std::uint64_t words[kWords]{};
+        std::memcpy(words, &value, sizeof(T));
+        const std::uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < kWords; ++i) words_[i].store(words[i], std::memory_order_relaxed);
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const noexcept {
+        std::uint64_t words[kWords];
+        for (;;) {
+            const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < kWords; ++i) words[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) break;
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    // Number of completed stores; 1 after construction.
+    std::uint64_t version() const noexcept { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> sequence_{0};
+    std::atomic<std::uint64_t> words_[kWords];
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef SHARD_PROTOCOL_H
+#define SHARD_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "RecordingFormat.h"
+#include "TargetRecordFormat.h"
+
+// Datagrams between shard workers and the coordinator, in host byte order.
+// Each is laid out like a recording frame (RecordingFormat.h): a
+// FrameRecordHeader whose magic names the message, carrying the record
+// count and the scan stamp, then a ShardMessageHeader, then the records.
+//
+//     Track handoff (kHandoffMagic), worker to neighbouring worker:
+//         x, y, z, vx, vy, vz, position_variance, velocity_variance as
+//         double[count] column blocks, then std::uint64_t[count] packing
+//         track id | hits << 32.
+//     Threat report (kThreatReportMagic), worker to coordinator:
+//         TargetRecord[count] (TargetRecordFormat.h), the shard's most
+//         severe targets of one scan, most severe first.
+//
+// Every block is a multiple of 8 bytes, so a receive buffer aligned to 8
+// can be read in place. sequence is the sender's own scan count, which
+// restarts with the sender; receivers order messages by stamp.
+struct ShardMessageHeader {
+    std::uint32_t source_shard;
+    std::uint32_t reserved;
+    std::uint64_t sequence;
+};
+
+static_assert(sizeof(ShardMessageHeader) == 16);
+
+inline constexpr std::uint32_t kHandoffMagic = 0x30444e48;      // "HND0"
+inline constexpr std::uint32_t kThreatReportMagic = 0x30524854; // "THR0"
+inline constexpr std::size_t kHandoffColumns = 8;
+inline constexpr std::size_t kShardHeaderBytes = sizeof(FrameRecordHeader) + sizeof(ShardMessageHeader);
+inline constexpr std::size_t kHandoffTrackBytes = kHandoffColumns * sizeof(double) + sizeof(std::uint64_t);
+
+constexpr std::uint64_t handoffRecordBytes(std::uint64_t count) noexcept {
+    return kShardHeaderBytes + count * kHandoffTrackBytes;
+}
+
+constexpr std::uint64_t threatReportBytes(std::uint64_t count) noexcept {
+    return kShardHeaderBytes + count * sizeof(TargetRecord);
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef SHARD_TRANSPORT_H
+#define SHARD_TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+// Datagram delivery between shard workers and the coordinator (see
+// ShardProtocol.h). Peers are addressed by shard index, or kCoordinator.
+class ShardTransport {
+public:
+    static constexpr std::uint32_t kCoordinator = 0xffffffffu;
+
+    virtual ~ShardTransport() = default;
+
+    // Best effort, like UDP: a false return or a silently lost datagram
+    // only costs the receiver one scan's handoffs or report.
+    virtual bool send(std::uint32_t peer, std::span<const std::byte> datagram) = 0;
+    // Next datagram addressed to this endpoint, or an empty span if none is
+    // waiting. Never blocks; the span stays valid until the next receive().
+    virtual std::span<const std::byte> receive() = 0;
+};
+
+// In-process network of one mailbox per shard plus the coordinator's, for
+// simulations and benchmarks. Endpoints may be used from different threads.
+class LoopbackShardNetwork {
+public:
+    explicit LoopbackShardNetwork(std::uint32_t shard_count);
+    ~LoopbackShardNetwork();
+
+    LoopbackShardNetwork(const LoopbackShardNetwork&) = delete;
+    LoopbackShardNetwork& operator=(const LoopbackShardNetwork&) = delete;
+
+    // peer is a shard index or ShardTransport::kCoordinator.
+    ShardTransport& endpoint(std::uint32_t peer);
+
+private:
+    class Endpoint;
+
+    std::vector<std::unique_ptr<Endpoint>> endpoints_;
+
+    Endpoint* find(std::uint32_t peer) noexcept;
+};
+
+struct UdpShardConfig {
+    std::string bind_address{"0.0.0.0"};
+    // 0 lets the kernel pick; see UdpShardTransport::boundPort().
+    std::uint16_t port{47900};
+    // "a.b.c.d:port" of shard i at index i, and of the coordinator.
+    std::vector<std::string> shards;
+    std::string coordinator;
+    std::size_t max_datagram_bytes{65507};
+    int socket_buffer_bytes{4 << 20};
+};
+
+// One node's endpoint on a UDP shard network. Linux only; open() fails
+// elsewhere, and also when an address does not parse.
+class UdpShardTransport final : public ShardTransport {
+public:
+    explicit UdpShardTransport(UdpShardConfig config = {});
+    ~UdpShardTransport() override;
+
+    UdpShardTransport(const UdpShardTransport&) = delete;
+    UdpShardTransport& operator=(const UdpShardTransport&) = delete;
+
+    bool open();
+    void close();
+    bool isOpen() const noexcept { return fd_ >= 0; }
+    std::uint16_t boundPort() const noexcept { return bound_port_; }
+
+    bool send(std::uint32_t peer, std::span<const std::byte> datagram) override;
+    std::span<const std::byte> receive() override;
+
+private:
+    // Socket addresses, kept out of this header.
+    struct Peers;
+
+    UdpShardConfig config_;
+    int fd_{-1};
+    std::uint16_t bound_port_{0};
+    std::unique_ptr<Peers> peers_;
+    // Doubles, so a received datagram's columns are aligned in place.
+    std::vector<double> buffer_;
+};
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef SHARDED_DETECTION_H
+#define SHARDED_DETECTION_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "RadarFrame.h"
+#include "ShardProtocol.h"
+#include "ShardTransport.h"
+#include "TargetDetector.h"
+#include "TargetTracker.h"
+
+// Spatial partition of the surveillance area into columns x rows equal
+// cells over [min_x, max_x) x [min_y, max_y), one per shard, numbered
+// row-major. Edge cells extend to infinity, so every return has exactly
+// one owning shard.
+struct ShardLayout {
+    double min_x{-2500.0}, max_x{2500.0};
+    double min_y{-2500.0}, max_y{2500.0};
+    std::uint32_t columns{2};
+    std::uint32_t rows{1};
+    // Tracks within this distance of a neighbouring cell are handed to it.
+    // Only adjacent cells are considered, so keep it below the cell size.
+    double handoff_margin{300.0};
+
+    std::uint32_t shardCount() const noexcept { return columns * rows; }
+    std::uint32_t shardOf(double x, double y) const noexcept;
+    // Appends the cells adjacent to shard's that lie within handoff_margin
+    // of (x, y), including one (x, y) has already moved into.
+    void neighboursNear(std::uint32_t shard, double x, double y, std::vector<std::uint32_t>& out) const;
+    // Feed-side split: appends each return of frame to the frame of its
+    // owning shard. shards must hold shardCount() frames.
+    void route(const RadarFrameView& frame, std::span<RadarFrame> shards) const;
+};
+
+struct ShardWorkerConfig {
+    // Targets per threat report; also capped by max_datagram_bytes.
+    std::size_t report_targets{32};
+    // Handoff batches larger than this are split across datagrams.
+    std::size_t max_datagram_bytes{8192};
+};
+
+struct ShardWorkerStats {
+    std::uint64_t scans{};
+    // Tracks sent to, and adopted from, neighbouring shards.
+    std::uint64_t handoffs_sent{};
+    std::uint64_t handoffs_adopted{};
+    std::uint64_t reports_sent{};
+    std::uint64_t malformed_messages{};
+    std::uint64_t send_failures{};
+};
+
+// One shard of a distributed deployment. The worker only ever sees the raw
+// returns of its own cell; what crosses shard boundaries is track state.
+// Each scan it adopts the handoffs waiting on its transport, detects and
+// tracks its returns, hands every track it associated this scan and that
+// lies near a neighbouring cell to that neighbour, and reports its most
+// severe targets to the coordinator. A neighbour adopting a handed-off
+// track keeps its id, so a target keeps one id as it crosses cells.
+//
+// Track ids are only unique across shards if every tracker is configured
+// with trackerConfig(). Shards need not scan in lockstep: handoffs carry
+// their stamp and are extrapolated on adoption.
+class ShardWorker {
+public:
+    ShardWorker(const ShardLayout& layout, std::uint32_t shard, TargetDetector& detector,
+                TargetTracker& tracker, ShardTransport& transport, ShardWorkerConfig config = {});
+
+    // base with track ids interleaved by shard.
+    static TrackerConfig trackerConfig(const ShardLayout& layout, std::uint32_t shard, TrackerConfig base = {});
+
+    // Runs one scan of this shard's returns. The tracked targets stay valid
+    // until the next call.
+    std::span<const Target> scan(const RadarFrameView& frame, std::chrono::system_clock::time_point stamp);
+
+    std::uint32_t shard() const noexcept { return shard_; }
+    const ShardWorkerStats& stats() const noexcept { return stats_; }
+
+    // Writes a handoff datagram carrying tracks into out and returns its
+    // size, or 0 if out is too small.
+    static std::size_t encodeHandoff(std::span<std::byte> out, std::uint32_t source_shard, std::uint64_t sequence,
+                                     std::chrono::system_clock::time_point stamp,
+                                     std::span<const TrackView> tracks);
+    // Appends the tracks of a handoff datagram to out and sets stamp to its
+    // scan stamp; false, with out untouched, if it is malformed.
+    static bool decodeHandoff(std::span<const std::byte> datagram, std::vector<TrackView>& out,
+                              std::chrono::system_clock::time_point& stamp);
+
+private:
+    ShardLayout layout_;
+    std::uint32_t shard_;
+    TargetDetector& detector_;
+    TargetTracker& tracker_;
+    ShardTransport& transport_;
+    ShardWorkerConfig config_;
+    ShardWorkerStats stats_{};
+
+    std::vector<Target> targets_;
+    // Per-neighbour handoff batches, indexed by shard.
+    std::vector<std::vector<TrackView>> outbox_;
+    std::vector<std::uint32_t> neighbours_;
+    std::vector<TrackView> inbox_;
+    std::vector<TargetRecord> records_;
+    std::vector<std::byte> datagram_;
+
+    void adoptHandoffs();
+    void sendHandoffs(std::chrono::system_clock::time_point stamp);
+    void sendReport(std::chrono::system_clock::time_point stamp);
+};
+
+struct ShardCoordinatorConfig {
+    std::size_t top_n{32};
+    // A shard whose newest report is stamped more than this before the
+    // newest report of any shard is left out of the merge. Judged by scan
+    // stamp, so shards may start late or scan at different rates; keep it
+    // above the slowest shard's scan period.
+    std::chrono::nanoseconds max_lag{std::chrono::seconds(1)};
+    // A report stamped more than this before its shard's current report is
+    // taken as the shard restarting, or its clock stepping back, rather
+    // than as reordered, and replaces the current report.
+    std::chrono::nanoseconds resync_after{std::chrono::seconds(10)};
+};
+
+struct ShardCoordinatorStats {
+    std::uint64_t reports{};
+    // Reports older than their shard's current one, dropped.
+    std::uint64_t reordered{};
+    std::uint64_t resyncs{};
+};
+
+// Merges the shards' threat reports into one top-N list. Only the newest
+// report of each shard is kept, by scan stamp; the sequence a worker sends
+// is its own scan count and is not compared across shards. A track
+// reported by two shards at once (a target straddling a boundary) is
+// listed once, with its more severe record. Ordering is threat, then
+// confidence, descending, then id.
+class ShardCoordinator {
+public:
+    explicit ShardCoordinator(std::uint32_t shard_count, ShardCoordinatorConfig config = {});
+
+    // Folds in one datagram; false if it is not a well-formed threat report
+    // from a known shard.
+    bool accept(std::span<const std::byte> datagram);
+    // Accepts every datagram waiting on transport and returns how many.
+    std::size_t poll(ShardTransport& transport);
+
+    std::span<const TargetRecord> topThreats();
+    // Stamp of the newest report held, or the epoch before any arrives.
+    std::chrono::system_clock::time_point newestStamp() const noexcept;
+    const ShardCoordinatorStats& stats() const noexcept { return stats_; }
+
+private:
+    struct Report {
+        std::int64_t stamp_ns{};
+        bool valid{false};
+        std::vector<TargetRecord> records;
+    };
+
+    ShardCoordinatorConfig config_;
+    ShardCoordinatorStats stats_{};
+    std::vector<Report> reports_;
+    std::vector<TargetRecord> merged_;
+    bool dirty_{false};
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Neighbor {
+    std::uint32_t index{};
+    double distance_sq{};
+};
+
+// Uniform hash grid over a point set. build() buckets the points by cell with
+// a counting sort, so a rebuild is O(n) and reuses every buffer; queries scan
+// only the cells that overlap the search region. Sizing cells to the typical
+// query radius keeps a radius query to a 3x3x3 block.
+//
+// Indices reported by queries refer to the positions passed to build(), or
+// the index given to insert().
+class SpatialGrid {
+public:
+    explicit SpatialGrid(double cell_size = 100.0);
+
+    // Takes effect on the next build().
+    void setCellSize(double cell_size) noexcept { cell_size_ = cell_size; }
+    double cellSize() const noexcept { return cell_size_; }
+
+    void build(std::span<const double> x, std::span<const double> y, std::span<const double> z);
+    // Adds one point after build() without a rebuild, in O(1) amortised.
+    // Inserted points are chained per cell rather than kept contiguous, so
+    // rebuild once many have accumulated.
+    void insert(double x, double y, double z, std::uint32_t index);
+    void clear() noexcept;
+
+    std::size_t size() const noexcept { return px_.size(); }
+    bool empty() const noexcept { return px_.empty(); }
+
+    // Calls fn(index, distance_sq) for every point within radius, in no
+    // particular order.
+    template <typename Fn>
+    void forEachInRadius(double x, double y, double z, double radius, Fn&& fn) const;
+
+    void radiusQuery(double x, double y, double z, double radius, std::vector<Neighbor>& out) const;
+    // The k nearest points, closest first.
+    void nearest(double x, double y, double z, std::size_t k, std::vector<Neighbor>& out) const;
+
+private:
+    struct Cell {
+        std::uint64_t key{kEmpty};
+        std::uint32_t begin{};
+        std::uint32_t end{};
+        // Most recently inserted point, chained through next_.
+        std::uint32_t inserted{kNoPoint};
+    };
+
+    static constexpr std::uint64_t kEmpty = ~std::uint64_t{0};
+    static constexpr std::uint32_t kNoPoint = ~std::uint32_t{0};
+    static constexpr int kAxisBits = 21;
+    static constexpr std::int64_t kAxisBias = std::int64_t{1} << (kAxisBits - 1);
+
+    double cell_size_;
+    double inv_cell_{};
+    std::vector<Cell> cells_;
+    std::size_t occupied_{};
+    std::uint64_t mask_{};
+    std::int64_t lo_[3]{};
+    std::int64_t hi_[3]{};
+
+    // Points reordered so each cell is one contiguous run, then inserted
+    // points in insertion order; next_[i - built_] links an inserted point
+    // to the previous one in its cell.
+    std::vector<double> px_, py_, pz_;
+    std::vector<std::uint32_t> index_;
+    std::vector<std::uint32_t> next_;
+    std::size_t built_{};
+    std::vector<std::uint32_t> slot_of_;
+
+    std::int64_t cellCoord(double v) const noexcept;
+    static std::uint64_t packKey(std::int64_t cx, std::int64_t cy, std::int64_t cz) noexcept;
+    static std::uint64_t hashKey(std::uint64_t key) noexcept;
+    const Cell* findCell(std::uint64_t key) const noexcept;
+    std::uint32_t insertCell(std::uint64_t key);
+    void growCells();
+
+    template <typename Fn>
+    void scanCell(std::int64_t cx, std::int64_t cy, std::int64_t cz,
+                  double x, double y, double z, Fn&& fn) const;
+};
+
+template <typename Fn>
+void SpatialGrid::scanCell(std::int64_t cx, std::int64_t cy, std::int64_t cz,
+                           double x, double y, double z, Fn&& fn) const {
+    const Cell* cell = findCell(packKey(cx, cy, cz));
+    if (!cell) return;
+    auto visit = [&](std::uint32_t i) {
+        const double dx = px_[i] - x;
+        const double dy = py_[i] - y;
+        const double dz = pz_[i] - z;
+        fn(index_[i], dx * dx + dy * dy + dz * dz);
+    };
+    for (std::uint32_t i = cell->begin; i < cell->end; ++i) visit(i);
+    for (std::uint32_t i = cell->inserted; i != kNoPoint; i = next_[i - built_]) visit(i);
+}
+
+template <typename Fn>
+void SpatialGrid::forEachInRadius(double x, double y, double z, double radius, Fn&& fn) const {
+    if (empty() || !(radius >= 0.0)) return;
+    const double radius_sq = radius * radius;
+    const double centre[3] = {x, y, z};
+    std::int64_t lo[3], hi[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        lo[axis] = std::max(cellCoord(centre[axis] - radius), lo_[axis]);
+        hi[axis] = std::min(cellCoord(centre[axis] + radius), hi_[axis]);
+        if (lo[axis] > hi[axis]) return;
+    }
+    for (std::int64_t cx = lo[0]; cx <= hi[0]; ++cx) {
+        for (std::int64_t cy = lo[1]; cy <= hi[1]; ++cy) {
+            for (std::int64_t cz = lo[2]; cz <= hi[2]; ++cz) {
+                scanCell(cx, cy, cz, x, y, z, [&](std::uint32_t index, double distance_sq) {
+                    if (distance_sq <= radius_sq) fn(index, distance_sq);
+                });
+            }
+        }
+    }
+}
+
+#endif
@@ -4,35 +4,50 @@
 #include <vector>
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <functional>
+#include <memory_resource>
 #include <compare>
 #include <cmath>
 #include <optional>
 #include <ranges>
+#include <span>
 #include <algorithm>
+#include "DescriptionTable.h"
+#include "DetectionBackend.h"
+#include "DetectionKernel.h"
+#include "DetectionStats.h"
+#include "Instrumentation.h"
+#include "RadarFrame.h"
+#include "ReturnClusterer.h"
+#include "ReturnPrefilter.h"
+#include "ScanArena.h"
+#include "SeqLock.h"
+#include "ThreadPool.h"
+#include "ThreatLevel.h"
+#include "ThreatPolicy.h"
 
-enum class ThreatLevel {
-    LOW,
-    MEDIUM,
-    HIGH,
-    CRITICAL
-};
-
+// Hot per-detection record. Trivially copyable and allocation free: the
+// free-text description lives in a DescriptionTable and is referenced by
+// interned id, and detection_time is stamped once per scan.
 struct Target {
-    int id{};
+    std::uint32_t id{};
+    std::uint16_t description_id{DescriptionTable::kNone};
+    ThreatLevel threat_level{ThreatLevel::LOW};
     double x{}, y{}, z{};
     double velocity{};
     double confidence{};
-    ThreatLevel threat_level{ThreatLevel::LOW};
-    std::chrono::system_clock::time_point detection_time{std::chrono::system_clock::now()};
-    std::string description{};
+    std::chrono::system_clock::time_point detection_time{};
 
     Target() = default;
 
-    Target(int id, double x, double y, double z, double velocity, double confidence,
-           ThreatLevel threat_level, std::string description = "")
-        : id(id), x(x), y(y), z(z), velocity(velocity), confidence(confidence),
-          threat_level(threat_level), detection_time(std::chrono::system_clock::now()),
-          description(std::move(description)) {}
+    constexpr Target(std::uint32_t id, double x, double y, double z, double velocity, double confidence,
+                     ThreatLevel threat_level, std::chrono::system_clock::time_point detection_time = {},
+                     std::uint16_t description_id = DescriptionTable::kNone) noexcept
+        : id(id), description_id(description_id), threat_level(threat_level),
+          x(x), y(y), z(z), velocity(velocity), confidence(confidence),
+          detection_time(detection_time) {}
 
     [[nodiscard]] std::partial_ordering operator<=>(const Target& other) const noexcept {
         if (auto cmp = threat_level <=> other.threat_level; cmp != 0) {
@@ -46,21 +61,251 @@ struct Target {
     }
 };
 
-class TargetDetector {
+static_assert(std::is_trivially_copyable_v<Target>);
+
+// How detectRadarTargets orders its results.
+//  FullSort      - complete sort by threat, then confidence (descending).
+//  ThreatBuckets - counting pass over the four threat levels, then only the
+//                  first top_k results are sorted by confidence; the rest
+//                  stay grouped by threat, in unspecified order within
+//                  each level.
+//  None          - input order, no ordering work at all.
+enum class TargetOrdering {
+    FullSort,
+    ThreatBuckets,
+    None
+};
+
+// Policy-independent half of the detector: result ordering, parallel
+// chunking, id assignment and result materialisation. BasicTargetDetector
+// adds the compile-time specialised kernel on top.
+class TargetDetectorCore {
 public:
-    explicit TargetDetector(double threshold = 0.5);
+    // top_k == 0 means every result is fully ordered within its bucket.
+    void setOrdering(TargetOrdering ordering, std::size_t top_k = 0);
+    TargetOrdering getOrdering() const { return ordering_; }
+
+    // Applies the configured ordering in place; scans call this on their
+    // results, and it is exposed for re-ordering merged result sets.
+    void orderTargets(std::span<Target> targets);
+
+    // Parallel mode: frames larger than chunk_size are split into chunks
+    // processed on pool. Output, including ids, is identical to serial
+    // mode. Pass nullptr to return to serial processing.
+    void setThreadPool(ThreadPool* pool, std::size_t chunk_size = kDefaultChunkSize);
+    ThreadPool* getThreadPool() const { return pool_; }
+
+    static constexpr std::size_t kDefaultChunkSize = 16384;
+
+    // Arithmetic of the detection kernel; see KernelPrecision. Float32
+    // trades exactness at the doctrine boundaries for twice the SIMD width.
+    void setPrecision(KernelPrecision precision) { precision_ = precision; }
+    KernelPrecision getPrecision() const { return precision_; }
+
+    // Offload: frames of at least min_returns go to backend in one piece
+    // instead of the chunked CPU kernel, with identical results. Where the
+    // crossover lies depends on the machine; BM_Backend measures it.
+    // Threshold-family policies only; others always run on the CPU. The
+    // backend is not owned. Pass nullptr to turn offload off.
+    void setOffload(DetectionBackend* backend, std::size_t min_returns = kDefaultOffloadCrossover);
+    DetectionBackend* getOffload() const { return offload_; }
+
+    // Placeholder, not a measurement: large enough that transfers should
+    // amortise on any device. Pass the crossover BM_Backend finds on the
+    // target machine instead.
+    static constexpr std::size_t kDefaultOffloadCrossover = std::size_t{1} << 20;
 
-    std::vector<Target> detectRadarTargets(const std::vector<std::vector<double>>& raw_data);
+    // Optional clustering stage between thresholding and target creation:
+    // returns that pass the threshold are merged by ReturnClusterer and each
+    // cluster becomes one Target. Runs on the detector's pool when set.
+    // std::nullopt turns it off again.
+    void setClustering(std::optional<ClusterConfig> config);
+    bool isClustering() const { return clusterer_.has_value(); }
+
+    // Optional early rejection ahead of the kernel: returns outside the
+    // configured range gates, sectors or inside an exclusion box are
+    // dropped before range and confidence are computed. The threshold gate
+    // alone never changes the result, only its cost. std::nullopt turns it
+    // off again.
+    void setPrefilter(std::optional<PrefilterConfig> config);
+    bool isPrefiltering() const { return prefilter_.has_value(); }
+
+    // Side table resolving Target::description_id.
+    const DescriptionTable& getDescriptions() const { return descriptions_; }
+
+    // Results of the last scan(frame) / detectRadarTargets call.
+    std::span<const Target> getTargets() const { return detected_targets_; }
+    // Storage retained behind getTargets(); flat once the largest scan has
+    // been seen.
+    std::size_t getTargetCapacity() const { return detected_targets_.capacity(); }
+
+    // Aggregates kept up to date by every scan: per-threat counts,
+    // confidence and velocity moments and cycle time. O(1) and safe to call
+    // from any thread while scans run.
+    DetectionStats getStats() const noexcept { return stats_.load(); }
+
+    // Weight of the newest cycle in DetectionStats::cycle_ewma_ms.
+    static constexpr double kCycleSmoothing = 0.1;
+
+    // Debug aid over StreamSink::formatText; output stages should feed a
+    // TargetSink instead.
     void printTargets() const;
     size_t getTargetCount() const;
 
-private:
+protected:
+    explicit TargetDetectorCore(double threshold);
+
     double confidence_threshold_;
     std::vector<Target> detected_targets_;
-    int next_target_id_{1};
+    RadarFrame staging_frame_;
+    KernelOutput kernel_{};
+    std::vector<std::size_t> chunk_offsets_;
+    std::size_t active_chunk_{0};
+    KernelPrecision precision_{KernelPrecision::Float64};
+    // Set by prepareChunks when this frame goes to offload_ as one chunk.
+    bool offloading_{false};
+
+    // Two-phase scan shared by every overload: the derived classify() runs
+    // the kernel per chunk between prepareChunks() and finishChunks(), which
+    // returns how many targets the frame yields (after clustering, when
+    // enabled); materialize() then writes
+    // exactly that many into caller-provided storage and orders them.
+    // threshold_range is the model's range limit for the prefilter gate;
+    // can_offload says whether the kernel has threshold parameters.
+    std::size_t prepareChunks(std::size_t count, double threshold_range, bool can_offload);
+    std::size_t finishChunks(const RadarFrameView& frame);
+    // The slice of frame the kernel should see for one chunk: the slice
+    // itself, or its prefilter survivors.
+    RadarFrameView gateChunk(const RadarFrameView& frame, std::size_t begin, std::size_t len);
+    std::size_t offloadChunk(const ThresholdKernelParams& params, const RadarFrameView& chunk, const KernelOutput& out);
+    void materialize(const RadarFrameView& frame, std::span<Target> out);
+    void forEachChunk(std::size_t chunks, const std::function<void(std::size_t)>& body);
+
+    // Packs the legacy nested-vector format into staging_frame_.
+    RadarFrameView stage(const std::vector<std::vector<double>>& raw_data);
+
+private:
+    std::uint32_t next_target_id_{1};
+    DescriptionTable descriptions_;
+    std::uint16_t signal_description_;
+    KernelScratch kernel_scratch_;
+    TargetOrdering ordering_{TargetOrdering::FullSort};
+    std::size_t top_k_{0};
+    std::vector<Target> order_scratch_;
+    ThreadPool* pool_{nullptr};
+    std::size_t chunk_size_{kDefaultChunkSize};
+    std::optional<ReturnClusterer> clusterer_;
+    std::span<const ReturnCluster> clusters_;
+    DetectionBackend* offload_{nullptr};
+    std::size_t offload_min_returns_{kDefaultOffloadCrossover};
+    std::optional<ReturnPrefilter> prefilter_;
+    PrefilterScratch prefilter_scratch_;
+    PrefilterColumns candidates_{};
+    // Columns the kernel output indexes: the frame, or candidates_.
+    RadarFrameView source_{};
 
-    std::optional<Target> processSignal(const std::vector<double>& signal_point);
-    ThreatLevel calculateThreat(double velocity, double distance) const;
+    struct ChunkStats {
+        std::array<std::uint32_t, kThreatLevels> threats{};
+        RunningMoments confidence{};
+        RunningMoments velocity{};
+    };
+    std::vector<ChunkStats> chunk_stats_;
+    std::chrono::steady_clock::time_point scan_started_{};
+    DetectionStats totals_{};
+    SeqLock<DetectionStats> stats_;
+    // Surviving returns, gathered for the clusterer.
+    std::vector<double> survivor_x_, survivor_y_, survivor_z_;
+    std::vector<double> survivor_velocity_, survivor_confidence_;
+    std::vector<std::uint8_t> survivor_threat_;
+
+    std::size_t clusterSurvivors();
+    void materializeClusters(std::span<Target> out, std::chrono::system_clock::time_point scan_time,
+                             std::uint32_t first_id);
+    static ChunkStats summarize(std::span<const Target> targets) noexcept;
+    void publishStats(std::size_t returns, std::span<const Target> targets);
+    void orderByThreatBuckets(std::span<Target> targets);
 };
 
-#endif
\ No newline at end of file
+// Radar detector specialised at compile time on a threat policy and a
+// confidence model (see ThreatPolicy.h). Swapping doctrine costs no
+// dispatch in the hot loop: the kernel is instantiated for the pair.
+template <ThreatPolicy Policy = DefaultThreatPolicy, ConfidenceModel Model = DefaultConfidenceModel>
+class BasicTargetDetector : public TargetDetectorCore {
+public:
+    using Kernel = BasicDetectionKernel<Policy, Model>;
+
+    explicit BasicTargetDetector(double threshold = 0.5)
+        : TargetDetectorCore(threshold) {}
+
+    // Zero-copy scan: the returned span aliases the detector's own result
+    // storage and stays valid until the next scan on this detector.
+    std::span<const Target> scan(const RadarFrameView& frame) {
+        scan(frame, detected_targets_);
+        return detected_targets_;
+    }
+
+    // Writes into a caller-owned buffer instead, leaving getTargets()
+    // untouched. Reusing the buffer across cycles keeps scanning free of
+    // allocations once its capacity has settled.
+    void scan(const RadarFrameView& frame, std::vector<Target>& out) {
+        PROFILE_SCOPE(Stage::Detect);
+        out.resize(classify(frame));
+        materialize(frame, out);
+    }
+
+    // Allocator-aware variants. With a pmr vector, growth comes from the
+    // vector's resource. With an arena, results are carved out of it and
+    // stay valid until arena.reset().
+    void scan(const RadarFrameView& frame, std::pmr::vector<Target>& out) {
+        PROFILE_SCOPE(Stage::Detect);
+        out.resize(classify(frame));
+        materialize(frame, out);
+    }
+
+    std::span<const Target> scan(const RadarFrameView& frame, ScanArena& arena) {
+        PROFILE_SCOPE(Stage::Detect);
+        const std::size_t count = classify(frame);
+        const std::span<Target> out(arena.allocateArray<Target>(count), count);
+        materialize(frame, out);
+        return out;
+    }
+
+    // Copying adapters over scan().
+    std::vector<Target> detectRadarTargets(const RadarFrameView& frame) {
+        const auto targets = scan(frame);
+        return {targets.begin(), targets.end()};
+    }
+    std::vector<Target> detectRadarTargets(const RadarFrame& frame) {
+        return detectRadarTargets(frame.view());
+    }
+    std::vector<Target> detectRadarTargets(const std::vector<std::vector<double>>& raw_data) {
+        return detectRadarTargets(stage(raw_data));
+    }
+
+private:
+    std::size_t classify(const RadarFrameView& frame) {
+        const std::size_t count = frame.size();
+        const std::size_t chunks = prepareChunks(count, Kernel::thresholdRange(confidence_threshold_, precision_),
+                                                 Kernel::kVectorized);
+
+        // Each chunk compacts its survivors into its own slice of
+        // kernel_.selected, using chunk-relative indices.
+        forEachChunk(chunks, [&](std::size_t c) {
+            const std::size_t begin = c * active_chunk_;
+            const RadarFrameView chunk = gateChunk(frame, begin, std::min(active_chunk_, count - begin));
+            chunk_offsets_[c + 1] = runChunk(chunk, kernel_.subspan(begin, chunk.size()));
+        });
+        return finishChunks(frame);
+    }
+
+    std::size_t runChunk(const RadarFrameView& chunk, const KernelOutput& out) {
+        if constexpr (Kernel::kVectorized) {
+            if (offloading_) return offloadChunk(Kernel::thresholdParams(), chunk, out);
+        }
+        return Kernel::run(Kernel::activeBackend(), chunk, confidence_threshold_, out, precision_);
+    }
+};
+
+using TargetDetector = BasicTargetDetector<>;
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef TARGET_HISTORY_H
+#define TARGET_HISTORY_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <vector>
+#include "TargetDetector.h"
+
+// Columns of a history row, combinable as a mask. A query decodes only
+// the columns it filters on plus the ones it asks for.
+enum HistoryColumn : std::uint32_t {
+    kHistoryStamp = 1u << 0,
+    kHistoryId = 1u << 1,
+    kHistoryThreat = 1u << 2,
+    kHistoryDescription = 1u << 3,
+    kHistoryPosition = 1u << 4,
+    kHistoryVelocity = 1u << 5,
+    kHistoryConfidence = 1u << 6,
+    kHistoryAll = (1u << 7) - 1
+};
+
+struct HistoryConfig {
+    // Time span of one chunk. The open chunk is kept as raw Targets and
+    // encoded when a row stamped past its span arrives.
+    std::chrono::seconds chunk_span{10};
+    // Encoded chunks wholly older than this, measured from the newest row,
+    // are dropped. Zero keeps everything.
+    std::chrono::seconds retention{0};
+    // Quanta for x, y, z in metres, velocity in m/s and confidence. A
+    // column with a positive quantum is rounded to multiples of it, within
+    // half a quantum, and stored as deltas when its chunk closes; zero
+    // keeps the column exact. Measured positions carry noise in every
+    // mantissa bit, so only a quantum shrinks them much below 8 bytes.
+    double position_quantum{0.0};
+    double velocity_quantum{0.0};
+    double confidence_quantum{0.0};
+};
+
+// [from, to) in detection time, threat at or above min_threat, and
+// optionally a single track id.
+struct HistoryQuery {
+    std::chrono::system_clock::time_point from{};
+    std::chrono::system_clock::time_point to{std::chrono::system_clock::time_point::max()};
+    ThreatLevel min_threat{ThreatLevel::LOW};
+    std::optional<std::uint32_t> id{};
+};
+
+struct HistoryStats {
+    std::uint64_t rows{};
+    std::size_t chunks{};
+    // Encoded chunks plus the open chunk, against the same rows as Targets.
+    std::size_t bytes{};
+    std::size_t raw_bytes{};
+};
+
+// Append-only, in-memory detection history, partitioned into time chunks
+// and stored column-wise once a chunk closes. Closing sorts the chunk's
+// rows by id, then time, so each track's rows sit together, and encodes:
+//     stamps      delta-of-delta, Gorilla-style bucketed bit codes
+//     ids         gaps of 0 or 1 in one or two bits
+//     threat      2 bits per row
+//     description (value, run) pairs
+//     x, y, z, velocity, confidence
+//                 Gorilla XOR against the previous value in the column, or
+//                 with a quantum, deltas of the rounded value in a 7-bit
+//                 length and that many bits
+// All encodings but the quantum are lossless; a chunk whose column holds
+// a value the quantum cannot represent, such as NaN, keeps it exact. Each
+// chunk keeps its time range, id range and the threat levels it contains,
+// so a query skips chunks it cannot match without decoding anything.
+//
+// Rows appended after the tracker carry track ids, which makes the store
+// a track history as well. One writer and any number of readers may run
+// concurrently.
+class TargetHistory {
+public:
+    explicit TargetHistory(HistoryConfig config = {});
+
+    // Rows are stamped with their detection_time.
+    void append(std::span<const Target> targets);
+
+    // Appends the matching rows to out, chunk by chunk in time order; by
+    // id, then time within an encoded chunk and in append order within the
+    // open one. Columns outside the mask are left default-initialised.
+    // Returns how many were appended.
+    std::size_t query(const HistoryQuery& query, std::vector<Target>& out,
+                      std::uint32_t columns = kHistoryAll) const;
+    // Number of matching rows; decodes only the filter columns.
+    std::size_t count(const HistoryQuery& query) const;
+
+    HistoryStats stats() const;
+
+private:
+    enum Stream : std::size_t {
+        kStampStream,
+        kIdStream,
+        kThreatStream,
+        kDescriptionStream,
+        kXStream,
+        kYStream,
+        kZStream,
+        kVelocityStream,
+        kConfidenceStream,
+        kStreamCount
+    };
+
+    struct Chunk {
+        std::int64_t first_ns{};
+        std::int64_t last_ns{};
+        std::uint32_t first_id{};
+        std::uint32_t last_id{};
+        std::uint8_t threat_mask{};
+        // Bit per stream, set where the column was stored quantised.
+        std::uint16_t quantized{};
+        std::size_t rows{};
+        std::array<std::vector<std::uint64_t>, kStreamCount> streams;
+
+        std::size_t bytes() const noexcept;
+    };
+
+    // Decoded columns of one chunk, reused across chunks in a query.
+    struct Scratch {
+        std::vector<std::int64_t> stamps;
+        std::vector<std::uint32_t> ids;
+        std::vector<std::uint8_t> threats;
+        std::vector<std::uint16_t> descriptions;
+        std::vector<double> values;
+        std::vector<std::uint32_t> selected;
+    };
+
+    HistoryConfig config_;
+    mutable std::shared_mutex mutex_;
+    std::vector<Chunk> chunks_;
+    std::int64_t open_start_ns_{};
+    std::vector<Target> open_;
+    std::vector<std::uint32_t> order_;
+    std::uint64_t rows_{0};
+
+    void seal();
+    void evict(std::int64_t newest_ns);
+    static bool mayMatch(const Chunk& chunk, const HistoryQuery& query, std::int64_t from_ns,
+                         std::int64_t to_ns) noexcept;
+    static void select(const Chunk& chunk, const HistoryQuery& query, std::int64_t from_ns,
+                       std::int64_t to_ns, Scratch& scratch);
+    static bool matches(const Target& target, const HistoryQuery& query) noexcept;
+};
+
+#endif
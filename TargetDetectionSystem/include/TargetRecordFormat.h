@@ -0,0 +1,100 @@
+#ifndef TARGET_RECORD_FORMAT_H
+#define TARGET_RECORD_FORMAT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+// Binary detection output, in host byte order. Needs nothing but this
+// header to decode.
+//
+// Stream form (StreamSink with SinkFormat::Binary), one batch per scan:
+//
+//     TargetBatchHeader, then TargetRecord[count]
+//
+// Shared-memory ring form (SharedRingSink): a file laid out as
+//
+//     SharedRingHeader, then TargetRecord[capacity]
+//
+// Record n lives in slot n % capacity, so record n + capacity overwrites
+// it. head is the total number of records published; write_head is the
+// number reserved, head plus the batch being written. Per scan the writer
+//     stores write_head = head + count, then issues a release fence,
+//     writes the batch's slots,
+//     stores head = write_head with release.
+// A reader keeps its own cursor. It loads head with acquire and copies
+// records [cursor, head); then it issues an acquire fence, loads write_head
+// and drops every copied record n with n + capacity < write_head, since
+// the writer may have been overwriting its slot mid-copy. Any slot write
+// the copy observed was preceded by its reservation, so a torn record is
+// always dropped. A cursor more than capacity behind head has been lapped
+// and skips ahead. readSharedRing below implements the reader side.
+struct TargetRecord {
+    std::uint32_t id;
+    std::uint16_t description_id;
+    std::uint8_t threat_level;
+    std::uint8_t reserved;
+    // Scan the target came from, and its system_clock time in nanoseconds.
+    std::uint64_t sequence;
+    std::int64_t stamp_ns;
+    double x;
+    double y;
+    double z;
+    double velocity;
+    double confidence;
+};
+
+struct TargetBatchHeader {
+    std::uint32_t magic;
+    std::uint32_t count;
+    std::uint64_t sequence;
+    std::int64_t stamp_ns;
+};
+
+struct SharedRingHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t record_bytes;
+    std::uint64_t capacity;
+    std::atomic<std::uint64_t> head;
+    // Sequence of the newest published scan.
+    std::atomic<std::uint64_t> last_sequence;
+    std::atomic<std::uint64_t> write_head;
+    std::uint64_t reserved[2];
+};
+
+static_assert(sizeof(TargetRecord) == 64);
+static_assert(sizeof(TargetBatchHeader) == 24);
+static_assert(sizeof(SharedRingHeader) == 64);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+inline constexpr std::uint32_t kTargetBatchMagic = 0x31424754; // "TGB1"
+inline constexpr char kSharedRingMagic[8] = {'S', 'F', 'S', 'R', 'I', 'N', 'G', '1'};
+inline constexpr std::uint32_t kSharedRingVersion = 2;
+
+// Copies up to out.size() records published since cursor into out and
+// advances cursor past them. Returns how many were copied intact; records
+// lost to lapping are skipped, so cursor may move further than that.
+inline std::size_t readSharedRing(const SharedRingHeader& header, const TargetRecord* records,
+                                  std::uint64_t& cursor, std::span<TargetRecord> out) noexcept {
+    const std::uint64_t capacity = header.capacity;
+    const std::uint64_t head = header.head.load(std::memory_order_acquire);
+    if (head > cursor + capacity) cursor = head - capacity;
+    const std::uint64_t begin = cursor;
+    const std::uint64_t end = begin < head ? std::min<std::uint64_t>(head, begin + out.size()) : begin;
+    for (std::uint64_t n = begin; n < end; ++n) {
+        std::memcpy(&out[n - begin], &records[n % capacity], sizeof(TargetRecord));
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::uint64_t write_head = header.write_head.load(std::memory_order_relaxed);
+    const std::uint64_t first = std::max(begin, write_head > capacity ? write_head - capacity : 0);
+    cursor = std::max(end, first);
+    if (first >= end) return 0;
+    if (first > begin) std::memmove(out.data(), out.data() + (first - begin), (end - first) * sizeof(TargetRecord));
+    return end - first;
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef TARGET_SINK_H
+#define TARGET_SINK_H
+
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include "TargetDetector.h"
+#include "TargetRecordFormat.h"
+
+enum class SinkFormat {
+    // Human-readable lines, as printTargets() prints them.
+    Text,
+    // TargetBatchHeader plus TargetRecords; see TargetRecordFormat.h.
+    Binary
+};
+
+// Destination for detections. Each scan arrives as one batch, so a sink
+// formats into its own reusable buffer and hands it off in a single write
+// instead of streaming target by target.
+class TargetSink {
+public:
+    virtual ~TargetSink() = default;
+
+    // Returns false if the batch could not be written.
+    virtual bool write(std::span<const Target> targets, std::uint64_t sequence) = 0;
+    virtual bool flush() { return true; }
+};
+
+// Batches to a stdio stream: stdout, or a file the sink opens and owns.
+class StreamSink : public TargetSink {
+public:
+    explicit StreamSink(SinkFormat format = SinkFormat::Binary);
+    // Borrows out, which must outlive the sink.
+    StreamSink(std::FILE* out, SinkFormat format);
+    ~StreamSink() override;
+
+    StreamSink(const StreamSink&) = delete;
+    StreamSink& operator=(const StreamSink&) = delete;
+
+    bool open(const std::string& path);
+    bool close();
+    bool isOpen() const noexcept { return file_ != nullptr; }
+    SinkFormat format() const noexcept { return format_; }
+
+    bool write(std::span<const Target> targets, std::uint64_t sequence) override;
+    bool flush() override;
+
+    // Appends the Text rendering of one batch to out.
+    static void formatText(std::span<const Target> targets, std::string& out);
+    static TargetRecord toRecord(const Target& target, std::uint64_t sequence) noexcept;
+
+private:
+    std::FILE* file_{nullptr};
+    bool owned_{false};
+    SinkFormat format_;
+    std::string buffer_;
+};
+
+// Publishes records into a memory-mapped ring file that other processes map
+// read-only and poll; the protocol is in TargetRecordFormat.h. A writer
+// never waits for readers: slow readers are lapped, and can tell.
+// Place the file on tmpfs (/dev/shm on Linux) to keep it off the disk.
+class SharedRingSink : public TargetSink {
+public:
+    explicit SharedRingSink(std::size_t capacity = 1 << 16);
+    ~SharedRingSink() override;
+
+    SharedRingSink(const SharedRingSink&) = delete;
+    SharedRingSink& operator=(const SharedRingSink&) = delete;
+
+    // Creates or replaces the ring file at path.
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const noexcept { return header_ != nullptr; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::uint64_t head() const noexcept;
+
+    bool write(std::span<const Target> targets, std::uint64_t sequence) override;
+
+private:
+    std::size_t capacity_;
+    SharedRingHeader* header_{nullptr};
+    TargetRecord* records_{nullptr};
+    std::size_t size_{0};
+#ifdef _WIN32
+    void* file_handle_{nullptr};
+    void* mapping_handle_{nullptr};
+#endif
+
+    bool map(const std::string& path, std::size_t size);
+    void unmap();
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef TARGET_TRACKER_H
+#define TARGET_TRACKER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "SpatialGrid.h"
+#include "TargetDetector.h"
+
+struct TrackerConfig {
+    // Association gate around each predicted track position, in metres.
+    double gate_radius{150.0};
+    // White-acceleration spectral density of the constant-velocity model.
+    double process_noise{25.0};
+    // Default per-axis position noise of a detection, in metres.
+    double measurement_sigma{10.0};
+    // Velocity uncertainty given to a freshly spawned track, in m/s.
+    double initial_velocity_sigma{300.0};
+    // Consecutive scans with an association before a track is confirmed.
+    std::uint32_t confirm_hits{3};
+    // Consecutive scans without one before a track is dropped.
+    std::uint32_t max_misses{3};
+    // Track ids run first_track_id, first_track_id + track_id_stride, ...
+    // Trackers with distinct first ids and a common stride (one per shard,
+    // see ShardWorker::trackerConfig) never issue the same id.
+    std::uint32_t first_track_id{1};
+    std::uint32_t track_id_stride{1};
+};
+
+// Snapshot of one track, assembled from the tracker's columns.
+struct TrackView {
+    std::uint32_t id{};
+    double x{}, y{}, z{};
+    double vx{}, vy{}, vz{};
+    // Per-axis filter variances, averaged over the three axes.
+    double position_variance{}, velocity_variance{};
+    std::uint32_t hits{};
+    std::uint32_t misses{};
+    bool confirmed{false};
+};
+
+// Multi-scan tracker: gated global-nearest-neighbour association plus one
+// constant-velocity Kalman filter per track, decoupled per axis. Track state
+// is kept column-wise; association looks up gated tracks through a spatial
+// grid, a correction only touches tracks that won an association, and
+// history is never re-processed.
+//
+// update() runs a whole scan. The split form lets several measurement sets
+// (for example one per sensor) correct the same prediction:
+//     beginScan(t); correct(a, sigma_a); correct(b, sigma_b); endScan();
+class TargetTracker {
+public:
+    explicit TargetTracker(TrackerConfig config = {});
+
+    // Associates detections to tracks, spawning tracks for the unmatched
+    // ones, and rewrites every detection's id with its stable track id.
+    void update(std::span<Target> detections, std::chrono::system_clock::time_point stamp);
+
+    void beginScan(std::chrono::system_clock::time_point stamp);
+    // Per-axis sigmas give a diagonal measurement covariance. A correct()
+    // costs O(its detections): the track grid is built once per scan and
+    // each track spawned since is inserted into it.
+    void correct(std::span<Target> detections, const std::array<double, 3>& measurement_sigma);
+    void correct(std::span<Target> detections, double measurement_sigma) {
+        correct(detections, {measurement_sigma, measurement_sigma, measurement_sigma});
+    }
+    void correct(std::span<Target> detections) { correct(detections, config_.measurement_sigma); }
+    void endScan();
+
+    // Takes over a track another tracker handed off, keeping its id. The
+    // state is extrapolated from stamp to this tracker's last scan and
+    // enters the filter with a diagonal covariance. An existing track with
+    // that id is refreshed instead, unless it was associated in its own
+    // last scan. A track this tracker spawned within the gate is taken to
+    // be the same target, picked up before the handoff arrived: the nearest
+    // one is replaced, or, if it has more hits, kept and the handoff
+    // ignored, so the target is never tracked twice. Call between scans;
+    // false if nothing changed.
+    bool adoptTrack(const TrackView& track, std::chrono::system_clock::time_point stamp);
+
+    std::size_t trackCount() const noexcept { return ids_.size(); }
+    TrackView track(std::size_t index) const;
+    std::span<const std::uint32_t> trackIds() const noexcept { return ids_; }
+    const TrackerConfig& config() const noexcept { return config_; }
+
+private:
+    using Column = std::vector<double>;
+    static constexpr std::size_t kAxes = 3;
+
+    struct Candidate {
+        double distance_sq;
+        std::uint32_t detection;
+        std::uint32_t track;
+    };
+
+    TrackerConfig config_;
+    std::uint32_t next_track_id_;
+    std::chrono::system_clock::time_point last_stamp_{};
+    bool has_stamp_{false};
+
+    // Track columns, indexed [axis][track].
+    std::vector<std::uint32_t> ids_;
+    std::array<Column, kAxes> pos_;
+    std::array<Column, kAxes> vel_;
+    std::array<Column, kAxes> p_pp_;
+    std::array<Column, kAxes> p_pv_;
+    std::array<Column, kAxes> p_vv_;
+    std::vector<std::uint32_t> hits_;
+    std::vector<std::uint32_t> misses_;
+    std::vector<std::uint8_t> updated_;
+
+    // Per-scan scratch. The grid indexes predicted track positions with
+    // gate-sized cells, so each detection probes at most 27 cells.
+    SpatialGrid track_grid_;
+    bool grid_valid_{false};
+    std::vector<Candidate> candidates_;
+    std::vector<std::uint8_t> detection_taken_;
+    std::vector<std::uint8_t> track_taken_;
+
+    void gatherCandidates(std::span<const Target> detections);
+    void applyMeasurement(std::size_t track, const Target& detection, const double* variance);
+    std::uint32_t spawnTrack(const Target& detection, const double* variance);
+    // Nearest track within the gate whose id this tracker issued, or
+    // trackCount().
+    std::size_t nearestLocalTrack(const double* position) const noexcept;
+    // Appends a zeroed track and returns its index.
+    std::size_t pushTrack(std::uint32_t id);
+    void eraseTrack(std::size_t index);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent fork-join pool with range-based work stealing.
+//
+// parallelFor splits [0, task_count) into one contiguous range per
+// participant (every worker plus the calling thread). Owners take tasks from
+// the front of their range; idle participants steal the back half of a
+// victim's range with a single CAS, so there is no shared queue and no lock
+// on the task path. Threads are created once and parked between jobs.
+class ThreadPool {
+public:
+    // worker_count excludes the calling thread, which always participates.
+    explicit ThreadPool(std::size_t worker_count = defaultWorkerCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Runs body(i) for every i in [0, task_count) and returns once all
+    // tasks have finished. body must not throw. Calls made from inside a
+    // running body execute serially on the calling thread.
+    void parallelFor(std::size_t task_count, const std::function<void(std::size_t)>& body);
+
+    std::size_t workerCount() const noexcept { return workers_.size(); }
+    std::size_t participantCount() const noexcept { return workers_.size() + 1; }
+
+    static std::size_t defaultWorkerCount() noexcept;
+
+private:
+    // Packed [begin, end) task range; both halves are 32-bit.
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> range{0};
+    };
+
+    std::vector<std::thread> workers_;
+    std::unique_ptr<Slot[]> slots_;
+    std::mutex submit_mutex_;
+    const std::function<void(std::size_t)>* body_{nullptr};
+    std::atomic<std::uint64_t> generation_{0};
+    std::atomic<std::size_t> busy_workers_{0};
+    std::atomic<bool> stopping_{false};
+
+    void workerLoop(std::size_t slot);
+    void participate(std::size_t slot);
+    bool takeOwn(std::size_t slot, std::uint32_t& task);
+    bool steal(std::size_t thief, std::uint32_t& task);
+};
+
+#endif
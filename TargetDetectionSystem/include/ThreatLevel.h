@@ -0,0 +1,24 @@
+#ifndef THREAT_LEVEL_H
+#define THREAT_LEVEL_H
+
+#include <cstdint>
+#include <string_view>
+
+enum class ThreatLevel : std::uint8_t {
+    LOW,
+    MEDIUM,
+    HIGH,
+    CRITICAL
+};
+
+constexpr std::string_view threatLevelName(ThreatLevel level) noexcept {
+    switch (level) {
+        case ThreatLevel::CRITICAL: return "CRITICAL";
+        case ThreatLevel::HIGH:     return "HIGH";
+        case ThreatLevel::MEDIUM:   return "MEDIUM";
+        case ThreatLevel::LOW:      return "LOW";
+    }
+    return "UNKNOWN";
+}
+
+#endif
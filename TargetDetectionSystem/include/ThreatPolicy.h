@@ -0,0 +1,70 @@
+#ifndef THREAT_POLICY_H
+#define THREAT_POLICY_H
+
+#include <concepts>
+#include <type_traits>
+#include "ThreatLevel.h"
+
+// Compile-time doctrine for the detection kernel. A threat policy maps a
+// return's radial velocity and range to a ThreatLevel; a confidence model
+// maps range to a detection confidence. Both are plain types with static
+// functions, resolved when the detector is instantiated, so the hot loop
+// calls them directly and they inline away.
+//
+//     struct MyDoctrine {
+//         static constexpr ThreatLevel classify(double velocity, double distance) noexcept;
+//     };
+//     BasicTargetDetector<MyDoctrine> detector(0.4);
+template <typename P>
+concept ThreatPolicy = requires(double velocity, double distance) {
+    { P::classify(velocity, distance) } noexcept -> std::same_as<ThreatLevel>;
+};
+
+template <typename M>
+concept ConfidenceModel = requires(double distance) {
+    { M::confidence(distance) } noexcept -> std::same_as<double>;
+};
+
+// The built-in doctrine family: CRITICAL when close and fast, HIGH when
+// close, MEDIUM when fast, LOW otherwise. Policies of this shape run on the
+// SIMD kernel backends; any other policy runs an inlined scalar loop.
+template <double CriticalRange, double CriticalSpeed, double HighRange, double MediumSpeed>
+struct ThresholdThreatPolicy {
+    static constexpr double kCriticalRange = CriticalRange;
+    static constexpr double kCriticalSpeed = CriticalSpeed;
+    static constexpr double kHighRange = HighRange;
+    static constexpr double kMediumSpeed = MediumSpeed;
+
+    static constexpr ThreatLevel classify(double velocity, double distance) noexcept {
+        const double speed = velocity < 0.0 ? -velocity : velocity;
+        if (distance < kCriticalRange && speed > kCriticalSpeed) return ThreatLevel::CRITICAL;
+        if (distance < kHighRange) return ThreatLevel::HIGH;
+        if (speed > kMediumSpeed) return ThreatLevel::MEDIUM;
+        return ThreatLevel::LOW;
+    }
+};
+
+// confidence = 1 / (1 + distance * RangeScale).
+template <double RangeScale>
+struct InverseRangeConfidence {
+    static constexpr double kRangeScale = RangeScale;
+
+    static constexpr double confidence(double distance) noexcept {
+        return 1.0 / (1.0 + distance * kRangeScale);
+    }
+};
+
+using DefaultThreatPolicy = ThresholdThreatPolicy<500.0, 100.0, 1000.0, 50.0>;
+using DefaultConfidenceModel = InverseRangeConfidence<0.001>;
+
+template <typename P>
+struct IsThresholdThreatPolicy : std::false_type {};
+template <double CR, double CS, double HR, double MS>
+struct IsThresholdThreatPolicy<ThresholdThreatPolicy<CR, CS, HR, MS>> : std::true_type {};
+
+template <typename M>
+struct IsInverseRangeConfidence : std::false_type {};
+template <double S>
+struct IsInverseRangeConfidence<InverseRangeConfidence<S>> : std::true_type {};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Single-writer / single-reader snapshot handoff. The writer fills its
+// private back buffer and publishes it with one atomic exchange; the reader
+// swaps in the newest published buffer whenever it likes. Neither side ever
+// waits for the other, and a slow reader simply skips stale snapshots.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side.
+    T& writeBuffer() noexcept { return buffers_[back_]; }
+
+    void publish() noexcept {
+        back_ = middle_.exchange(static_cast<std::uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Reader side. Returns true when a newer snapshot was swapped in.
+    bool update() noexcept {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const noexcept { return buffers_[front_]; }
+
+private:
+    static constexpr std::uint8_t kIndexMask = 0x3;
+    static constexpr std::uint8_t kFresh = 0x4;
+
+    T buffers_[3]{};
+    std::uint8_t back_{0};
+    std::atomic<std::uint8_t> middle_{1};
+    std::uint8_t front_{2};
+};
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef UDP_INGEST_H
+#define UDP_INGEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "RadarFrame.h"
+
+// Wire format of one datagram, host byte order: an IngestPacketHeader
+// followed by count returns of {x, y, z, velocity} doubles. A sensor frame
+// spans one or more packets sharing frame_id; the last carries
+// kIngestEndOfFrame. sequence increases by one per packet and is how loss
+// is detected; frame_id increases by one per frame and may wrap.
+struct IngestPacketHeader {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t count;
+    std::uint64_t sequence;
+    std::int64_t stamp_ns;
+    std::uint32_t frame_id;
+    std::uint16_t flags;
+    std::uint16_t reserved;
+};
+
+static_assert(sizeof(IngestPacketHeader) == 32);
+
+inline constexpr std::uint32_t kIngestMagic = 0x31534652; // "RFS1"
+inline constexpr std::uint16_t kIngestVersion = 1;
+inline constexpr std::uint16_t kIngestEndOfFrame = 0x1;
+inline constexpr std::size_t kIngestReturnBytes = 4 * sizeof(double);
+
+struct UdpIngestConfig {
+    std::string bind_address{"0.0.0.0"};
+    // 0 lets the kernel pick; see UdpIngest::boundPort().
+    std::uint16_t port{47800};
+    // Datagrams pulled per recvmmsg call.
+    std::size_t batch_size{64};
+    std::size_t max_packet_bytes{9000};
+    int socket_buffer_bytes{8 << 20};
+    // How often a blocked receive rechecks stop().
+    std::chrono::milliseconds poll_interval{100};
+    // A packet at most this far behind the stream position is a reordered
+    // straggler; one further back means the sender restarted its sequence.
+    std::uint64_t reorder_window{1024};
+};
+
+struct UdpIngestStats {
+    std::uint64_t packets{};
+    std::uint64_t bytes{};
+    std::uint64_t returns{};
+    std::uint64_t frames{};
+    // Frames cut short because packets of the next frame arrived first.
+    std::uint64_t incomplete_frames{};
+    std::uint64_t malformed_packets{};
+    // Datagrams longer than max_packet_bytes, cut short by the kernel.
+    std::uint64_t truncated_packets{};
+    // Gap events, and the packets missing across them.
+    std::uint64_t sequence_gaps{};
+    std::uint64_t packets_lost{};
+    std::uint64_t packets_reordered{};
+    // Sender restarts: jumps back past reorder_window.
+    std::uint64_t sequence_resyncs{};
+    std::uint64_t receive_calls{};
+};
+
+// Batched UDP ingest. Datagrams arrive through recvmmsg into buffers
+// preallocated at open(), and returns are decoded straight into the SoA
+// frame columns, so steady-state receive allocates nothing once the frame's
+// capacity has settled. fill() has the pipeline FrameSource signature.
+// Linux only; open() fails elsewhere.
+class UdpIngest {
+public:
+    explicit UdpIngest(UdpIngestConfig config = {});
+    ~UdpIngest();
+
+    UdpIngest(const UdpIngest&) = delete;
+    UdpIngest& operator=(const UdpIngest&) = delete;
+
+    bool open();
+    void close();
+    bool isOpen() const noexcept { return fd_ >= 0; }
+    std::uint16_t boundPort() const noexcept { return bound_port_; }
+
+    // Blocks until a whole sensor frame has been assembled into frame.
+    // Returns false once stop() is called or the socket is closed.
+    bool fill(RadarFrame& frame);
+    // Safe from any thread; a blocked fill() returns within poll_interval.
+    void stop() noexcept { stop_requested_.store(true, std::memory_order_release); }
+
+    // Reads are approximate while fill() runs on another thread.
+    UdpIngestStats stats() const noexcept;
+
+    // Writes one datagram carrying returns into out and returns its size,
+    // or 0 if out is too small or returns exceeds a packet's count field.
+    static std::size_t encodePacket(std::span<std::byte> out, std::uint64_t sequence, std::uint32_t frame_id,
+                                    std::chrono::system_clock::time_point stamp, bool end_of_frame,
+                                    const RadarFrameView& returns);
+
+private:
+    // Socket-API message arrays, kept out of this header.
+    struct Batch;
+
+    UdpIngestConfig config_;
+    int fd_{-1};
+    std::uint16_t bound_port_{0};
+    std::atomic<bool> stop_requested_{false};
+
+    // recvmmsg state, sized once at open(). Each datagram lands in its own
+    // cache-line aligned stride of storage_.
+    std::unique_ptr<Batch> batch_;
+    std::vector<std::byte> storage_;
+    std::size_t stride_{0};
+    std::size_t batch_count_{0};
+    std::size_t batch_cursor_{0};
+
+    bool have_sequence_{false};
+    std::uint64_t expected_sequence_{0};
+
+    std::atomic<std::uint64_t> packets_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> returns_{0};
+    std::atomic<std::uint64_t> frames_{0};
+    std::atomic<std::uint64_t> incomplete_frames_{0};
+    std::atomic<std::uint64_t> malformed_{0};
+    std::atomic<std::uint64_t> truncated_{0};
+    std::atomic<std::uint64_t> gaps_{0};
+    std::atomic<std::uint64_t> lost_{0};
+    std::atomic<std::uint64_t> reordered_{0};
+    std::atomic<std::uint64_t> resyncs_{0};
+    std::atomic<std::uint64_t> receive_calls_{0};
+
+    bool receiveBatch();
+    std::span<const std::byte> packet(std::size_t index) const noexcept;
+    bool truncated(std::size_t index) const noexcept;
+    // How far sequence is behind the stream position, 0 if it is not. A
+    // packet up to reorder_window behind is stale and dropped; one further
+    // back is a sender restart, which trackSequence() resyncs to.
+    std::uint64_t behind(std::uint64_t sequence) const noexcept {
+        return have_sequence_ && sequence < expected_sequence_ ? expected_sequence_ - sequence : 0;
+    }
+    bool isStale(std::uint64_t sequence) const noexcept {
+        const std::uint64_t distance = behind(sequence);
+        return distance > 0 && distance <= config_.reorder_window;
+    }
+    bool isRestart(std::uint64_t sequence) const noexcept { return behind(sequence) > config_.reorder_window; }
+    void trackSequence(std::uint64_t sequence);
+    static void decodeReturns(const std::byte* payload, std::size_t count, RadarFrame& frame);
+    static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t by = 1) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+};
+
+#endif
@@ -0,0 +1,253 @@
+#include "CudaBackend.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <cuda_runtime.h>
+#include <cub/device/device_select.cuh>
+#include <cub/iterator/counting_input_iterator.cuh>
+
+// Compiled with --fmad=false (see CMakeLists.txt): with contraction off and
+// nvcc's default IEEE sqrt and divide, the device rounds exactly like
+// DetectionKernel.cpp at either precision.
+
+namespace {
+
+constexpr int kThreads = 256;
+constexpr std::size_t kStreams = 2;
+constexpr std::size_t kColumns = 4;
+
+bool ok(cudaError_t status) noexcept { return status == cudaSuccess; }
+
+template <typename Real>
+__global__ void classifyKernel(ThresholdKernelParams p, const double* __restrict__ in, std::size_t stride,
+                               std::uint32_t n, double threshold, double* __restrict__ range,
+                               double* __restrict__ confidence, std::uint8_t* __restrict__ threat,
+                               std::uint8_t* __restrict__ keep) {
+    const std::uint32_t i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= n) return;
+    const Real x = static_cast<Real>(in[i]);
+    const Real y = static_cast<Real>(in[stride + i]);
+    const Real z = static_cast<Real>(in[2 * stride + i]);
+    const Real speed = fabs(static_cast<Real>(in[3 * stride + i]));
+    const Real distance = sqrt(x*x + y*y + z*z);
+    const Real conf = Real(1) / (Real(1) + distance * static_cast<Real>(p.range_scale));
+
+    ThreatLevel level = ThreatLevel::LOW;
+    if (distance < static_cast<Real>(p.critical_range) && speed > static_cast<Real>(p.critical_speed)) {
+        level = ThreatLevel::CRITICAL;
+    } else if (distance < static_cast<Real>(p.high_range)) {
+        level = ThreatLevel::HIGH;
+    } else if (speed > static_cast<Real>(p.medium_speed)) {
+        level = ThreatLevel::MEDIUM;
+    }
+
+    range[i] = distance;
+    confidence[i] = conf;
+    threat[i] = static_cast<std::uint8_t>(level);
+    keep[i] = !(static_cast<double>(conf) < threshold);
+}
+
+// One staging slot: pinned host buffers, device buffers and a stream.
+struct Slot {
+    cudaStream_t stream{};
+    double* host_in{};
+    double* host_range{};
+    double* host_confidence{};
+    std::uint8_t* host_threat{};
+    std::uint32_t* host_selected{};
+    int* host_count{};
+    double* dev_in{};
+    double* dev_range{};
+    double* dev_confidence{};
+    std::uint8_t* dev_threat{};
+    std::uint8_t* dev_keep{};
+    std::uint32_t* dev_selected{};
+    int* dev_count{};
+    void* dev_temp{};
+    std::size_t temp_bytes{};
+
+    std::size_t begin{};
+    std::size_t len{};
+    bool pending{false};
+};
+
+} // namespace
+
+struct CudaBackend::Impl {
+    CudaBackendConfig config;
+    std::size_t capacity{0};
+    std::array<Slot, kStreams> slots{};
+
+    ~Impl() { release(); }
+
+    bool reserve(std::size_t returns);
+    void release() noexcept;
+    bool enqueue(Slot& slot, const ThresholdKernelParams& params, double threshold, KernelPrecision precision);
+    bool harvest(Slot& slot, const KernelOutput& out, std::size_t& selected);
+    std::optional<std::size_t> run(const ThresholdKernelParams& params, const RadarFrameView& frame,
+                                   double threshold, const KernelOutput& out, KernelPrecision precision);
+};
+
+bool CudaBackend::Impl::reserve(std::size_t returns) {
+    if (capacity >= returns) return true;
+    release();
+    for (Slot& s : slots) {
+        const bool allocated =
+            ok(cudaStreamCreateWithFlags(&s.stream, cudaStreamNonBlocking)) &&
+            ok(cudaMallocHost(&s.host_in, kColumns * returns * sizeof(double))) &&
+            ok(cudaMallocHost(&s.host_range, returns * sizeof(double))) &&
+            ok(cudaMallocHost(&s.host_confidence, returns * sizeof(double))) &&
+            ok(cudaMallocHost(&s.host_threat, returns)) &&
+            ok(cudaMallocHost(&s.host_selected, returns * sizeof(std::uint32_t))) &&
+            ok(cudaMallocHost(&s.host_count, sizeof(int))) &&
+            ok(cudaMalloc(&s.dev_in, kColumns * returns * sizeof(double))) &&
+            ok(cudaMalloc(&s.dev_range, returns * sizeof(double))) &&
+            ok(cudaMalloc(&s.dev_confidence, returns * sizeof(double))) &&
+            ok(cudaMalloc(&s.dev_threat, returns)) &&
+            ok(cudaMalloc(&s.dev_keep, returns)) &&
+            ok(cudaMalloc(&s.dev_selected, returns * sizeof(std::uint32_t))) &&
+            ok(cudaMalloc(&s.dev_count, sizeof(int))) &&
+            ok(cub::DeviceSelect::Flagged(nullptr, s.temp_bytes, cub::CountingInputIterator<std::uint32_t>(0),
+                                          s.dev_keep, s.dev_selected, s.dev_count, static_cast<int>(returns))) &&
+            ok(cudaMalloc(&s.dev_temp, s.temp_bytes));
+        if (!allocated) {
+            release();
+            return false;
+        }
+    }
+    capacity = returns;
+    return true;
+}
+
+void CudaBackend::Impl::release() noexcept {
+    for (Slot& s : slots) {
+        if (s.stream) cudaStreamSynchronize(s.stream);
+        cudaFreeHost(s.host_in);
+        cudaFreeHost(s.host_range);
+        cudaFreeHost(s.host_confidence);
+        cudaFreeHost(s.host_threat);
+        cudaFreeHost(s.host_selected);
+        cudaFreeHost(s.host_count);
+        cudaFree(s.dev_in);
+        cudaFree(s.dev_range);
+        cudaFree(s.dev_confidence);
+        cudaFree(s.dev_threat);
+        cudaFree(s.dev_keep);
+        cudaFree(s.dev_selected);
+        cudaFree(s.dev_count);
+        cudaFree(s.dev_temp);
+        if (s.stream) cudaStreamDestroy(s.stream);
+        s = Slot{};
+    }
+    capacity = 0;
+}
+
+// Upload, classify, compact and download one slice, all asynchronous on the
+// slot's stream. The whole index buffer is copied back because the
+// survivor count is only known on the device; at 4 bytes a return it is
+// small beside the range and confidence columns.
+bool CudaBackend::Impl::enqueue(Slot& s, const ThresholdKernelParams& params, double threshold,
+                                KernelPrecision precision) {
+    const std::size_t bytes = s.len * sizeof(double);
+    for (std::size_t c = 0; c < kColumns; ++c) {
+        if (!ok(cudaMemcpyAsync(s.dev_in + c * capacity, s.host_in + c * capacity, bytes,
+                                cudaMemcpyHostToDevice, s.stream))) return false;
+    }
+
+    const auto n = static_cast<std::uint32_t>(s.len);
+    const unsigned blocks = (n + kThreads - 1) / kThreads;
+    if (precision == KernelPrecision::Float32) {
+        classifyKernel<float><<<blocks, kThreads, 0, s.stream>>>(params, s.dev_in, capacity, n, threshold,
+            s.dev_range, s.dev_confidence, s.dev_threat, s.dev_keep);
+    } else {
+        classifyKernel<double><<<blocks, kThreads, 0, s.stream>>>(params, s.dev_in, capacity, n, threshold,
+            s.dev_range, s.dev_confidence, s.dev_threat, s.dev_keep);
+    }
+    if (!ok(cudaGetLastError())) return false;
+
+    // Indices count from the slice start, so they come back frame-global.
+    std::size_t temp_bytes = s.temp_bytes;
+    if (!ok(cub::DeviceSelect::Flagged(s.dev_temp, temp_bytes,
+                                       cub::CountingInputIterator<std::uint32_t>(static_cast<std::uint32_t>(s.begin)),
+                                       s.dev_keep, s.dev_selected, s.dev_count, static_cast<int>(n), s.stream))) {
+        return false;
+    }
+
+    return ok(cudaMemcpyAsync(s.host_range, s.dev_range, bytes, cudaMemcpyDeviceToHost, s.stream)) &&
+           ok(cudaMemcpyAsync(s.host_confidence, s.dev_confidence, bytes, cudaMemcpyDeviceToHost, s.stream)) &&
+           ok(cudaMemcpyAsync(s.host_threat, s.dev_threat, s.len, cudaMemcpyDeviceToHost, s.stream)) &&
+           ok(cudaMemcpyAsync(s.host_selected, s.dev_selected, s.len * sizeof(std::uint32_t),
+                              cudaMemcpyDeviceToHost, s.stream)) &&
+           ok(cudaMemcpyAsync(s.host_count, s.dev_count, sizeof(int), cudaMemcpyDeviceToHost, s.stream));
+}
+
+bool CudaBackend::Impl::harvest(Slot& s, const KernelOutput& out, std::size_t& selected) {
+    if (!s.pending) return true;
+    s.pending = false;
+    if (!ok(cudaStreamSynchronize(s.stream))) return false;
+    std::memcpy(out.range.data() + s.begin, s.host_range, s.len * sizeof(double));
+    std::memcpy(out.confidence.data() + s.begin, s.host_confidence, s.len * sizeof(double));
+    std::memcpy(out.threat.data() + s.begin, s.host_threat, s.len);
+    const auto kept = static_cast<std::size_t>(*s.host_count);
+    std::memcpy(out.selected.data() + selected, s.host_selected, kept * sizeof(std::uint32_t));
+    selected += kept;
+    return true;
+}
+
+// Slices alternate between the two slots. Before a slot is restaged, the
+// slice it carried two steps earlier is harvested, so results are appended
+// in frame order while the other slot's slice is still in flight.
+std::optional<std::size_t> CudaBackend::Impl::run(const ThresholdKernelParams& params, const RadarFrameView& frame,
+                                                  double threshold, const KernelOutput& out,
+                                                  KernelPrecision precision) {
+    const std::size_t n = frame.size();
+    const std::size_t slice = std::max<std::size_t>(std::min(config.slice_returns, n), 1);
+    if (!ok(cudaSetDevice(config.device)) || !reserve(slice)) return std::nullopt;
+
+    const std::array<std::span<const double>, kColumns> columns{frame.x, frame.y, frame.z, frame.velocity};
+    std::size_t selected = 0;
+    std::size_t next = 0;
+    std::size_t step = 0;
+    for (; next < n; ++step) {
+        Slot& s = slots[step % kStreams];
+        if (!harvest(s, out, selected)) return std::nullopt;
+        s.begin = next;
+        s.len = std::min(slice, n - next);
+        next += s.len;
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            std::memcpy(s.host_in + c * capacity, columns[c].data() + s.begin, s.len * sizeof(double));
+        }
+        if (!enqueue(s, params, threshold, precision)) return std::nullopt;
+        s.pending = true;
+    }
+    for (std::size_t k = 0; k < kStreams; ++k) {
+        if (!harvest(slots[(step + k) % kStreams], out, selected)) return std::nullopt;
+    }
+    return selected;
+}
+
+std::unique_ptr<CudaBackend> CudaBackend::create(const CudaBackendConfig& config) {
+    int devices = 0;
+    if (!ok(cudaGetDeviceCount(&devices)) || config.device < 0 || config.device >= devices) return nullptr;
+    auto impl = std::make_unique<Impl>();
+    impl->config = config;
+    return std::unique_ptr<CudaBackend>(new CudaBackend(std::move(impl)));
+}
+
+CudaBackend::CudaBackend(std::unique_ptr<Impl> impl) noexcept
+    : impl_(std::move(impl)) {}
+
+CudaBackend::~CudaBackend() = default;
+
+std::size_t CudaBackend::runThreshold(const ThresholdKernelParams& params, const RadarFrameView& frame,
+                                      double confidence_threshold, const KernelOutput& out,
+                                      KernelPrecision precision) {
+    if (healthy_ && !frame.empty()) {
+        if (const auto selected = impl_->run(params, frame, confidence_threshold, out, precision)) return *selected;
+        healthy_ = false;
+    }
+    return KernelDispatch::runThreshold(KernelDispatch::activeBackend(), params, frame,
+                                        confidence_threshold, out, precision);
+}
@@ -0,0 +1,23 @@
+#include "CudaBackend.h"
+#include <utility>
+
+// Built instead of CudaBackend.cu when RADAR_CUDA is off: no device
+// backend exists, so offload requests fall back to the CPU kernel.
+
+struct CudaBackend::Impl {};
+
+std::unique_ptr<CudaBackend> CudaBackend::create(const CudaBackendConfig&) {
+    return nullptr;
+}
+
+CudaBackend::CudaBackend(std::unique_ptr<Impl> impl) noexcept
+    : impl_(std::move(impl)) {}
+
+CudaBackend::~CudaBackend() = default;
+
+std::size_t CudaBackend::runThreshold(const ThresholdKernelParams& params, const RadarFrameView& frame,
+                                      double confidence_threshold, const KernelOutput& out,
+                                      KernelPrecision precision) {
+    return KernelDispatch::runThreshold(KernelDispatch::activeBackend(), params, frame,
+                                        confidence_threshold, out, precision);
+}
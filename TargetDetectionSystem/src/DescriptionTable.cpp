@@ -0,0 +1,30 @@
+#include "DescriptionTable.h"
+#include <limits>
+
+DescriptionTable::DescriptionTable() {
+    entries_.emplace_back();
+}
+
+std::uint16_t DescriptionTable::intern(std::string_view text) {
+    if (text.empty()) return kNone;
+    if (auto it = index_.find(text); it != index_.end()) {
+        return it->second;
+    }
+    // A moved-from table has lost the reserved entry for kNone.
+    if (entries_.empty()) entries_.emplace_back();
+    if (entries_.size() > std::numeric_limits<std::uint16_t>::max()) {
+        return kNone;
+    }
+
+    // std::deque never relocates existing elements, so the views used as
+    // keys stay valid as the table grows.
+    const auto id = static_cast<std::uint16_t>(entries_.size());
+    const std::string& stored = entries_.emplace_back(text);
+    index_.emplace(stored, id);
+    return id;
+}
+
+std::string_view DescriptionTable::lookup(std::uint16_t id) const noexcept {
+    if (id >= entries_.size()) return {};
+    return entries_[id];
+}
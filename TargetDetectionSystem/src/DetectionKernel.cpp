@@ -0,0 +1,417 @@
+#include "DetectionKernel.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RADAR_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+// This translation unit is built with floating-point contraction disabled so
+// the scalar and vector paths round identically: sqrt, mul, add and div are
+// all correctly rounded IEEE operations and would diverge only if one side
+// fused x*x + y*y into an FMA.
+
+namespace {
+
+ThreatLevel classify(const ThresholdKernelParams& p, double velocity, double distance) noexcept {
+    const double speed = std::abs(velocity);
+    if (distance < p.critical_range && speed > p.critical_speed) return ThreatLevel::CRITICAL;
+    if (distance < p.high_range) return ThreatLevel::HIGH;
+    if (speed > p.medium_speed) return ThreatLevel::MEDIUM;
+    return ThreatLevel::LOW;
+}
+
+std::size_t runScalar(const ThresholdKernelParams& p, const RadarFrameView& frame, std::size_t begin,
+                      double threshold, const KernelOutput& out, std::size_t count) {
+    const std::size_t n = frame.size();
+    for (std::size_t i = begin; i < n; ++i) {
+        const double x = frame.x[i];
+        const double y = frame.y[i];
+        const double z = frame.z[i];
+        const double distance = std::sqrt(x*x + y*y + z*z);
+        const double confidence = 1.0 / (1.0 + distance * p.range_scale);
+
+        out.range[i] = distance;
+        out.confidence[i] = confidence;
+        out.threat[i] = static_cast<std::uint8_t>(classify(p, frame.velocity[i], distance));
+
+        out.selected[count] = static_cast<std::uint32_t>(i);
+        count += !(confidence < threshold);
+    }
+    return count;
+}
+
+// Single-precision variant. Coordinates are rounded to float on load and
+// range, confidence and threat are evaluated in float, so the vector
+// backends process twice the returns per instruction; the threshold test
+// runs on the widened confidence against the exact double threshold.
+struct FloatParams {
+    float range_scale;
+    float critical_range;
+    float critical_speed;
+    float high_range;
+    float medium_speed;
+
+    explicit FloatParams(const ThresholdKernelParams& p) noexcept
+        : range_scale(static_cast<float>(p.range_scale)),
+          critical_range(static_cast<float>(p.critical_range)),
+          critical_speed(static_cast<float>(p.critical_speed)),
+          high_range(static_cast<float>(p.high_range)),
+          medium_speed(static_cast<float>(p.medium_speed)) {}
+};
+
+ThreatLevel classify(const FloatParams& p, float velocity, float distance) noexcept {
+    const float speed = std::abs(velocity);
+    if (distance < p.critical_range && speed > p.critical_speed) return ThreatLevel::CRITICAL;
+    if (distance < p.high_range) return ThreatLevel::HIGH;
+    if (speed > p.medium_speed) return ThreatLevel::MEDIUM;
+    return ThreatLevel::LOW;
+}
+
+std::size_t runScalarF32(const FloatParams& p, const RadarFrameView& frame, std::size_t begin,
+                         double threshold, const KernelOutput& out, std::size_t count) {
+    const std::size_t n = frame.size();
+    for (std::size_t i = begin; i < n; ++i) {
+        const float x = static_cast<float>(frame.x[i]);
+        const float y = static_cast<float>(frame.y[i]);
+        const float z = static_cast<float>(frame.z[i]);
+        const float distance = std::sqrt(x*x + y*y + z*z);
+        const float confidence = 1.0f / (1.0f + distance * p.range_scale);
+
+        out.range[i] = distance;
+        out.confidence[i] = confidence;
+        out.threat[i] = static_cast<std::uint8_t>(classify(p, static_cast<float>(frame.velocity[i]), distance));
+
+        out.selected[count] = static_cast<std::uint32_t>(i);
+        count += !(static_cast<double>(confidence) < threshold);
+    }
+    return count;
+}
+
+#ifdef RADAR_KERNEL_X86
+
+__attribute__((target("avx2")))
+std::size_t runAvx2(const ThresholdKernelParams& p, const RadarFrameView& frame, double threshold,
+                    const KernelOutput& out) {
+    const std::size_t n = frame.size();
+    const std::size_t vec_end = n - n % 4;
+
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d scale = _mm256_set1_pd(p.range_scale);
+    const __m256d thr = _mm256_set1_pd(threshold);
+    const __m256d r_critical = _mm256_set1_pd(p.critical_range);
+    const __m256d r_high = _mm256_set1_pd(p.high_range);
+    const __m256d v_critical = _mm256_set1_pd(p.critical_speed);
+    const __m256d v_medium = _mm256_set1_pd(p.medium_speed);
+    const __m256d lvl_medium = _mm256_set1_pd(1.0);
+    const __m256d lvl_high = _mm256_set1_pd(2.0);
+    const __m256d lvl_critical = _mm256_set1_pd(3.0);
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < vec_end; i += 4) {
+        const __m256d x = _mm256_loadu_pd(frame.x.data() + i);
+        const __m256d y = _mm256_loadu_pd(frame.y.data() + i);
+        const __m256d z = _mm256_loadu_pd(frame.z.data() + i);
+        const __m256d v = _mm256_andnot_pd(sign_mask, _mm256_loadu_pd(frame.velocity.data() + i));
+
+        const __m256d sq = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)),
+                                         _mm256_mul_pd(z, z));
+        const __m256d distance = _mm256_sqrt_pd(sq);
+        const __m256d confidence = _mm256_div_pd(one, _mm256_add_pd(one, _mm256_mul_pd(distance, scale)));
+
+        __m256d level = _mm256_and_pd(_mm256_cmp_pd(v, v_medium, _CMP_GT_OQ), lvl_medium);
+        level = _mm256_blendv_pd(level, lvl_high, _mm256_cmp_pd(distance, r_high, _CMP_LT_OQ));
+        const __m256d critical = _mm256_and_pd(_mm256_cmp_pd(distance, r_critical, _CMP_LT_OQ),
+                                               _mm256_cmp_pd(v, v_critical, _CMP_GT_OQ));
+        level = _mm256_blendv_pd(level, lvl_critical, critical);
+
+        _mm256_storeu_pd(out.range.data() + i, distance);
+        _mm256_storeu_pd(out.confidence.data() + i, confidence);
+
+        __m128i lanes = _mm256_cvttpd_epi32(level);
+        lanes = _mm_packus_epi16(_mm_packus_epi32(lanes, lanes), lanes);
+        const std::uint32_t packed = static_cast<std::uint32_t>(_mm_cvtsi128_si32(lanes));
+        std::memcpy(out.threat.data() + i, &packed, sizeof(packed));
+
+        // NLT_UQ keeps NaN confidences, matching the scalar `confidence < threshold` reject.
+        const unsigned keep = static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_cmp_pd(confidence, thr, _CMP_NLT_UQ)));
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            out.selected[count] = static_cast<std::uint32_t>(i + lane);
+            count += (keep >> lane) & 1u;
+        }
+    }
+    return runScalar(p, frame, vec_end, threshold, out, count);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12's AVX-512 headers pass _mm512_undefined_* as the merge source of
+// the unmasked intrinsics and then flag it as maybe-uninitialised.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f")))
+std::size_t runAvx512(const ThresholdKernelParams& p, const RadarFrameView& frame, double threshold,
+                      const KernelOutput& out) {
+    const std::size_t n = frame.size();
+    const std::size_t vec_end = n - n % 8;
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d scale = _mm512_set1_pd(p.range_scale);
+    const __m512d thr = _mm512_set1_pd(threshold);
+    const __m512d r_critical = _mm512_set1_pd(p.critical_range);
+    const __m512d r_high = _mm512_set1_pd(p.high_range);
+    const __m512d v_critical = _mm512_set1_pd(p.critical_speed);
+    const __m512d v_medium = _mm512_set1_pd(p.medium_speed);
+    const __m512i lvl_low = _mm512_set1_epi64(0);
+    const __m512i lvl_medium = _mm512_set1_epi64(1);
+    const __m512i lvl_high = _mm512_set1_epi64(2);
+    const __m512i lvl_critical = _mm512_set1_epi64(3);
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < vec_end; i += 8) {
+        const __m512d x = _mm512_loadu_pd(frame.x.data() + i);
+        const __m512d y = _mm512_loadu_pd(frame.y.data() + i);
+        const __m512d z = _mm512_loadu_pd(frame.z.data() + i);
+        const __m512d v = _mm512_abs_pd(_mm512_loadu_pd(frame.velocity.data() + i));
+
+        const __m512d sq = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(x, x), _mm512_mul_pd(y, y)),
+                                         _mm512_mul_pd(z, z));
+        const __m512d distance = _mm512_sqrt_pd(sq);
+        const __m512d confidence = _mm512_div_pd(one, _mm512_add_pd(one, _mm512_mul_pd(distance, scale)));
+
+        const __mmask8 medium = _mm512_cmp_pd_mask(v, v_medium, _CMP_GT_OQ);
+        const __mmask8 high = _mm512_cmp_pd_mask(distance, r_high, _CMP_LT_OQ);
+        const __mmask8 critical = _mm512_cmp_pd_mask(distance, r_critical, _CMP_LT_OQ)
+                                & _mm512_cmp_pd_mask(v, v_critical, _CMP_GT_OQ);
+        __m512i level = _mm512_mask_blend_epi64(medium, lvl_low, lvl_medium);
+        level = _mm512_mask_blend_epi64(high, level, lvl_high);
+        level = _mm512_mask_blend_epi64(critical, level, lvl_critical);
+
+        _mm512_storeu_pd(out.range.data() + i, distance);
+        _mm512_storeu_pd(out.confidence.data() + i, confidence);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out.threat.data() + i), _mm512_cvtepi64_epi8(level));
+
+        const unsigned keep = _mm512_cmp_pd_mask(confidence, thr, _CMP_NLT_UQ);
+        for (unsigned lane = 0; lane < 8; ++lane) {
+            out.selected[count] = static_cast<std::uint32_t>(i + lane);
+            count += (keep >> lane) & 1u;
+        }
+    }
+    return runScalar(p, frame, vec_end, threshold, out, count);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+__attribute__((target("avx2")))
+__m256 loadFloat8(const double* column) noexcept {
+    return _mm256_set_m128(_mm256_cvtpd_ps(_mm256_loadu_pd(column + 4)),
+                           _mm256_cvtpd_ps(_mm256_loadu_pd(column)));
+}
+
+__attribute__((target("avx2")))
+void storeDouble8(double* column, __m256 value) noexcept {
+    _mm256_storeu_pd(column, _mm256_cvtps_pd(_mm256_castps256_ps128(value)));
+    _mm256_storeu_pd(column + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(value, 1)));
+}
+
+__attribute__((target("avx2")))
+std::size_t runAvx2F32(const FloatParams& p, const RadarFrameView& frame, double threshold,
+                       const KernelOutput& out) {
+    const std::size_t n = frame.size();
+    const std::size_t vec_end = n - n % 8;
+
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(p.range_scale);
+    const __m256d thr = _mm256_set1_pd(threshold);
+    const __m256 r_critical = _mm256_set1_ps(p.critical_range);
+    const __m256 r_high = _mm256_set1_ps(p.high_range);
+    const __m256 v_critical = _mm256_set1_ps(p.critical_speed);
+    const __m256 v_medium = _mm256_set1_ps(p.medium_speed);
+    const __m256i lvl_medium = _mm256_set1_epi32(1);
+    const __m256i lvl_high = _mm256_set1_epi32(2);
+    const __m256i lvl_critical = _mm256_set1_epi32(3);
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < vec_end; i += 8) {
+        const __m256 x = loadFloat8(frame.x.data() + i);
+        const __m256 y = loadFloat8(frame.y.data() + i);
+        const __m256 z = loadFloat8(frame.z.data() + i);
+        const __m256 v = _mm256_andnot_ps(sign_mask, loadFloat8(frame.velocity.data() + i));
+
+        const __m256 sq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)),
+                                        _mm256_mul_ps(z, z));
+        const __m256 distance = _mm256_sqrt_ps(sq);
+        const __m256 confidence = _mm256_div_ps(one, _mm256_add_ps(one, _mm256_mul_ps(distance, scale)));
+
+        __m256i level = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(v, v_medium, _CMP_GT_OQ)), lvl_medium);
+        level = _mm256_blendv_epi8(level, lvl_high, _mm256_castps_si256(_mm256_cmp_ps(distance, r_high, _CMP_LT_OQ)));
+        const __m256 critical = _mm256_and_ps(_mm256_cmp_ps(distance, r_critical, _CMP_LT_OQ),
+                                              _mm256_cmp_ps(v, v_critical, _CMP_GT_OQ));
+        level = _mm256_blendv_epi8(level, lvl_critical, _mm256_castps_si256(critical));
+
+        storeDouble8(out.range.data() + i, distance);
+        storeDouble8(out.confidence.data() + i, confidence);
+
+        __m128i lanes = _mm_packus_epi32(_mm256_castsi256_si128(level), _mm256_extracti128_si256(level, 1));
+        lanes = _mm_packus_epi16(lanes, lanes);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out.threat.data() + i), lanes);
+
+        const __m256d conf_lo = _mm256_loadu_pd(out.confidence.data() + i);
+        const __m256d conf_hi = _mm256_loadu_pd(out.confidence.data() + i + 4);
+        const unsigned keep = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(conf_lo, thr, _CMP_NLT_UQ)))
+                            | static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(conf_hi, thr, _CMP_NLT_UQ))) << 4;
+        for (unsigned lane = 0; lane < 8; ++lane) {
+            out.selected[count] = static_cast<std::uint32_t>(i + lane);
+            count += (keep >> lane) & 1u;
+        }
+    }
+    return runScalarF32(p, frame, vec_end, threshold, out, count);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f")))
+__m512 loadFloat16(const double* column) noexcept {
+    const __m256 lo = _mm512_cvtpd_ps(_mm512_loadu_pd(column));
+    const __m256 hi = _mm512_cvtpd_ps(_mm512_loadu_pd(column + 8));
+    return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(lo)),
+                                               _mm256_castps_pd(hi), 1));
+}
+
+__attribute__((target("avx512f")))
+__m256 upperHalf(__m512 value) noexcept {
+    return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(value), 1));
+}
+
+__attribute__((target("avx512f")))
+std::size_t runAvx512F32(const FloatParams& p, const RadarFrameView& frame, double threshold,
+                         const KernelOutput& out) {
+    const std::size_t n = frame.size();
+    const std::size_t vec_end = n - n % 16;
+
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 scale = _mm512_set1_ps(p.range_scale);
+    const __m512d thr = _mm512_set1_pd(threshold);
+    const __m512 r_critical = _mm512_set1_ps(p.critical_range);
+    const __m512 r_high = _mm512_set1_ps(p.high_range);
+    const __m512 v_critical = _mm512_set1_ps(p.critical_speed);
+    const __m512 v_medium = _mm512_set1_ps(p.medium_speed);
+    const __m512i lvl_low = _mm512_set1_epi32(0);
+    const __m512i lvl_medium = _mm512_set1_epi32(1);
+    const __m512i lvl_high = _mm512_set1_epi32(2);
+    const __m512i lvl_critical = _mm512_set1_epi32(3);
+    const __m512i lane_index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < vec_end; i += 16) {
+        const __m512 x = loadFloat16(frame.x.data() + i);
+        const __m512 y = loadFloat16(frame.y.data() + i);
+        const __m512 z = loadFloat16(frame.z.data() + i);
+        const __m512 v = _mm512_abs_ps(loadFloat16(frame.velocity.data() + i));
+
+        const __m512 sq = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(x, x), _mm512_mul_ps(y, y)),
+                                        _mm512_mul_ps(z, z));
+        const __m512 distance = _mm512_sqrt_ps(sq);
+        const __m512 confidence = _mm512_div_ps(one, _mm512_add_ps(one, _mm512_mul_ps(distance, scale)));
+
+        const __mmask16 medium = _mm512_cmp_ps_mask(v, v_medium, _CMP_GT_OQ);
+        const __mmask16 high = _mm512_cmp_ps_mask(distance, r_high, _CMP_LT_OQ);
+        const __mmask16 critical = _mm512_cmp_ps_mask(distance, r_critical, _CMP_LT_OQ)
+                                 & _mm512_cmp_ps_mask(v, v_critical, _CMP_GT_OQ);
+        __m512i level = _mm512_mask_blend_epi32(medium, lvl_low, lvl_medium);
+        level = _mm512_mask_blend_epi32(high, level, lvl_high);
+        level = _mm512_mask_blend_epi32(critical, level, lvl_critical);
+
+        const __m512d conf_lo = _mm512_cvtps_pd(_mm512_castps512_ps256(confidence));
+        const __m512d conf_hi = _mm512_cvtps_pd(upperHalf(confidence));
+        _mm512_storeu_pd(out.range.data() + i, _mm512_cvtps_pd(_mm512_castps512_ps256(distance)));
+        _mm512_storeu_pd(out.range.data() + i + 8, _mm512_cvtps_pd(upperHalf(distance)));
+        _mm512_storeu_pd(out.confidence.data() + i, conf_lo);
+        _mm512_storeu_pd(out.confidence.data() + i + 8, conf_hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.threat.data() + i), _mm512_cvtepi32_epi8(level));
+
+        const unsigned keep = static_cast<unsigned>(_mm512_cmp_pd_mask(conf_lo, thr, _CMP_NLT_UQ))
+                            | static_cast<unsigned>(_mm512_cmp_pd_mask(conf_hi, thr, _CMP_NLT_UQ)) << 8;
+        _mm512_mask_compressstoreu_epi32(out.selected.data() + count, static_cast<__mmask16>(keep),
+            _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(i)), lane_index));
+        count += static_cast<std::size_t>(__builtin_popcount(keep));
+    }
+    return runScalarF32(p, frame, vec_end, threshold, out, count);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+KernelBackend detectBackend() noexcept {
+#ifdef RADAR_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return KernelBackend::AVX512;
+    if (__builtin_cpu_supports("avx2")) return KernelBackend::AVX2;
+#endif
+    return KernelBackend::Scalar;
+}
+
+} // namespace
+
+KernelBackend KernelDispatch::activeBackend() noexcept {
+    static const KernelBackend backend = detectBackend();
+    return backend;
+}
+
+bool KernelDispatch::isSupported(KernelBackend backend) noexcept {
+    return static_cast<int>(backend) <= static_cast<int>(activeBackend());
+}
+
+std::string_view KernelDispatch::backendName(KernelBackend backend) noexcept {
+    switch (backend) {
+        case KernelBackend::Scalar: return "scalar";
+        case KernelBackend::AVX2:   return "avx2";
+        case KernelBackend::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+std::string_view KernelDispatch::precisionName(KernelPrecision precision) noexcept {
+    switch (precision) {
+        case KernelPrecision::Float64: return "f64";
+        case KernelPrecision::Float32: return "f32";
+    }
+    return "unknown";
+}
+
+std::size_t KernelDispatch::runThreshold(KernelBackend backend, const ThresholdKernelParams& params,
+                                         const RadarFrameView& frame, double confidence_threshold,
+                                         const KernelOutput& out, KernelPrecision precision) {
+    if (!isSupported(backend)) backend = activeBackend();
+
+    if (precision == KernelPrecision::Float32) {
+        const FloatParams single(params);
+        switch (backend) {
+#ifdef RADAR_KERNEL_X86
+            case KernelBackend::AVX512: return runAvx512F32(single, frame, confidence_threshold, out);
+            case KernelBackend::AVX2:   return runAvx2F32(single, frame, confidence_threshold, out);
+#endif
+            default:                    return runScalarF32(single, frame, 0, confidence_threshold, out, 0);
+        }
+    }
+
+    switch (backend) {
+#ifdef RADAR_KERNEL_X86
+        case KernelBackend::AVX512: return runAvx512(params, frame, confidence_threshold, out);
+        case KernelBackend::AVX2:   return runAvx2(params, frame, confidence_threshold, out);
+#endif
+        default:                    return runScalar(params, frame, 0, confidence_threshold, out, 0);
+    }
+}
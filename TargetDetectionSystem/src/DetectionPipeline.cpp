@@ -0,0 +1,236 @@
+#include "DetectionPipeline.h"
+#include <algorithm>
+#include "Instrumentation.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+std::size_t slotCount(std::size_t depth) {
+    // One slot in flight at each end of the queue on top of the queue depth.
+    return std::max<std::size_t>(depth, 1) + 2;
+}
+
+const std::atomic<bool> kNeverAbort{false};
+
+} // namespace
+
+void DetectionPipeline::StageCounters::record(std::chrono::nanoseconds elapsed) {
+    const auto ns = static_cast<std::uint64_t>(elapsed.count() > 0 ? elapsed.count() : 0);
+    count.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(ns, std::memory_order_relaxed);
+    std::uint64_t current = max_ns.load(std::memory_order_relaxed);
+    while (ns > current && !max_ns.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {
+    }
+}
+
+StageTiming DetectionPipeline::StageCounters::snapshot() const {
+    StageTiming timing;
+    timing.count = count.load(std::memory_order_relaxed);
+    const auto total = total_ns.load(std::memory_order_relaxed);
+    timing.mean_us = timing.count ? static_cast<double>(total) / static_cast<double>(timing.count) / 1000.0 : 0.0;
+    timing.max_us = static_cast<double>(max_ns.load(std::memory_order_relaxed)) / 1000.0;
+    return timing;
+}
+
+DetectionPipeline::DetectionPipeline(TargetDetector& detector, PipelineConfig config)
+    : detector_(detector),
+      config_(config),
+      frames_(slotCount(config.frame_queue_depth)),
+      results_(slotCount(config.result_queue_depth)),
+      free_frames_(frames_.size()),
+      ready_frames_(frames_.size()),
+      free_results_(results_.size()),
+      ready_results_(results_.size()) {
+    for (FrameSlot& entry : frames_) {
+        entry.arena = std::make_unique<ScanArena>(config_.frame_arena_bytes);
+    }
+    for (std::uint32_t i = 0; i < frames_.size(); ++i) free_frames_.tryPush(i);
+    for (std::uint32_t i = 0; i < results_.size(); ++i) free_results_.tryPush(i);
+}
+
+DetectionPipeline::~DetectionPipeline() {
+    stop();
+}
+
+void DetectionPipeline::start(FrameSource source, ResultSink sink) {
+    if (running_.exchange(true, std::memory_order_acq_rel)) return;
+    source_ = std::move(source);
+    launch(std::move(sink));
+    producer_thread_ = std::thread(&DetectionPipeline::producerLoop, this);
+}
+
+void DetectionPipeline::start(ResultSink sink) {
+    if (running_.exchange(true, std::memory_order_acq_rel)) return;
+    source_ = nullptr;
+    launch(std::move(sink));
+}
+
+void DetectionPipeline::launch(ResultSink sink) {
+    sink_ = std::move(sink);
+    next_sequence_ = 0;
+    stop_requested_.store(false, std::memory_order_relaxed);
+    producer_done_.store(false, std::memory_order_relaxed);
+    detector_done_.store(false, std::memory_order_relaxed);
+
+    output_thread_ = std::thread(&DetectionPipeline::outputLoop, this);
+    detector_thread_ = std::thread(&DetectionPipeline::detectorLoop, this);
+}
+
+void DetectionPipeline::stop() {
+    stop_requested_.store(true, std::memory_order_release);
+    // A pushed stream has no producer thread to notice the request.
+    if (running_.load(std::memory_order_acquire) && !source_) finish();
+    wait();
+}
+
+void DetectionPipeline::wait() {
+    for (auto* thread : {&producer_thread_, &detector_thread_, &output_thread_}) {
+        if (thread->joinable()) thread->join();
+    }
+    running_.store(false, std::memory_order_release);
+}
+
+PipelineStats DetectionPipeline::stats() const {
+    PipelineStats stats;
+    stats.ingest = ingest_.snapshot();
+    stats.detect = detect_.snapshot();
+    stats.output = output_.snapshot();
+    stats.end_to_end = end_to_end_.snapshot();
+    stats.frame_queue_depth = ready_frames_.size();
+    stats.result_queue_depth = ready_results_.size();
+    stats.frames_dropped = frames_dropped_.load(std::memory_order_relaxed);
+    stats.results_dropped = results_dropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool DetectionPipeline::acquireSlot(RingBuffer<std::uint32_t>& free_slots, RingBuffer<std::uint32_t>& ready_slots,
+                                    BackpressurePolicy policy, std::atomic<std::uint64_t>& drops,
+                                    const std::atomic<bool>& abort, std::uint32_t& slot) {
+    Backoff backoff;
+    for (;;) {
+        if (free_slots.tryPop(slot)) return true;
+        if (policy == BackpressurePolicy::DropOldest && ready_slots.tryPop(slot)) {
+            drops.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (abort.load(std::memory_order_acquire)) return false;
+        backoff.pause();
+    }
+}
+
+bool DetectionPipeline::submit(const FrameSource& fill) {
+    if (stop_requested_.load(std::memory_order_acquire)) return false;
+    std::uint32_t slot = 0;
+    if (!acquireSlot(free_frames_, ready_frames_, config_.frame_policy, frames_dropped_,
+                     stop_requested_, slot)) {
+        return false;
+    }
+
+    FrameSlot& entry = frames_[slot];
+    const auto begin = std::chrono::steady_clock::now();
+    // The last scan of this slot is done with, so its arena starts over.
+    entry.frame.reset();
+    entry.arena->reset();
+    entry.frame.emplace(RadarFrame::allocator_type(entry.arena.get()));
+    const bool more = fill(*entry.frame);
+    const auto end = std::chrono::steady_clock::now();
+    Instrumentation::record(Stage::Ingest, end - begin);
+    if (!more) {
+        free_frames_.tryPush(slot);
+        return false;
+    }
+
+    ingest_.record(end - begin);
+    entry.sequence = next_sequence_++;
+    entry.ingested_at = end;
+    // Rings are sized to the slot count, so this cannot fail.
+    ready_frames_.tryPush(slot);
+    return true;
+}
+
+void DetectionPipeline::producerLoop() {
+    pinCurrentThread(config_.producer_cpu);
+    while (submit(source_)) {
+    }
+    finish();
+}
+
+void DetectionPipeline::detectorLoop() {
+    pinCurrentThread(config_.detector_cpu);
+
+    Backoff backoff;
+    for (;;) {
+        const bool producer_done = producer_done_.load(std::memory_order_acquire);
+        std::uint32_t slot = 0;
+        if (!ready_frames_.tryPop(slot)) {
+            if (producer_done) break;
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+
+        std::uint32_t result_slot = 0;
+        acquireSlot(free_results_, ready_results_, config_.result_policy, results_dropped_,
+                    kNeverAbort, result_slot);
+
+        FrameSlot& entry = frames_[slot];
+        ScanResult& result = results_[result_slot];
+        const auto begin = std::chrono::steady_clock::now();
+        detector_.scan(*entry.frame, result.targets);
+        result.stats = detector_.getStats();
+        if (tracker_) {
+            tracker_->update(result.targets, result.targets.empty()
+                ? std::chrono::system_clock::now() : result.targets.front().detection_time);
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        detect_.record(end - begin);
+        result.sequence = entry.sequence;
+        result.raw_count = entry.frame->size();
+        result.ingested_at = entry.ingested_at;
+        result.detect_ms = std::chrono::duration<double, std::milli>(end - begin).count();
+
+        free_frames_.tryPush(slot);
+        ready_results_.tryPush(result_slot);
+    }
+    detector_done_.store(true, std::memory_order_release);
+}
+
+void DetectionPipeline::outputLoop() {
+    pinCurrentThread(config_.output_cpu);
+
+    Backoff backoff;
+    for (;;) {
+        const bool detector_done = detector_done_.load(std::memory_order_acquire);
+        std::uint32_t slot = 0;
+        if (!ready_results_.tryPop(slot)) {
+            if (detector_done) break;
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+
+        const ScanResult& result = results_[slot];
+        const auto begin = std::chrono::steady_clock::now();
+        sink_(result);
+        const auto end = std::chrono::steady_clock::now();
+
+        output_.record(end - begin);
+        end_to_end_.record(end - result.ingested_at);
+        free_results_.tryPush(slot);
+    }
+}
+
+void DetectionPipeline::pinCurrentThread(int cpu) {
+    if (cpu < 0) return;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
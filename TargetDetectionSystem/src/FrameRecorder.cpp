@@ -0,0 +1,65 @@
+#include "FrameRecorder.h"
+#include <cstring>
+
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+bool FrameRecorder::open(const std::string& path) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+
+    offset_ = 0;
+    offsets_.clear();
+    failed_ = false;
+
+    // Placeholder header; close() rewrites it with the final counts.
+    RecordingHeader header{};
+    std::memcpy(header.magic, kRecordingMagic, sizeof(header.magic));
+    header.version = kRecordingVersion;
+    header.header_bytes = sizeof(RecordingHeader);
+    return put(&header, sizeof(header));
+}
+
+bool FrameRecorder::write(const RadarFrameView& frame, std::chrono::system_clock::time_point stamp) {
+    if (!file_ || failed_) return false;
+
+    const std::size_t count = frame.size();
+    const FrameRecordHeader record{kFrameMagic, static_cast<std::uint32_t>(count), toStampNs(stamp)};
+    const std::uint64_t start = offset_;
+    const bool ok = put(&record, sizeof(record))
+        && put(frame.x.data(), count * sizeof(double))
+        && put(frame.y.data(), count * sizeof(double))
+        && put(frame.z.data(), count * sizeof(double))
+        && put(frame.velocity.data(), count * sizeof(double));
+    if (ok) offsets_.push_back(start);
+    return ok;
+}
+
+bool FrameRecorder::close() {
+    if (!file_) return false;
+
+    RecordingHeader header{};
+    std::memcpy(header.magic, kRecordingMagic, sizeof(header.magic));
+    header.version = kRecordingVersion;
+    header.header_bytes = sizeof(RecordingHeader);
+    header.frame_count = offsets_.size();
+    header.index_offset = offset_;
+
+    bool ok = !failed_ && put(offsets_.data(), offsets_.size() * sizeof(std::uint64_t));
+    ok = ok && std::fseek(file_, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    return ok;
+}
+
+bool FrameRecorder::put(const void* data, std::size_t bytes) {
+    if (bytes == 0) return true;
+    if (std::fwrite(data, 1, bytes, file_) != bytes) {
+        failed_ = true;
+        return false;
+    }
+    offset_ += bytes;
+    return true;
+}
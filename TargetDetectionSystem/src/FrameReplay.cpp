@@ -0,0 +1,208 @@
+#include "FrameReplay.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FrameReplay::FrameReplay(ReplayMode mode)
+    : mode_(mode) {}
+
+FrameReplay::~FrameReplay() {
+    close();
+}
+
+bool FrameReplay::open(const std::string& path) {
+    close();
+    if (!map(path)) return false;
+    if (!loadIndex()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void FrameReplay::close() {
+    unmap();
+    offsets_.clear();
+    cursor_ = 0;
+    pacing_started_ = false;
+}
+
+bool FrameReplay::seek(std::size_t frame_index) {
+    if (frame_index > offsets_.size()) return false;
+    cursor_ = frame_index;
+    pacing_started_ = false;
+    return true;
+}
+
+bool FrameReplay::seekTime(std::chrono::system_clock::time_point stamp) {
+    const std::int64_t target = toStampNs(stamp);
+    const auto it = std::ranges::partition_point(offsets_, [&](std::uint64_t offset) {
+        return recordAt(offset).stamp_ns < target;
+    });
+    return seek(static_cast<std::size_t>(it - offsets_.begin()));
+}
+
+std::optional<ReplayFrame> FrameReplay::next() {
+    if (cursor_ >= offsets_.size()) return std::nullopt;
+    ReplayFrame out = frame(cursor_++);
+    if (mode_ == ReplayMode::RealTime) pace(toStampNs(out.stamp));
+    return out;
+}
+
+ReplayFrame FrameReplay::frame(std::size_t frame_index) const {
+    const std::uint64_t offset = offsets_[frame_index];
+    const FrameRecordHeader& record = recordAt(offset);
+    const std::size_t count = record.count;
+    const auto* columns = reinterpret_cast<const double*>(data_ + offset + sizeof(FrameRecordHeader));
+
+    ReplayFrame out;
+    out.index = frame_index;
+    out.stamp = fromStampNs(record.stamp_ns);
+    out.view = {{columns, count}, {columns + count, count},
+                {columns + 2 * count, count}, {columns + 3 * count, count}};
+    return out;
+}
+
+bool FrameReplay::fill(RadarFrame& frame) {
+    const auto next_frame = next();
+    if (!next_frame) return false;
+    const RadarFrameView& view = next_frame->view;
+    frame.x.assign(view.x.begin(), view.x.end());
+    frame.y.assign(view.y.begin(), view.y.end());
+    frame.z.assign(view.z.begin(), view.z.end());
+    frame.velocity.assign(view.velocity.begin(), view.velocity.end());
+    return true;
+}
+
+void FrameReplay::pace(std::int64_t stamp_ns) {
+    if (!pacing_started_) {
+        pacing_started_ = true;
+        pace_origin_ = std::chrono::steady_clock::now();
+        pace_stamp_ns_ = stamp_ns;
+        return;
+    }
+    const double offset_ns = static_cast<double>(stamp_ns - pace_stamp_ns_) / speed_;
+    const auto due = pace_origin_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::nano>(std::max(offset_ns, 0.0)));
+    std::this_thread::sleep_until(due);
+}
+
+const FrameRecordHeader& FrameReplay::recordAt(std::uint64_t offset) const noexcept {
+    return *reinterpret_cast<const FrameRecordHeader*>(data_ + offset);
+}
+
+bool FrameReplay::validRecord(std::uint64_t offset) const noexcept {
+    if (offset % alignof(double) != 0 || offset > size_ || size_ - offset < sizeof(FrameRecordHeader)) {
+        return false;
+    }
+    const FrameRecordHeader& record = recordAt(offset);
+    return record.magic == kFrameMagic && frameRecordBytes(record.count) <= size_ - offset;
+}
+
+bool FrameReplay::loadIndex() {
+    if (size_ < sizeof(RecordingHeader)) return false;
+    RecordingHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, kRecordingMagic, sizeof(header.magic)) != 0
+        || header.version != kRecordingVersion || header.header_bytes != sizeof(RecordingHeader)) {
+        return false;
+    }
+
+    // Trust a finished file's index only if it fits and every entry checks
+    // out. The count is bounded before it is scaled, so a corrupt one
+    // cannot wrap the size check.
+    if (header.index_offset != 0 && header.index_offset <= size_
+        && header.frame_count <= (size_ - header.index_offset) / sizeof(std::uint64_t)) {
+        const std::uint64_t index_bytes = header.frame_count * sizeof(std::uint64_t);
+        offsets_.resize(header.frame_count);
+        if (!offsets_.empty()) {
+            std::memcpy(offsets_.data(), data_ + header.index_offset, index_bytes);
+        }
+        if (std::ranges::all_of(offsets_, [&](std::uint64_t offset) { return validRecord(offset); })) {
+            return true;
+        }
+    }
+
+    // Unfinished recording: walk frames until the data runs out.
+    offsets_.clear();
+    std::uint64_t offset = sizeof(RecordingHeader);
+    while (validRecord(offset)) {
+        offsets_.push_back(offset);
+        offset += frameRecordBytes(recordAt(offset).count);
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
+bool FrameReplay::map(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<const std::byte*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    return true;
+}
+
+void FrameReplay::unmap() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(mapping_handle_);
+    if (file_handle_) CloseHandle(file_handle_);
+    data_ = nullptr;
+    size_ = 0;
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+}
+
+#else
+
+bool FrameReplay::map(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file referenced once established.
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    ::madvise(view, size, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const std::byte*>(view);
+    size_ = size;
+    return true;
+}
+
+void FrameReplay::unmap() {
+    if (data_) ::munmap(const_cast<std::byte*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#include "FusionEngine.h"
+#include <algorithm>
+#include "Instrumentation.h"
+
+FusionEngine::Sensor::Sensor(SensorSpec sensor_spec)
+    : spec(std::move(sensor_spec)),
+      detector(spec.confidence_threshold) {
+    // Fusion orders nothing itself; the tracker consumes detections as is.
+    detector.setOrdering(TargetOrdering::None);
+}
+
+FusionEngine::FusionEngine(std::chrono::milliseconds window, TrackerConfig tracker)
+    : window_(std::max(window, std::chrono::milliseconds(1))),
+      tracker_(tracker) {}
+
+std::size_t FusionEngine::addSensor(SensorSpec spec) {
+    auto sensor = std::make_unique<Sensor>(std::move(spec));
+    sensor->description = descriptions_.intern(sensor->spec.name);
+    sensors_.push_back(std::move(sensor));
+    return sensors_.size() - 1;
+}
+
+bool FusionEngine::submit(std::size_t sensor_index, std::chrono::system_clock::time_point stamp,
+                          const RadarFrameView& frame) {
+    Sensor& sensor = *sensors_[sensor_index];
+    if (!has_epoch_) {
+        has_epoch_ = true;
+        epoch_ = stamp;
+        fused_until_ = stamp;
+    }
+    const bool out_of_order = stamp < sensor.last_stamp;
+    if (stamp < fused_until_ || out_of_order) {
+        ++late_reports_;
+        return false;
+    }
+
+    RadarFrame& pending = sensor.pending;
+    pending.x.insert(pending.x.end(), frame.x.begin(), frame.x.end());
+    pending.y.insert(pending.y.end(), frame.y.begin(), frame.y.end());
+    pending.z.insert(pending.z.end(), frame.z.begin(), frame.z.end());
+    pending.velocity.insert(pending.velocity.end(), frame.velocity.begin(), frame.velocity.end());
+    sensor.reports.push_back({stamp, pending.size()});
+    sensor.last_stamp = stamp;
+    return true;
+}
+
+std::size_t FusionEngine::fuse(std::chrono::system_clock::time_point until, const WindowSink& on_window) {
+    std::size_t fused = 0;
+    std::chrono::system_clock::time_point start;
+    while (nextWindow(start)) {
+        const auto end = start + window_;
+        if (end > until) break;
+        fuseWindow(start, end);
+        fused_until_ = end;
+        ++fused;
+        if (on_window) on_window(last_window_);
+    }
+    for (auto& sensor : sensors_) compact(*sensor);
+    return fused;
+}
+
+bool FusionEngine::nextWindow(std::chrono::system_clock::time_point& start) const {
+    bool found = false;
+    std::chrono::system_clock::time_point earliest{};
+    for (const auto& sensor : sensors_) {
+        if (sensor->consumed_reports == sensor->reports.size()) continue;
+        const auto stamp = sensor->reports[sensor->consumed_reports].stamp;
+        if (!found || stamp < earliest) earliest = stamp;
+        found = true;
+    }
+    if (!found) return false;
+
+    // Windows sit on a fixed grid anchored at the first report, so empty
+    // stretches are skipped without shifting later windows.
+    start = epoch_ + ((earliest - epoch_) / window_) * window_;
+    return true;
+}
+
+void FusionEngine::fuseWindow(std::chrono::system_clock::time_point start,
+                              std::chrono::system_clock::time_point end) {
+    active_.clear();
+    auto aligned = start;
+    for (auto& owned : sensors_) {
+        Sensor& sensor = *owned;
+        std::size_t last = sensor.consumed_reports;
+        while (last < sensor.reports.size() && sensor.reports[last].stamp < end) ++last;
+        sensor.window_reports = last - sensor.consumed_reports;
+        if (sensor.window_reports == 0) continue;
+
+        sensor.window_points = sensor.reports[last - 1].end - sensor.consumed_points;
+        aligned = std::max(aligned, sensor.reports[last - 1].stamp);
+        active_.push_back(&sensor);
+    }
+
+    // Per-sensor detection is independent, so it fans out across the pool.
+    const auto detect = [this](std::size_t i) {
+        Sensor& sensor = *active_[i];
+        sensor.detector.scan(sensor.pending.view().subview(sensor.consumed_points, sensor.window_points),
+                             sensor.detections);
+    };
+    if (pool_ && active_.size() > 1) {
+        pool_->parallelFor(active_.size(), detect);
+    } else {
+        for (std::size_t i = 0; i < active_.size(); ++i) detect(i);
+    }
+
+    // One prediction per window; each sensor then corrects it with its own
+    // covariance, so no sensor's work is redone when another is added.
+    PROFILE_SCOPE(Stage::Track);
+    picture_.clear();
+    tracker_.beginScan(aligned);
+    for (Sensor* sensor : active_) {
+        for (auto& target : sensor->detections) {
+            target.detection_time = aligned;
+            target.description_id = sensor->description;
+        }
+        tracker_.correct(sensor->detections, sensor->spec.position_sigma);
+        picture_.insert(picture_.end(), sensor->detections.begin(), sensor->detections.end());
+
+        sensor->consumed_points += sensor->window_points;
+        sensor->consumed_reports += sensor->window_reports;
+    }
+    tracker_.endScan();
+
+    last_window_ = {start, end, active_.size(), picture_};
+}
+
+void FusionEngine::compact(Sensor& sensor) {
+    if (sensor.consumed_reports == 0) return;
+
+    RadarFrame& pending = sensor.pending;
+    const auto drop = static_cast<std::ptrdiff_t>(sensor.consumed_points);
+    for (auto* column : {&pending.x, &pending.y, &pending.z, &pending.velocity}) {
+        column->erase(column->begin(), column->begin() + drop);
+    }
+    sensor.reports.erase(sensor.reports.begin(),
+                         sensor.reports.begin() + static_cast<std::ptrdiff_t>(sensor.consumed_reports));
+    for (auto& report : sensor.reports) report.end -= sensor.consumed_points;
+
+    sensor.consumed_points = 0;
+    sensor.consumed_reports = 0;
+}
@@ -0,0 +1,140 @@
+#include "Instrumentation.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// One thread's probes. Only the owning thread writes; atomics make the
+// concurrent reads from snapshot() well defined.
+struct Shard {
+    std::array<std::array<std::atomic<std::uint64_t>, LatencyBuckets::kCount>, kStageCount> buckets{};
+    std::array<std::atomic<std::uint64_t>, kStageCount> sum_ns{};
+    std::array<std::atomic<std::uint64_t>, kStageCount> max_ns{};
+    std::array<std::atomic<std::uint64_t>, kCounterCount> counters{};
+};
+
+// Shards outlive their threads so totals never go backwards.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+Shard& localShard() {
+    thread_local Shard* shard = nullptr;
+    if (!shard) {
+        auto owned = std::make_unique<Shard>();
+        shard = owned.get();
+        Registry& reg = registry();
+        const std::lock_guard lock(reg.mutex);
+        reg.shards.push_back(std::move(owned));
+    }
+    return *shard;
+}
+
+void bump(std::atomic<std::uint64_t>& cell, std::uint64_t amount) noexcept {
+    cell.store(cell.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+double toMicros(std::uint64_t ns) {
+    return static_cast<double>(ns) / 1000.0;
+}
+
+} // namespace
+
+std::uint64_t HistogramSnapshot::percentileNs(double q) const noexcept {
+    if (count == 0) return 0;
+    const double clamped = std::clamp(q, 0.0, 1.0);
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(clamped * static_cast<double>(count) + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+        seen += buckets[b];
+        if (seen >= rank) return std::min(LatencyBuckets::upperBound(b), max_ns);
+    }
+    return max_ns;
+}
+
+void Instrumentation::record(Stage stage, std::chrono::nanoseconds elapsed) noexcept {
+    if constexpr (!kEnabled) return;
+    const auto s = static_cast<std::size_t>(stage);
+    const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(elapsed.count(), 0));
+    Shard& shard = localShard();
+    bump(shard.buckets[s][LatencyBuckets::index(ns)], 1);
+    bump(shard.sum_ns[s], ns);
+    if (ns > shard.max_ns[s].load(std::memory_order_relaxed)) {
+        shard.max_ns[s].store(ns, std::memory_order_relaxed);
+    }
+}
+
+void Instrumentation::count(Counter counter, std::uint64_t amount) noexcept {
+    if constexpr (!kEnabled) return;
+    bump(localShard().counters[static_cast<std::size_t>(counter)], amount);
+}
+
+HistogramSnapshot Instrumentation::snapshot(Stage stage) {
+    HistogramSnapshot out;
+    const auto s = static_cast<std::size_t>(stage);
+    Registry& reg = registry();
+    const std::lock_guard lock(reg.mutex);
+    for (const auto& shard : reg.shards) {
+        for (std::size_t b = 0; b < LatencyBuckets::kCount; ++b) {
+            const std::uint64_t n = shard->buckets[s][b].load(std::memory_order_relaxed);
+            out.buckets[b] += n;
+            out.count += n;
+        }
+        out.sum_ns += shard->sum_ns[s].load(std::memory_order_relaxed);
+        out.max_ns = std::max(out.max_ns, shard->max_ns[s].load(std::memory_order_relaxed));
+    }
+    return out;
+}
+
+LatencySummary Instrumentation::summary(Stage stage) {
+    const auto histogram = std::make_unique<HistogramSnapshot>(snapshot(stage));
+    LatencySummary out;
+    out.count = histogram->count;
+    out.mean_us = histogram->meanNs() / 1000.0;
+    out.p50_us = toMicros(histogram->percentileNs(0.50));
+    out.p99_us = toMicros(histogram->percentileNs(0.99));
+    out.p999_us = toMicros(histogram->percentileNs(0.999));
+    out.max_us = toMicros(histogram->max_ns);
+    return out;
+}
+
+std::uint64_t Instrumentation::counter(Counter counter) noexcept {
+    std::uint64_t total = 0;
+    Registry& reg = registry();
+    const std::lock_guard lock(reg.mutex);
+    for (const auto& shard : reg.shards) {
+        total += shard->counters[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+bool Instrumentation::writeJson(std::FILE* out) {
+    bool ok = std::fprintf(out, "{\"enabled\":%s,\"stages\":{", kEnabled ? "true" : "false") > 0;
+    for (std::size_t s = 0; s < kStageCount; ++s) {
+        const auto stage = static_cast<Stage>(s);
+        const LatencySummary sum = summary(stage);
+        ok = ok && std::fprintf(out,
+            "%s\"%.*s\":{\"count\":%llu,\"mean_us\":%.3f,\"p50_us\":%.3f,\"p99_us\":%.3f,"
+            "\"p999_us\":%.3f,\"max_us\":%.3f}",
+            s ? "," : "", static_cast<int>(stageName(stage).size()), stageName(stage).data(),
+            static_cast<unsigned long long>(sum.count), sum.mean_us, sum.p50_us, sum.p99_us,
+            sum.p999_us, sum.max_us) > 0;
+    }
+    ok = ok && std::fputs("},\"counters\":{", out) >= 0;
+    for (std::size_t c = 0; c < kCounterCount; ++c) {
+        const auto which = static_cast<Counter>(c);
+        ok = ok && std::fprintf(out, "%s\"%.*s\":%llu", c ? "," : "",
+                                static_cast<int>(counterName(which).size()), counterName(which).data(),
+                                static_cast<unsigned long long>(counter(which))) > 0;
+    }
+    ok = ok && std::fputs("}}\n", out) >= 0;
+    return ok;
+}
@@ -0,0 +1,282 @@
+#include "MetricsExporter.h"
+#include <algorithm>
+#include <array>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+#include "Instrumentation.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::array<std::string_view, kThreatLevels> kThreatLabels{"low", "medium", "high", "critical"};
+
+// Histogram bucket bounds for stage latencies, in nanoseconds; 1 us to 10 s.
+constexpr std::array<std::uint64_t, 22> kLatencyBoundsNs{
+    1'000, 2'500, 5'000, 10'000, 25'000, 50'000, 100'000, 250'000, 500'000,
+    1'000'000, 2'500'000, 5'000'000, 10'000'000, 25'000'000, 50'000'000,
+    100'000'000, 250'000'000, 500'000'000, 1'000'000'000, 2'500'000'000,
+    5'000'000'000, 10'000'000'000};
+
+// A scrape that has not sent its request line by then is dropped.
+constexpr int kClientTimeoutMs = 1000;
+constexpr std::size_t kMaxRequestBytes = 8192;
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((format(printf, 2, 3)))
+#endif
+void appendf(std::string& out, const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    const int written = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (written > 0) out.append(line, std::min<std::size_t>(static_cast<std::size_t>(written), sizeof(line) - 1));
+}
+
+void appendFamily(std::string& out, const char* name, const char* type, const char* help) {
+    appendf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+unsigned long long asULL(std::uint64_t value) {
+    return static_cast<unsigned long long>(value);
+}
+
+void appendStageHistograms(std::string& out) {
+    appendFamily(out, "radar_stage_latency_seconds", "histogram", "Wall time spent per pipeline stage.");
+    const auto histogram = std::make_unique<HistogramSnapshot>();
+    for (std::size_t s = 0; s < kStageCount; ++s) {
+        const auto stage = static_cast<Stage>(s);
+        const std::string_view name = stageName(stage);
+        *histogram = Instrumentation::snapshot(stage);
+
+        // A fine bucket is counted under the first bound at or above its
+        // upper edge, so a reported bucket can only overstate latency.
+        std::uint64_t cumulative = 0;
+        std::size_t bucket = 0;
+        for (const std::uint64_t bound : kLatencyBoundsNs) {
+            while (bucket < LatencyBuckets::kCount && LatencyBuckets::upperBound(bucket) <= bound) {
+                cumulative += histogram->buckets[bucket++];
+            }
+            appendf(out, "radar_stage_latency_seconds_bucket{stage=\"%.*s\",le=\"%g\"} %llu\n",
+                    static_cast<int>(name.size()), name.data(), static_cast<double>(bound) * 1e-9,
+                    asULL(cumulative));
+        }
+        appendf(out, "radar_stage_latency_seconds_bucket{stage=\"%.*s\",le=\"+Inf\"} %llu\n",
+                static_cast<int>(name.size()), name.data(), asULL(histogram->count));
+        appendf(out, "radar_stage_latency_seconds_sum{stage=\"%.*s\"} %.9f\n",
+                static_cast<int>(name.size()), name.data(), static_cast<double>(histogram->sum_ns) * 1e-9);
+        appendf(out, "radar_stage_latency_seconds_count{stage=\"%.*s\"} %llu\n",
+                static_cast<int>(name.size()), name.data(), asULL(histogram->count));
+    }
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(MetricsConfig config)
+    : config_(std::move(config)) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+void MetricsExporter::update(const DetectionStats& detection, const PipelineStats& pipeline,
+                             const UdpIngestStats* ingest) {
+    const auto now = std::chrono::steady_clock::now();
+    if (!rate_started_) {
+        rate_started_ = true;
+        rate_since_ = now;
+        rate_base_ = detection.total_detections;
+    }
+    const std::chrono::duration<double> elapsed = now - rate_since_;
+    if (elapsed >= std::chrono::seconds(1)) {
+        targets_per_second_ = static_cast<double>(detection.total_detections - rate_base_) / elapsed.count();
+        rate_since_ = now;
+        rate_base_ = detection.total_detections;
+    }
+
+    MetricsSnapshot& snapshot = snapshots_.writeBuffer();
+    snapshot.detection = detection;
+    snapshot.targets_per_second = targets_per_second_;
+    snapshot.pipeline = pipeline;
+    snapshot.has_ingest = ingest != nullptr;
+    snapshot.ingest = ingest ? *ingest : UdpIngestStats{};
+    snapshots_.publish();
+}
+
+void MetricsExporter::writeExposition(const MetricsSnapshot& snapshot, std::string& out) {
+    const DetectionStats& detection = snapshot.detection;
+    appendFamily(out, "radar_scans_total", "counter", "Detection scans completed.");
+    appendf(out, "radar_scans_total %llu\n", asULL(detection.scans));
+    appendFamily(out, "radar_targets_total", "counter", "Targets detected.");
+    appendf(out, "radar_targets_total %llu\n", asULL(detection.total_detections));
+    appendFamily(out, "radar_targets_per_second", "gauge", "Detection rate over the last second.");
+    appendf(out, "radar_targets_per_second %.3f\n", snapshot.targets_per_second);
+
+    appendFamily(out, "radar_threat_targets_total", "counter", "Targets detected per threat level.");
+    for (std::size_t level = 0; level < kThreatLevels; ++level) {
+        appendf(out, "radar_threat_targets_total{threat=\"%s\"} %llu\n",
+                kThreatLabels[level].data(), asULL(detection.total_threats[level]));
+    }
+    appendFamily(out, "radar_scan_targets", "gauge", "Targets per threat level in the latest scan.");
+    for (std::size_t level = 0; level < kThreatLevels; ++level) {
+        appendf(out, "radar_scan_targets{threat=\"%s\"} %llu\n",
+                kThreatLabels[level].data(), asULL(detection.last_threats[level]));
+    }
+
+    appendFamily(out, "radar_scan_confidence", "gauge", "Mean and standard deviation of confidence in the latest scan.");
+    appendf(out, "radar_scan_confidence{stat=\"mean\"} %.6f\n", detection.last_confidence.mean);
+    appendf(out, "radar_scan_confidence{stat=\"stddev\"} %.6f\n", detection.last_confidence.stddev());
+    appendFamily(out, "radar_scan_velocity_mps", "gauge", "Mean and standard deviation of radial velocity in the latest scan.");
+    appendf(out, "radar_scan_velocity_mps{stat=\"mean\"} %.3f\n", detection.last_velocity.mean);
+    appendf(out, "radar_scan_velocity_mps{stat=\"stddev\"} %.3f\n", detection.last_velocity.stddev());
+    appendFamily(out, "radar_detect_cycle_seconds", "gauge", "Detector cycle time, latest and moving average.");
+    appendf(out, "radar_detect_cycle_seconds{stat=\"last\"} %.9f\n", detection.last_cycle_ms * 1e-3);
+    appendf(out, "radar_detect_cycle_seconds{stat=\"ewma\"} %.9f\n", detection.cycle_ewma_ms * 1e-3);
+
+    const PipelineStats& pipeline = snapshot.pipeline;
+    appendFamily(out, "radar_queue_depth", "gauge", "Slots waiting in each pipeline queue.");
+    appendf(out, "radar_queue_depth{queue=\"frames\"} %zu\n", pipeline.frame_queue_depth);
+    appendf(out, "radar_queue_depth{queue=\"results\"} %zu\n", pipeline.result_queue_depth);
+    appendFamily(out, "radar_dropped_total", "counter", "Entries dropped by queue backpressure.");
+    appendf(out, "radar_dropped_total{queue=\"frames\"} %llu\n", asULL(pipeline.frames_dropped));
+    appendf(out, "radar_dropped_total{queue=\"results\"} %llu\n", asULL(pipeline.results_dropped));
+    appendFamily(out, "radar_end_to_end_latency_seconds", "gauge", "Ingest to output latency.");
+    appendf(out, "radar_end_to_end_latency_seconds{stat=\"mean\"} %.9f\n", pipeline.end_to_end.mean_us * 1e-6);
+    appendf(out, "radar_end_to_end_latency_seconds{stat=\"max\"} %.9f\n", pipeline.end_to_end.max_us * 1e-6);
+
+    if (snapshot.has_ingest) {
+        const UdpIngestStats& ingest = snapshot.ingest;
+        appendFamily(out, "radar_udp_packets_total", "counter", "Well-formed datagrams received.");
+        appendf(out, "radar_udp_packets_total %llu\n", asULL(ingest.packets));
+        appendFamily(out, "radar_udp_packets_lost_total", "counter", "Datagrams missing from the sequence.");
+        appendf(out, "radar_udp_packets_lost_total %llu\n", asULL(ingest.packets_lost));
+        appendFamily(out, "radar_udp_sequence_resyncs_total", "counter", "Sender sequence restarts.");
+        appendf(out, "radar_udp_sequence_resyncs_total %llu\n", asULL(ingest.sequence_resyncs));
+        appendFamily(out, "radar_udp_malformed_packets_total", "counter", "Datagrams rejected by validation.");
+        appendf(out, "radar_udp_malformed_packets_total %llu\n", asULL(ingest.malformed_packets));
+        appendFamily(out, "radar_udp_truncated_packets_total", "counter", "Datagrams longer than the receive buffer.");
+        appendf(out, "radar_udp_truncated_packets_total %llu\n", asULL(ingest.truncated_packets));
+        appendFamily(out, "radar_udp_incomplete_frames_total", "counter", "Frames closed before their last packet.");
+        appendf(out, "radar_udp_incomplete_frames_total %llu\n", asULL(ingest.incomplete_frames));
+    }
+
+    if constexpr (Instrumentation::kEnabled) {
+        appendFamily(out, "radar_detector_returns_total", "counter", "Radar returns scanned.");
+        appendf(out, "radar_detector_returns_total %llu\n", asULL(Instrumentation::counter(Counter::Returns)));
+        appendFamily(out, "radar_detector_prefiltered_total", "counter", "Radar returns rejected by the prefilter.");
+        appendf(out, "radar_detector_prefiltered_total %llu\n", asULL(Instrumentation::counter(Counter::Prefiltered)));
+        appendStageHistograms(out);
+    }
+}
+
+#ifdef __linux__
+
+bool MetricsExporter::start() {
+    if (isRunning()) return true;
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    // A restarted process can rebind while old connections sit in TIME_WAIT.
+    const int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    socklen_t length = sizeof(address);
+    if (::inet_pton(AF_INET, config_.bind_address.c_str(), &address.sin_addr) != 1
+        || ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(fd, 16) != 0
+        || ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    bound_port_ = ntohs(address.sin_port);
+
+    running_.store(true, std::memory_order_release);
+    server_thread_ = std::thread(&MetricsExporter::serveLoop, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    running_.store(false, std::memory_order_release);
+    if (server_thread_.joinable()) server_thread_.join();
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    bound_port_ = 0;
+}
+
+void MetricsExporter::serveLoop() {
+    while (isRunning()) {
+        pollfd waiter{fd_, POLLIN, 0};
+        if (::poll(&waiter, 1, static_cast<int>(config_.poll_interval.count())) <= 0) continue;
+        const int client = ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) continue;
+        serveClient(client);
+        ::close(client);
+    }
+}
+
+void MetricsExporter::serveClient(int client) {
+    // Only the request line matters; headers are read and ignored.
+    request_.clear();
+    char chunk[1024];
+    while (request_.find("\r\n\r\n") == std::string::npos && request_.size() < kMaxRequestBytes) {
+        pollfd waiter{client, POLLIN, 0};
+        if (::poll(&waiter, 1, kClientTimeoutMs) <= 0) return;
+        const ssize_t received = ::recv(client, chunk, sizeof(chunk), 0);
+        if (received <= 0) return;
+        request_.append(chunk, static_cast<std::size_t>(received));
+    }
+
+    const std::string_view request = request_;
+    const bool is_get = request.starts_with("GET ");
+    const std::string_view path = request.substr(is_get ? 4 : 0, request.find_first_of(" ?\r", 4) - 4);
+
+    body_.clear();
+    const char* status = "200 OK";
+    if (!is_get) {
+        status = "405 Method Not Allowed";
+    } else if (path != "/metrics") {
+        status = "404 Not Found";
+    } else {
+        snapshots_.update();
+        writeExposition(snapshots_.readBuffer(), body_);
+    }
+
+    response_.clear();
+    appendf(response_, "HTTP/1.1 %s\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                       "Content-Length: %zu\r\nConnection: close\r\n\r\n", status, body_.size());
+    response_ += body_;
+
+    std::size_t sent = 0;
+    while (sent < response_.size()) {
+        const ssize_t written = ::send(client, response_.data() + sent, response_.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) return;
+        sent += static_cast<std::size_t>(written);
+    }
+}
+
+#else
+
+bool MetricsExporter::start() {
+    return false;
+}
+
+void MetricsExporter::stop() {}
+
+void MetricsExporter::serveLoop() {}
+
+void MetricsExporter::serveClient(int) {}
+
+#endif
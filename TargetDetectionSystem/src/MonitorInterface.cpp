@@ -0,0 +1,219 @@
+#include "MonitorInterface.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace {
+
+constexpr std::string_view kCursorHome = "\x1b[H";
+constexpr std::string_view kClearToEnd = "\x1b[J";
+constexpr std::string_view kClearLine = "\x1b[K";
+constexpr std::string_view kClearAll = "\x1b[2J";
+constexpr std::string_view kHideCursor = "\x1b[?25l";
+constexpr std::string_view kShowCursor = "\x1b[?25h";
+
+std::int64_t periodFor(double refresh_hz) {
+    const double hz = std::clamp(refresh_hz, 0.1, 1000.0);
+    return static_cast<std::int64_t>(1e9 / hz);
+}
+
+void writeOut(std::string_view text) {
+    std::fwrite(text.data(), 1, text.size(), stdout);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+MonitorInterface::MonitorInterface(double refresh_hz, std::size_t max_rows)
+    : running_(false),
+      start_time_(std::chrono::system_clock::now()),
+      refresh_period_ns_(periodFor(refresh_hz)),
+      max_rows_(max_rows) {}
+
+MonitorInterface::~MonitorInterface() {
+    stopMonitoring();
+}
+
+void MonitorInterface::startMonitoring() {
+    if (running_.exchange(true)) return;
+
+#ifdef _WIN32
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(console, &mode)) {
+        SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+
+    start_time_ = std::chrono::system_clock::now();
+    clearScreen();
+    monitor_thread_ = std::thread(&MonitorInterface::renderLoop, this);
+}
+
+void MonitorInterface::stopMonitoring() {
+    if (!running_.exchange(false)) return;
+    if (monitor_thread_.joinable()) monitor_thread_.join();
+    writeOut(kShowCursor);
+}
+
+void MonitorInterface::setRefreshRate(double refresh_hz) {
+    refresh_period_ns_.store(periodFor(refresh_hz), std::memory_order_relaxed);
+}
+
+void MonitorInterface::updateDisplay(std::span<const Target> targets, const DetectionStats& stats) {
+    Snapshot& snapshot = snapshots_.writeBuffer();
+    snapshot.stats = stats;
+
+    const auto rows = targets.first(std::min(targets.size(), max_rows_));
+    snapshot.targets.assign(rows.begin(), rows.end());
+
+    snapshots_.publish();
+}
+
+void MonitorInterface::renderLoop() {
+    auto next_frame = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_relaxed)) {
+        if (snapshots_.update()) {
+            render(snapshots_.readBuffer());
+        }
+        next_frame += std::chrono::nanoseconds(refresh_period_ns_.load(std::memory_order_relaxed));
+        const auto now = std::chrono::steady_clock::now();
+        if (next_frame < now) next_frame = now;
+        std::this_thread::sleep_until(next_frame);
+    }
+}
+
+void MonitorInterface::render(const Snapshot& snapshot) {
+    PROFILE_SCOPE(Stage::Render);
+    frame_.clear();
+    frame_ += kCursorHome;
+    displayHeader();
+    displayStats(snapshot);
+    displayTargets(snapshot);
+    frame_ += kClearToEnd;
+    writeOut(frame_);
+}
+
+void MonitorInterface::displayHeader() {
+    appendLine("========================================");
+    appendLine("      SENTINEL RADAR - LIVE FEED        ");
+    appendLine("========================================");
+}
+
+void MonitorInterface::displayStats(const Snapshot& snapshot) {
+    const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now() - start_time_).count();
+
+    const DetectionStats& s = snapshot.stats;
+    appendLine("Scan Cycle: %llu   Last Scan: %s   Uptime: %llds",
+               static_cast<unsigned long long>(s.scans),
+               formatTime(s.last_scan_time).c_str(), static_cast<long long>(uptime));
+    appendLine("Raw Signals Received: %llu", static_cast<unsigned long long>(s.last_returns));
+    appendLine("Active Targets Locked: %llu   Total Detections: %llu",
+               static_cast<unsigned long long>(s.last_targets), static_cast<unsigned long long>(s.total_detections));
+    appendLine("Detection Time: %.3f ms (ewma %.3f ms)", s.last_cycle_ms, s.cycle_ewma_ms);
+    appendLine("Confidence %.2f +/- %.2f   Velocity %.1f +/- %.1f m/s",
+               s.last_confidence.mean, s.last_confidence.stddev(), s.last_velocity.mean, s.last_velocity.stddev());
+
+    const auto threat = [&](ThreatLevel level) { return s.last_threats[static_cast<std::size_t>(level)]; };
+    appendLine("%sCRITICAL %u%s | %sHIGH %u%s | %sMEDIUM %u%s | %sLOW %u%s",
+               getColorCode(ThreatLevel::CRITICAL).data(), threat(ThreatLevel::CRITICAL), resetColor().data(),
+               getColorCode(ThreatLevel::HIGH).data(), threat(ThreatLevel::HIGH), resetColor().data(),
+               getColorCode(ThreatLevel::MEDIUM).data(), threat(ThreatLevel::MEDIUM), resetColor().data(),
+               getColorCode(ThreatLevel::LOW).data(), threat(ThreatLevel::LOW), resetColor().data());
+
+    const double critical_share = s.last_targets
+        ? 100.0 * (threat(ThreatLevel::CRITICAL) + threat(ThreatLevel::HIGH)) / static_cast<double>(s.last_targets)
+        : 0.0;
+    frame_ += "Threat Load ";
+    displayProgressBar(critical_share);
+    displayLatencies();
+    appendLine("----------------------------------------");
+}
+
+void MonitorInterface::displayLatencies() {
+    if constexpr (!Instrumentation::kEnabled) return;
+    for (std::size_t s = 0; s < kStageCount; ++s) {
+        const auto stage = static_cast<Stage>(s);
+        const LatencySummary latency = Instrumentation::summary(stage);
+        if (latency.count == 0) continue;
+        appendLine("%-7s p50 %9.1f us  p99 %9.1f us  p999 %9.1f us",
+                   stageName(stage).data(), latency.p50_us, latency.p99_us, latency.p999_us);
+    }
+}
+
+void MonitorInterface::displayTargets(const Snapshot& snapshot) {
+    appendLine(" %6s | %-8s | %9s | %9s | %9s | %5s | %8s",
+               "ID", "Threat", "X", "Y", "Z", "Conf", "Vel m/s");
+    for (const auto& target : snapshot.targets) {
+        appendLine(" %6u | %s%-8s%s | %9.1f | %9.1f | %9.1f | %5.2f | %8.1f",
+                   target.id, getColorCode(target.threat_level).data(),
+                   threatLevelName(target.threat_level).data(), resetColor().data(),
+                   target.x, target.y, target.z, target.confidence, target.velocity);
+    }
+    if (snapshot.stats.last_targets > snapshot.targets.size()) {
+        appendLine(" ... %llu more", static_cast<unsigned long long>(snapshot.stats.last_targets - snapshot.targets.size()));
+    }
+}
+
+void MonitorInterface::displayProgressBar(double percentage) {
+    constexpr int kWidth = 30;
+    const int filled = static_cast<int>(std::clamp(percentage, 0.0, 100.0) / 100.0 * kWidth + 0.5);
+    frame_ += '[';
+    frame_.append(static_cast<std::size_t>(filled), '#');
+    frame_.append(static_cast<std::size_t>(kWidth - filled), '.');
+    appendLine("] %5.1f%%", percentage);
+}
+
+void MonitorInterface::appendLine(const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    const int written = std::vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (written > 0) {
+        frame_.append(line, std::min(static_cast<std::size_t>(written), sizeof(line) - 1));
+    }
+    frame_ += kClearLine;
+    frame_ += '\n';
+}
+
+std::string_view MonitorInterface::getColorCode(ThreatLevel level) const {
+    switch (level) {
+        case ThreatLevel::CRITICAL: return "\x1b[1;31m";
+        case ThreatLevel::HIGH:     return "\x1b[33m";
+        case ThreatLevel::MEDIUM:   return "\x1b[36m";
+        case ThreatLevel::LOW:      return "\x1b[32m";
+    }
+    return "";
+}
+
+std::string_view MonitorInterface::resetColor() const {
+    return "\x1b[0m";
+}
+
+void MonitorInterface::clearScreen() const {
+    std::string init;
+    init += kHideCursor;
+    init += kClearAll;
+    init += kCursorHome;
+    writeOut(init);
+}
+
+std::string MonitorInterface::formatTime(std::chrono::system_clock::time_point time) const {
+    const std::time_t raw = std::chrono::system_clock::to_time_t(time);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &raw);
+#else
+    localtime_r(&raw, &local);
+#endif
+    char buffer[16];
+    std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &local);
+    return buffer;
+}
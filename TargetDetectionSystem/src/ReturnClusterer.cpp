@@ -0,0 +1,148 @@
+#include "ReturnClusterer.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+namespace {
+
+using ParentRef = std::atomic_ref<std::uint32_t>;
+
+// Keeps centroids defined when every member has zero confidence.
+constexpr double kMinWeight = 1e-12;
+
+template <typename Body>
+void forEachChunk(ThreadPool* pool, std::size_t count, std::size_t chunk_size, const Body& body) {
+    const std::size_t chunks = (count + chunk_size - 1) / chunk_size;
+    const auto run = [&](std::size_t c) {
+        const std::size_t begin = c * chunk_size;
+        body(begin, std::min(begin + chunk_size, count));
+    };
+    if (pool && chunks > 1) {
+        pool->parallelFor(chunks, run);
+    } else {
+        for (std::size_t c = 0; c < chunks; ++c) run(c);
+    }
+}
+
+} // namespace
+
+ReturnClusterer::ReturnClusterer(ClusterConfig config)
+    : config_(config) {}
+
+// Path-halving find. Every parent is at most its child, so concurrent
+// halving and linking can only shorten paths, never form a cycle.
+std::uint32_t ReturnClusterer::find(std::uint32_t node) noexcept {
+    for (;;) {
+        std::uint32_t parent = ParentRef(parent_[node]).load(std::memory_order_relaxed);
+        if (parent == node) return node;
+        const std::uint32_t grandparent = ParentRef(parent_[parent]).load(std::memory_order_relaxed);
+        if (parent != grandparent) {
+            ParentRef(parent_[node]).compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+        }
+        node = grandparent;
+    }
+}
+
+// Links the larger root under the smaller, retrying if another thread
+// relinked either root first.
+void ReturnClusterer::unite(std::uint32_t a, std::uint32_t b) noexcept {
+    for (;;) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        std::uint32_t expected = a;
+        if (ParentRef(parent_[a]).compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+    }
+}
+
+std::span<const ReturnCluster> ReturnClusterer::cluster(const ClusterInput& input, ThreadPool* pool) {
+    const std::size_t n = input.size();
+    const double epsilon = std::max(config_.epsilon, std::numeric_limits<double>::min());
+    const std::size_t chunk = std::max<std::size_t>(config_.chunk_size, 1);
+    clusters_.clear();
+    weight_.clear();
+    miss_.clear();
+    labels_.assign(n, kNoise);
+    if (n == 0) return clusters_;
+
+    grid_.setCellSize(epsilon);
+    grid_.build(input.x, input.y, input.z);
+    core_.resize(n);
+    parent_.resize(n);
+
+    // Density pass: a core return has at least min_points returns,
+    // itself included, within epsilon.
+    forEachChunk(pool, n, chunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            std::size_t neighbours = 0;
+            grid_.forEachInRadius(input.x[i], input.y[i], input.z[i], epsilon,
+                                  [&](std::uint32_t, double) { ++neighbours; });
+            core_[i] = neighbours >= config_.min_points;
+            parent_[i] = static_cast<std::uint32_t>(i);
+        }
+    });
+
+    // Merge pass: core returns union with every earlier core neighbour.
+    // A border return points at its nearest core neighbour instead, so it
+    // joins that cluster without bridging it to any other.
+    forEachChunk(pool, n, chunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto self = static_cast<std::uint32_t>(i);
+            if (core_[i]) {
+                grid_.forEachInRadius(input.x[i], input.y[i], input.z[i], epsilon,
+                                      [&](std::uint32_t j, double) {
+                    if (j < self && core_[j]) unite(self, j);
+                });
+                continue;
+            }
+            std::uint32_t anchor = self;
+            double best = std::numeric_limits<double>::infinity();
+            grid_.forEachInRadius(input.x[i], input.y[i], input.z[i], epsilon,
+                                  [&](std::uint32_t j, double distance_sq) {
+                if (core_[j] && (distance_sq < best || (distance_sq == best && j < anchor))) {
+                    anchor = j;
+                    best = distance_sq;
+                }
+            });
+            ParentRef(parent_[i]).store(anchor, std::memory_order_relaxed);
+        }
+    });
+
+    // Serial labelling and accumulation in input order keeps cluster
+    // numbering and floating-point sums independent of the pool.
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint32_t root = find(static_cast<std::uint32_t>(i));
+        if (!core_[root]) continue;
+        if (labels_[root] == kNoise) {
+            labels_[root] = static_cast<std::uint32_t>(clusters_.size());
+            clusters_.emplace_back();
+            weight_.push_back(0.0);
+            miss_.push_back(1.0);
+        }
+        const std::uint32_t label = labels_[root];
+        labels_[i] = label;
+
+        ReturnCluster& c = clusters_[label];
+        const double w = std::max(input.confidence[i], kMinWeight);
+        c.x += w * input.x[i];
+        c.y += w * input.y[i];
+        c.z += w * input.z[i];
+        c.velocity += w * input.velocity[i];
+        c.threat_level = std::max(c.threat_level, static_cast<ThreatLevel>(input.threat[i]));
+        ++c.size;
+        weight_[label] += w;
+        miss_[label] *= 1.0 - input.confidence[i];
+    }
+
+    for (std::size_t k = 0; k < clusters_.size(); ++k) {
+        ReturnCluster& c = clusters_[k];
+        const double inv = 1.0 / weight_[k];
+        c.x *= inv;
+        c.y *= inv;
+        c.z *= inv;
+        c.velocity *= inv;
+        c.confidence = 1.0 - miss_[k];
+    }
+    return clusters_;
+}
@@ -0,0 +1,285 @@
+#include "ReturnPrefilter.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RADAR_PREFILTER_X86 1
+#include <immintrin.h>
+#endif
+
+// Built without floating-point contraction, like DetectionKernel.cpp, so
+// every backend makes the same decision for a return on a gate boundary.
+
+namespace {
+
+using Gates = ReturnPrefilter::Gates;
+using ElevationBound = ReturnPrefilter::ElevationBound;
+using Boxes = std::span<const ExclusionBox>;
+
+constexpr double kDegrees = std::numbers::pi / 180.0;
+
+ElevationBound elevationBound(double degrees, bool upper) noexcept {
+    ElevationBound bound;
+    const double limit = upper ? 90.0 : -90.0;
+    if (upper ? degrees >= limit : degrees <= limit) return bound;
+    const double angle = std::clamp(degrees, -90.0, 90.0) * kDegrees;
+    const double sin = upper ? -std::sin(angle) : std::sin(angle);
+    bound.enabled = true;
+    bound.z_scale = upper ? -std::cos(angle) : std::cos(angle);
+    bound.sin_sq = sin * sin;
+    bound.positive_sin = sin >= 0.0;
+    return bound;
+}
+
+// Every test is phrased as "provably outside", so NaN comparisons, which
+// are all false, leave a return in. A gate that does not read the NaN
+// coordinate can still reject, so the runners also clear the rejection of
+// any return whose squared range, and hence some coordinate, is NaN.
+bool elevationRejects(const ElevationBound& b, double z, double planar_sq) noexcept {
+    if (!b.enabled) return false;
+    const double a = z * b.z_scale;
+    const double bound_sq = planar_sq * b.sin_sq;
+    return b.positive_sin ? (a < 0.0) | (a * a < bound_sq)
+                          : (a < 0.0) & (a * a > bound_sq);
+}
+
+bool sectorRejects(const Gates& g, double x, double y) noexcept {
+    if (!g.sector) return false;
+    const bool before = g.from_x * y - g.from_y * x < 0.0;
+    const bool after = x * g.to_y - y * g.to_x < 0.0;
+    return g.wide_sector ? before & after : before | after;
+}
+
+bool boxRejects(Boxes boxes, double x, double y, double z) noexcept {
+    bool inside = false;
+    for (const ExclusionBox& b : boxes) {
+        inside |= (x >= b.min_x) & (x <= b.max_x) & (y >= b.min_y) & (y <= b.max_y)
+                & (z >= b.min_z) & (z <= b.max_z);
+    }
+    return inside;
+}
+
+std::size_t runScalar(const Gates& g, Boxes boxes, const RadarFrameView& frame, std::size_t begin,
+                      const PrefilterColumns& out, std::size_t count) noexcept {
+    const std::size_t n = frame.size();
+    for (std::size_t i = begin; i < n; ++i) {
+        const double x = frame.x[i];
+        const double y = frame.y[i];
+        const double z = frame.z[i];
+        const double planar_sq = x*x + y*y;
+        const double range_sq = planar_sq + z*z;
+
+        bool reject = (range_sq < g.min_range_sq) | (range_sq > g.max_range_sq);
+        reject |= sectorRejects(g, x, y);
+        reject |= elevationRejects(g.lower, z, planar_sq) | elevationRejects(g.upper, z, planar_sq);
+        reject |= boxRejects(boxes, x, y, z);
+        reject &= range_sq == range_sq;
+
+        // Branch-free compaction: always write, advance only on keep.
+        out.x[count] = x;
+        out.y[count] = y;
+        out.z[count] = z;
+        out.velocity[count] = frame.velocity[i];
+        count += !reject;
+    }
+    return count;
+}
+
+#ifdef RADAR_PREFILTER_X86
+
+__attribute__((target("avx2")))
+__m256d elevationRejects4(const ElevationBound& b, __m256d z, __m256d planar_sq) noexcept {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d a = _mm256_mul_pd(z, _mm256_set1_pd(b.z_scale));
+    const __m256d a_sq = _mm256_mul_pd(a, a);
+    const __m256d bound_sq = _mm256_mul_pd(planar_sq, _mm256_set1_pd(b.sin_sq));
+    const __m256d below = _mm256_cmp_pd(a, zero, _CMP_LT_OQ);
+    return b.positive_sin ? _mm256_or_pd(below, _mm256_cmp_pd(a_sq, bound_sq, _CMP_LT_OQ))
+                          : _mm256_and_pd(below, _mm256_cmp_pd(a_sq, bound_sq, _CMP_GT_OQ));
+}
+
+__attribute__((target("avx2")))
+std::size_t runAvx2(const Gates& g, Boxes boxes, const RadarFrameView& frame,
+                    const PrefilterColumns& out) noexcept {
+    const std::size_t n = frame.size();
+    const std::size_t vec_end = n - n % 4;
+
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d min_sq = _mm256_set1_pd(g.min_range_sq);
+    const __m256d max_sq = _mm256_set1_pd(g.max_range_sq);
+    const __m256d from_x = _mm256_set1_pd(g.from_x);
+    const __m256d from_y = _mm256_set1_pd(g.from_y);
+    const __m256d to_x = _mm256_set1_pd(g.to_x);
+    const __m256d to_y = _mm256_set1_pd(g.to_y);
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < vec_end; i += 4) {
+        const __m256d x = _mm256_loadu_pd(frame.x.data() + i);
+        const __m256d y = _mm256_loadu_pd(frame.y.data() + i);
+        const __m256d z = _mm256_loadu_pd(frame.z.data() + i);
+        const __m256d planar_sq = _mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y));
+        const __m256d range_sq = _mm256_add_pd(planar_sq, _mm256_mul_pd(z, z));
+
+        __m256d reject = _mm256_or_pd(_mm256_cmp_pd(range_sq, min_sq, _CMP_LT_OQ),
+                                      _mm256_cmp_pd(range_sq, max_sq, _CMP_GT_OQ));
+        if (g.sector) {
+            const __m256d before = _mm256_cmp_pd(
+                _mm256_sub_pd(_mm256_mul_pd(from_x, y), _mm256_mul_pd(from_y, x)), zero, _CMP_LT_OQ);
+            const __m256d after = _mm256_cmp_pd(
+                _mm256_sub_pd(_mm256_mul_pd(x, to_y), _mm256_mul_pd(y, to_x)), zero, _CMP_LT_OQ);
+            reject = _mm256_or_pd(reject, g.wide_sector ? _mm256_and_pd(before, after)
+                                                        : _mm256_or_pd(before, after));
+        }
+        if (g.lower.enabled) reject = _mm256_or_pd(reject, elevationRejects4(g.lower, z, planar_sq));
+        if (g.upper.enabled) reject = _mm256_or_pd(reject, elevationRejects4(g.upper, z, planar_sq));
+        for (const ExclusionBox& b : boxes) {
+            __m256d inside = _mm256_and_pd(_mm256_cmp_pd(x, _mm256_set1_pd(b.min_x), _CMP_GE_OQ),
+                                           _mm256_cmp_pd(x, _mm256_set1_pd(b.max_x), _CMP_LE_OQ));
+            inside = _mm256_and_pd(inside, _mm256_cmp_pd(y, _mm256_set1_pd(b.min_y), _CMP_GE_OQ));
+            inside = _mm256_and_pd(inside, _mm256_cmp_pd(y, _mm256_set1_pd(b.max_y), _CMP_LE_OQ));
+            inside = _mm256_and_pd(inside, _mm256_cmp_pd(z, _mm256_set1_pd(b.min_z), _CMP_GE_OQ));
+            inside = _mm256_and_pd(inside, _mm256_cmp_pd(z, _mm256_set1_pd(b.max_z), _CMP_LE_OQ));
+            reject = _mm256_or_pd(reject, inside);
+        }
+        reject = _mm256_and_pd(reject, _mm256_cmp_pd(range_sq, range_sq, _CMP_ORD_Q));
+
+        // Whole-vector fast paths; mixed vectors compact lane by lane.
+        const unsigned keep = ~static_cast<unsigned>(_mm256_movemask_pd(reject)) & 0xfu;
+        if (keep == 0) continue;
+        if (keep == 0xfu) {
+            _mm256_storeu_pd(out.x.data() + count, x);
+            _mm256_storeu_pd(out.y.data() + count, y);
+            _mm256_storeu_pd(out.z.data() + count, z);
+            _mm256_storeu_pd(out.velocity.data() + count, _mm256_loadu_pd(frame.velocity.data() + i));
+            count += 4;
+            continue;
+        }
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            out.x[count] = frame.x[i + lane];
+            out.y[count] = frame.y[i + lane];
+            out.z[count] = frame.z[i + lane];
+            out.velocity[count] = frame.velocity[i + lane];
+            count += (keep >> lane) & 1u;
+        }
+    }
+    return runScalar(g, boxes, frame, vec_end, out, count);
+}
+
+__attribute__((target("avx512f")))
+__mmask8 elevationRejects8(const ElevationBound& b, __m512d z, __m512d planar_sq) noexcept {
+    const __m512d a = _mm512_mul_pd(z, _mm512_set1_pd(b.z_scale));
+    const __m512d a_sq = _mm512_mul_pd(a, a);
+    const __m512d bound_sq = _mm512_mul_pd(planar_sq, _mm512_set1_pd(b.sin_sq));
+    const __mmask8 below = _mm512_cmp_pd_mask(a, _mm512_setzero_pd(), _CMP_LT_OQ);
+    return b.positive_sin ? below | _mm512_cmp_pd_mask(a_sq, bound_sq, _CMP_LT_OQ)
+                          : below & _mm512_cmp_pd_mask(a_sq, bound_sq, _CMP_GT_OQ);
+}
+
+__attribute__((target("avx512f")))
+std::size_t runAvx512(const Gates& g, Boxes boxes, const RadarFrameView& frame,
+                      const PrefilterColumns& out) noexcept {
+    const std::size_t n = frame.size();
+    const std::size_t vec_end = n - n % 8;
+
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d min_sq = _mm512_set1_pd(g.min_range_sq);
+    const __m512d max_sq = _mm512_set1_pd(g.max_range_sq);
+    const __m512d from_x = _mm512_set1_pd(g.from_x);
+    const __m512d from_y = _mm512_set1_pd(g.from_y);
+    const __m512d to_x = _mm512_set1_pd(g.to_x);
+    const __m512d to_y = _mm512_set1_pd(g.to_y);
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < vec_end; i += 8) {
+        const __m512d x = _mm512_loadu_pd(frame.x.data() + i);
+        const __m512d y = _mm512_loadu_pd(frame.y.data() + i);
+        const __m512d z = _mm512_loadu_pd(frame.z.data() + i);
+        const __m512d planar_sq = _mm512_add_pd(_mm512_mul_pd(x, x), _mm512_mul_pd(y, y));
+        const __m512d range_sq = _mm512_add_pd(planar_sq, _mm512_mul_pd(z, z));
+
+        __mmask8 reject = _mm512_cmp_pd_mask(range_sq, min_sq, _CMP_LT_OQ)
+                        | _mm512_cmp_pd_mask(range_sq, max_sq, _CMP_GT_OQ);
+        if (g.sector) {
+            const __mmask8 before = _mm512_cmp_pd_mask(
+                _mm512_sub_pd(_mm512_mul_pd(from_x, y), _mm512_mul_pd(from_y, x)), zero, _CMP_LT_OQ);
+            const __mmask8 after = _mm512_cmp_pd_mask(
+                _mm512_sub_pd(_mm512_mul_pd(x, to_y), _mm512_mul_pd(y, to_x)), zero, _CMP_LT_OQ);
+            reject |= g.wide_sector ? before & after : before | after;
+        }
+        if (g.lower.enabled) reject |= elevationRejects8(g.lower, z, planar_sq);
+        if (g.upper.enabled) reject |= elevationRejects8(g.upper, z, planar_sq);
+        for (const ExclusionBox& b : boxes) {
+            __mmask8 inside = _mm512_cmp_pd_mask(x, _mm512_set1_pd(b.min_x), _CMP_GE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, x, _mm512_set1_pd(b.max_x), _CMP_LE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, y, _mm512_set1_pd(b.min_y), _CMP_GE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, y, _mm512_set1_pd(b.max_y), _CMP_LE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, z, _mm512_set1_pd(b.min_z), _CMP_GE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, z, _mm512_set1_pd(b.max_z), _CMP_LE_OQ);
+            reject |= inside;
+        }
+        reject &= _mm512_cmp_pd_mask(range_sq, range_sq, _CMP_ORD_Q);
+
+        const __mmask8 keep = static_cast<__mmask8>(~reject);
+        _mm512_mask_compressstoreu_pd(out.x.data() + count, keep, x);
+        _mm512_mask_compressstoreu_pd(out.y.data() + count, keep, y);
+        _mm512_mask_compressstoreu_pd(out.z.data() + count, keep, z);
+        _mm512_mask_compressstoreu_pd(out.velocity.data() + count, keep,
+                                      _mm512_loadu_pd(frame.velocity.data() + i));
+        count += static_cast<std::size_t>(__builtin_popcount(keep));
+    }
+    return runScalar(g, boxes, frame, vec_end, out, count);
+}
+
+#endif
+
+} // namespace
+
+ReturnPrefilter::ReturnPrefilter(PrefilterConfig config)
+    : config_(std::move(config)) {
+    const double sweep = config_.azimuth_max - config_.azimuth_min;
+    if (sweep < 360.0) {
+        // Normalised into [0, 360): a reversed pair sweeps the long way round.
+        const double normalised = sweep - 360.0 * std::floor(sweep / 360.0);
+        const double from = config_.azimuth_min * kDegrees;
+        const double to = from + normalised * kDegrees;
+        gates_.sector = true;
+        gates_.wide_sector = normalised > 180.0;
+        gates_.from_x = std::cos(from);
+        gates_.from_y = std::sin(from);
+        gates_.to_x = std::cos(to);
+        gates_.to_y = std::sin(to);
+    }
+    gates_.lower = elevationBound(config_.elevation_min, false);
+    gates_.upper = elevationBound(config_.elevation_max, true);
+    updateRangeGate();
+}
+
+void ReturnPrefilter::setRangeLimit(double max_range) noexcept {
+    range_limit_ = max_range;
+    updateRangeGate();
+}
+
+void ReturnPrefilter::updateRangeGate() noexcept {
+    const double max_range = config_.gate_on_threshold ? std::min(config_.max_range, range_limit_)
+                                                       : config_.max_range;
+    const double min_range = std::max(config_.min_range, 0.0);
+    gates_.min_range_sq = min_range * min_range;
+    // A negative bound has to stay below every squared range.
+    gates_.max_range_sq = max_range < 0.0 ? -1.0 : max_range * max_range;
+}
+
+std::size_t ReturnPrefilter::apply(KernelBackend backend, const RadarFrameView& frame,
+                                   const PrefilterColumns& out) const noexcept {
+    if (!KernelDispatch::isSupported(backend)) backend = KernelDispatch::activeBackend();
+    const Boxes boxes = config_.exclusions;
+
+    switch (backend) {
+#ifdef RADAR_PREFILTER_X86
+        case KernelBackend::AVX512: return runAvx512(gates_, boxes, frame, out);
+        case KernelBackend::AVX2:   return runAvx2(gates_, boxes, frame, out);
+#endif
+        default:                    return runScalar(gates_, boxes, frame, 0, out, 0);
+    }
+}
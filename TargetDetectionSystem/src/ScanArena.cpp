@@ -0,0 +1,35 @@
+#include "ScanArena.h"
+#include <algorithm>
+
+ScanArena::ScanArena(std::size_t initial_bytes, std::pmr::memory_resource* upstream)
+    : upstream_(upstream),
+      block_size_(std::max<std::size_t>(initial_bytes, 64)),
+      block_(std::make_unique<std::byte[]>(block_size_)) {
+    monotonic_.emplace(block_.get(), block_size_, upstream_);
+}
+
+ScanArena::~ScanArena() = default;
+
+void ScanArena::reset() {
+    high_water_ = std::max(high_water_, bytes_used_);
+
+    if (bytes_used_ > block_size_) {
+        // The last cycle spilled into upstream chunks: fold them into one
+        // larger block so the next cycle fits without spilling.
+        ++overflows_;
+        monotonic_.reset();
+        block_size_ = high_water_ + high_water_ / 4;
+        block_ = std::make_unique<std::byte[]>(block_size_);
+        monotonic_.emplace(block_.get(), block_size_, upstream_);
+    } else {
+        monotonic_->release();
+    }
+    bytes_used_ = 0;
+}
+
+void* ScanArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    // Count the worst-case padding as well so the high-water mark is an
+    // upper bound on what the block must hold.
+    bytes_used_ += bytes + alignment - 1;
+    return monotonic_->allocate(bytes, alignment);
+}
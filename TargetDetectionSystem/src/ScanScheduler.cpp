@@ -0,0 +1,182 @@
+#include "ScanScheduler.h"
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Timer slot of a freshly spawned coroutine, which has no cadence.
+constexpr std::size_t kNoCadence = ~std::size_t{0};
+
+// Without timerfd, sleeps are cut into slices so a stop is noticed.
+constexpr auto kPollSlice = std::chrono::milliseconds(10);
+
+template <typename Timer>
+bool later(const Timer& a, const Timer& b) noexcept {
+    return a.deadline != b.deadline ? a.deadline > b.deadline : a.order > b.order;
+}
+
+} // namespace
+
+ScanScheduler::ScanScheduler(SchedulerConfig config)
+    : config_(config) {
+#ifdef __linux__
+    // steady_clock is CLOCK_MONOTONIC, so deadlines convert directly.
+    timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (timer_fd_ < 0 || wake_fd_ < 0) {
+        if (timer_fd_ >= 0) ::close(timer_fd_);
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        timer_fd_ = wake_fd_ = -1;
+    }
+#endif
+}
+
+ScanScheduler::~ScanScheduler() {
+    for (const auto handle : tasks_) handle.destroy();
+#ifdef __linux__
+    if (timer_fd_ >= 0) ::close(timer_fd_);
+    if (wake_fd_ >= 0) ::close(wake_fd_);
+#endif
+}
+
+std::size_t ScanScheduler::addCadence(Clock::duration period) {
+    Cadence cadence;
+    cadence.period = std::max<Clock::duration>(period, Clock::duration{1});
+    cadences_.push_back(cadence);
+    return cadences_.size() - 1;
+}
+
+void ScanScheduler::spawn(Task task) {
+    const auto handle = std::exchange(task.handle_, {});
+    if (!handle) return;
+    tasks_.push_back(handle);
+    timers_.push_back({Clock::time_point::min(), armed_++, kNoCadence, handle});
+    std::ranges::push_heap(timers_, later<Timer>);
+}
+
+void ScanScheduler::arm(std::size_t cadence, std::coroutine_handle<> handle) {
+    Cadence& c = cadences_[cadence];
+    const auto now = Clock::now();
+    if (!c.started) {
+        c.next = now;
+        c.started = true;
+    } else {
+        c.next += c.period;
+        if (c.next < now) {
+            // Every deadline up to now has passed; resume at the first one
+            // still ahead.
+            const auto missed = (now - c.next) / c.period + 1;
+            c.next += missed * c.period;
+            ++c.stats.overruns;
+            c.stats.skipped += static_cast<std::uint64_t>(missed);
+        }
+    }
+    timers_.push_back({c.next, armed_++, cadence, handle});
+    std::ranges::push_heap(timers_, later<Timer>);
+}
+
+void ScanScheduler::resume(const Timer& timer) {
+    if (timer.cadence != kNoCadence && !stopRequested()) {
+        Cadence& c = cadences_[timer.cadence];
+        const double lateness_us =
+            std::max(0.0, std::chrono::duration<double, std::micro>(Clock::now() - timer.deadline).count());
+        ++c.stats.ticks;
+        c.lateness_total_us += lateness_us;
+        c.stats.mean_lateness_us = c.lateness_total_us / static_cast<double>(c.stats.ticks);
+        c.stats.max_lateness_us = std::max(c.stats.max_lateness_us, lateness_us);
+    }
+    timer.handle.resume();
+}
+
+void ScanScheduler::run() {
+#ifdef __linux__
+    const int previous_slack = ::prctl(PR_GET_TIMERSLACK, 0, 0, 0, 0);
+    if (config_.timer_slack_ns > 0) {
+        ::prctl(PR_SET_TIMERSLACK, static_cast<unsigned long>(config_.timer_slack_ns), 0, 0, 0);
+    }
+#endif
+
+    while (!tasks_.empty() && !timers_.empty()) {
+        if (!stopRequested() && !waitUntil(timers_.front().deadline)) continue;
+        std::ranges::pop_heap(timers_, later<Timer>);
+        const Timer timer = timers_.back();
+        timers_.pop_back();
+        resume(timer);
+        reap();
+    }
+
+#ifdef __linux__
+    if (config_.timer_slack_ns > 0 && previous_slack > 0) {
+        ::prctl(PR_SET_TIMERSLACK, static_cast<unsigned long>(previous_slack), 0, 0, 0);
+    }
+#endif
+}
+
+void ScanScheduler::requestStop() noexcept {
+    stop_requested_.store(true, std::memory_order_release);
+#ifdef __linux__
+    // write() is async-signal-safe; the loop drains the counter.
+    if (wake_fd_ >= 0) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(wake_fd_, &one, sizeof(one));
+    }
+#endif
+}
+
+CadenceStats ScanScheduler::stats(std::size_t cadence) const noexcept {
+    return cadence < cadences_.size() ? cadences_[cadence].stats : CadenceStats{};
+}
+
+bool ScanScheduler::waitUntil(Clock::time_point deadline) {
+    if (deadline <= Clock::now()) return true;
+#ifdef __linux__
+    if (timer_fd_ >= 0) {
+        const auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch());
+        itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(since_epoch.count() / 1'000'000'000);
+        spec.it_value.tv_nsec = static_cast<long>(since_epoch.count() % 1'000'000'000);
+        if (::timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) == 0) {
+            pollfd waiters[2] = {{timer_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+            for (;;) {
+                if (stopRequested()) return false;
+                if (::poll(waiters, 2, -1) < 0) {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+                std::uint64_t count = 0;
+                if (waiters[1].revents & POLLIN) {
+                    [[maybe_unused]] const auto drained = ::read(wake_fd_, &count, sizeof(count));
+                    return false;
+                }
+                if (waiters[0].revents & POLLIN) {
+                    [[maybe_unused]] const auto expired = ::read(timer_fd_, &count, sizeof(count));
+                    return true;
+                }
+            }
+        }
+    }
+#endif
+    for (auto now = Clock::now(); now < deadline; now = Clock::now()) {
+        if (stopRequested()) return false;
+        std::this_thread::sleep_until(std::min<Clock::time_point>(deadline, now + kPollSlice));
+    }
+    return true;
+}
+
+void ScanScheduler::reap() {
+    std::erase_if(tasks_, [](auto handle) {
+        if (!handle.done()) return false;
+        handle.destroy();
+        return true;
+    });
+}
@@ -0,0 +1,145 @@
+#include "ScenarioGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+// Philox stream tags; each draws from its own counter space.
+constexpr std::uint32_t kStreamShape = 0;
+constexpr std::uint32_t kStreamMotion = 1;
+constexpr std::uint32_t kStreamNoise = 2;
+constexpr std::uint32_t kStreamClutter = 3;
+
+template <typename Body>
+void forEachChunk(ThreadPool* pool, std::size_t count, std::size_t chunk, const Body& body) {
+    const std::size_t chunks = (count + chunk - 1) / chunk;
+    const auto run = [&](std::size_t c) {
+        body(c * chunk, std::min(count, (c + 1) * chunk));
+    };
+    if (pool && chunks > 1) {
+        pool->parallelFor(chunks, run);
+    } else {
+        for (std::size_t c = 0; c < chunks; ++c) run(c);
+    }
+}
+
+} // namespace
+
+ScenarioGenerator::ScenarioGenerator(ScenarioConfig config, ThreadPool* pool)
+    : config_(config), rng_(config.seed), pool_(pool) {
+    const std::size_t n = config_.objects;
+    for (auto* column : {&x0_, &y0_, &z0_, &vx_, &vy_, &vz_, &turn_rate_, &dive_acceleration_}) {
+        column->resize(n);
+    }
+    kind_.resize(n);
+
+    forEachChunk(pool_, n, kChunkSize, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto shape = rng_(Philox4x32::counter(i, 0, kStreamShape));
+            const auto motion = rng_(Philox4x32::counter(i, 0, kStreamMotion));
+
+            x0_[i] = Philox4x32::signedUnit(shape[0]) * config_.extent;
+            y0_[i] = Philox4x32::signedUnit(shape[1]) * config_.extent;
+            z0_[i] = Philox4x32::signedUnit(shape[2]) * config_.extent;
+
+            const double pick = Philox4x32::unit(shape[3]);
+            kind_[i] = pick < config_.straight_fraction ? TrajectoryKind::Straight
+                     : pick < config_.straight_fraction + config_.turning_fraction ? TrajectoryKind::Turning
+                     : TrajectoryKind::Diving;
+
+            // Heading uniform on the circle, climb angle within +/-30 degrees.
+            const double speed = config_.min_speed
+                + Philox4x32::unit(motion[0]) * (config_.max_speed - config_.min_speed);
+            const double heading = 2.0 * std::numbers::pi * Philox4x32::unit(motion[1]);
+            const double climb = Philox4x32::signedUnit(motion[2]) * (std::numbers::pi / 6.0);
+            vx_[i] = speed * std::cos(climb) * std::cos(heading);
+            vy_[i] = speed * std::cos(climb) * std::sin(heading);
+            vz_[i] = speed * std::sin(climb);
+
+            const double shaping = Philox4x32::signedUnit(motion[3]);
+            turn_rate_[i] = kind_[i] == TrajectoryKind::Turning ? shaping * config_.max_turn_rate : 0.0;
+            dive_acceleration_[i] = kind_[i] == TrajectoryKind::Diving
+                ? std::abs(shaping) * config_.max_dive_acceleration : 0.0;
+        }
+    });
+}
+
+void ScenarioGenerator::generate(std::uint64_t frame_index, double time_s, RadarFrame& frame) const {
+    const std::size_t objects = config_.objects;
+    const std::size_t total = returnsPerFrame();
+    frame.x.resize(total);
+    frame.y.resize(total);
+    frame.z.resize(total);
+    frame.velocity.resize(total);
+
+    forEachChunk(pool_, total, kChunkSize, [&](std::size_t begin, std::size_t end) {
+        if (begin < objects) fillObjects(frame_index, time_s, begin, std::min(end, objects), frame);
+        if (end > objects) fillClutter(frame_index, std::max(begin, objects) - objects, end - objects, frame);
+    });
+}
+
+void ScenarioGenerator::fillObjects(std::uint64_t frame_index, double time_s, std::size_t begin,
+                                    std::size_t end, RadarFrame& frame) const {
+    const double t = time_s;
+    const double sigma = config_.position_noise;
+    for (std::size_t i = begin; i < end; ++i) {
+        double px = x0_[i];
+        double py = y0_[i];
+        double pz = z0_[i] + vz_[i] * t;
+        double vx = vx_[i];
+        double vy = vy_[i];
+        double vz = vz_[i];
+
+        const double w = turn_rate_[i];
+        if (w != 0.0) {
+            // Level coordinated turn: the horizontal velocity rotates at w.
+            const double s = std::sin(w * t);
+            const double c = std::cos(w * t);
+            px += (vx_[i] * s - vy_[i] * (1.0 - c)) / w;
+            py += (vy_[i] * s + vx_[i] * (1.0 - c)) / w;
+            vx = vx_[i] * c - vy_[i] * s;
+            vy = vy_[i] * c + vx_[i] * s;
+        } else {
+            px += vx * t;
+            py += vy * t;
+        }
+        const double a = dive_acceleration_[i];
+        pz -= 0.5 * a * t * t;
+        vz -= a * t;
+
+        px = wrap(px);
+        py = wrap(py);
+        pz = wrap(pz);
+
+        const double range = std::sqrt(px * px + py * py + pz * pz);
+        const double radial = range > 0.0 ? (vx * px + vy * py + vz * pz) / range : 0.0;
+
+        const auto bits = rng_(Philox4x32::counter(i, frame_index, kStreamNoise));
+        const auto n01 = Philox4x32::normals(bits[0], bits[1]);
+        const auto n23 = Philox4x32::normals(bits[2], bits[3]);
+        frame.x[i] = px + sigma * n01[0];
+        frame.y[i] = py + sigma * n01[1];
+        frame.z[i] = pz + sigma * n23[0];
+        frame.velocity[i] = radial;
+    }
+}
+
+void ScenarioGenerator::fillClutter(std::uint64_t frame_index, std::size_t begin, std::size_t end,
+                                    RadarFrame& frame) const {
+    const std::size_t base = config_.objects;
+    for (std::size_t i = begin; i < end; ++i) {
+        const auto bits = rng_(Philox4x32::counter(i, frame_index, kStreamClutter));
+        frame.x[base + i] = Philox4x32::signedUnit(bits[0]) * config_.extent;
+        frame.y[base + i] = Philox4x32::signedUnit(bits[1]) * config_.extent;
+        frame.z[base + i] = Philox4x32::signedUnit(bits[2]) * config_.extent;
+        frame.velocity[base + i] = Philox4x32::signedUnit(bits[3]) * config_.clutter_speed;
+    }
+}
+
+double ScenarioGenerator::wrap(double v) const noexcept {
+    const double span = 2.0 * config_.extent;
+    double shifted = std::fmod(v + config_.extent, span);
+    if (shifted < 0.0) shifted += span;
+    return shifted - config_.extent;
+}
@@ -0,0 +1,196 @@
+#include "ShardTransport.h"
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Datagram copy padded to whole doubles, so it can be read in place.
+struct Datagram {
+    std::vector<double> words;
+    std::size_t bytes{0};
+
+    void assign(std::span<const std::byte> data) {
+        words.resize((data.size() + sizeof(double) - 1) / sizeof(double));
+        if (!data.empty()) std::memcpy(words.data(), data.data(), data.size());
+        bytes = data.size();
+    }
+
+    std::span<const std::byte> view() const noexcept {
+        return {reinterpret_cast<const std::byte*>(words.data()), bytes};
+    }
+};
+
+} // namespace
+
+class LoopbackShardNetwork::Endpoint final : public ShardTransport {
+public:
+    explicit Endpoint(LoopbackShardNetwork& network) noexcept
+        : network_(network) {}
+
+    bool send(std::uint32_t peer, std::span<const std::byte> datagram) override {
+        Endpoint* target = network_.find(peer);
+        if (!target) return false;
+        Datagram copy;
+        copy.assign(datagram);
+        std::lock_guard lock(target->mutex_);
+        target->mailbox_.push_back(std::move(copy));
+        return true;
+    }
+
+    std::span<const std::byte> receive() override {
+        std::lock_guard lock(mutex_);
+        if (mailbox_.empty()) return {};
+        current_ = std::move(mailbox_.front());
+        mailbox_.pop_front();
+        return current_.view();
+    }
+
+private:
+    LoopbackShardNetwork& network_;
+    std::mutex mutex_;
+    std::deque<Datagram> mailbox_;
+    Datagram current_;
+};
+
+LoopbackShardNetwork::LoopbackShardNetwork(std::uint32_t shard_count) {
+    // Shards first, the coordinator's mailbox last.
+    endpoints_.reserve(static_cast<std::size_t>(shard_count) + 1);
+    for (std::uint32_t i = 0; i <= shard_count; ++i) endpoints_.push_back(std::make_unique<Endpoint>(*this));
+}
+
+LoopbackShardNetwork::~LoopbackShardNetwork() = default;
+
+ShardTransport& LoopbackShardNetwork::endpoint(std::uint32_t peer) {
+    Endpoint* found = find(peer);
+    return found ? *found : *endpoints_.back();
+}
+
+LoopbackShardNetwork::Endpoint* LoopbackShardNetwork::find(std::uint32_t peer) noexcept {
+    if (peer == ShardTransport::kCoordinator) return endpoints_.back().get();
+    return peer + std::size_t{1} < endpoints_.size() ? endpoints_[peer].get() : nullptr;
+}
+
+struct UdpShardTransport::Peers {
+#ifdef __linux__
+    std::vector<sockaddr_in> shards;
+    sockaddr_in coordinator{};
+    bool has_coordinator{false};
+#endif
+};
+
+UdpShardTransport::UdpShardTransport(UdpShardConfig config)
+    : config_(std::move(config)) {}
+
+UdpShardTransport::~UdpShardTransport() {
+    close();
+}
+
+#ifdef __linux__
+
+namespace {
+
+bool parseAddress(const std::string& spec, sockaddr_in& out) {
+    const auto colon = spec.rfind(':');
+    if (colon == std::string::npos) return false;
+    char* end = nullptr;
+    const unsigned long port = std::strtoul(spec.c_str() + colon + 1, &end, 10);
+    if (end == spec.c_str() + colon + 1 || *end != '\0' || port == 0 || port > 65535) return false;
+    out = sockaddr_in{};
+    out.sin_family = AF_INET;
+    out.sin_port = htons(static_cast<std::uint16_t>(port));
+    return ::inet_pton(AF_INET, spec.substr(0, colon).c_str(), &out.sin_addr) == 1;
+}
+
+} // namespace
+
+bool UdpShardTransport::open() {
+    close();
+    auto peers = std::make_unique<Peers>();
+    peers->shards.resize(config_.shards.size());
+    for (std::size_t i = 0; i < config_.shards.size(); ++i) {
+        if (!parseAddress(config_.shards[i], peers->shards[i])) return false;
+    }
+    if (!config_.coordinator.empty()) {
+        if (!parseAddress(config_.coordinator, peers->coordinator)) return false;
+        peers->has_coordinator = true;
+    }
+
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &config_.socket_buffer_bytes, sizeof(config_.socket_buffer_bytes));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    socklen_t length = sizeof(address);
+    if (::inet_pton(AF_INET, config_.bind_address.c_str(), &address.sin_addr) != 1
+        || ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    bound_port_ = ntohs(address.sin_port);
+    peers_ = std::move(peers);
+    buffer_.assign((config_.max_datagram_bytes + sizeof(double) - 1) / sizeof(double), 0.0);
+    return true;
+}
+
+void UdpShardTransport::close() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    bound_port_ = 0;
+}
+
+bool UdpShardTransport::send(std::uint32_t peer, std::span<const std::byte> datagram) {
+    if (fd_ < 0) return false;
+    const sockaddr_in* target = nullptr;
+    if (peer == kCoordinator) {
+        if (peers_->has_coordinator) target = &peers_->coordinator;
+    } else if (peer < peers_->shards.size()) {
+        target = &peers_->shards[peer];
+    }
+    if (!target) return false;
+    const ssize_t sent = ::sendto(fd_, datagram.data(), datagram.size(), MSG_DONTWAIT,
+                                  reinterpret_cast<const sockaddr*>(target), sizeof(*target));
+    return sent == static_cast<ssize_t>(datagram.size());
+}
+
+std::span<const std::byte> UdpShardTransport::receive() {
+    if (fd_ < 0) return {};
+    const std::size_t capacity = buffer_.size() * sizeof(double);
+    for (;;) {
+        const ssize_t received = ::recv(fd_, buffer_.data(), capacity, MSG_DONTWAIT | MSG_TRUNC);
+        if (received <= 0) return {};
+        // Oversized datagrams were truncated; skip them rather than hand on half.
+        if (static_cast<std::size_t>(received) > capacity) continue;
+        return {reinterpret_cast<const std::byte*>(buffer_.data()), static_cast<std::size_t>(received)};
+    }
+}
+
+#else
+
+bool UdpShardTransport::open() {
+    return false;
+}
+
+void UdpShardTransport::close() {}
+
+bool UdpShardTransport::send(std::uint32_t, std::span<const std::byte>) {
+    return false;
+}
+
+std::span<const std::byte> UdpShardTransport::receive() {
+    return {};
+}
+
+#endif
@@ -0,0 +1,304 @@
+#include "ShardedDetection.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "TargetSink.h"
+
+namespace {
+
+std::uint32_t cellOf(double v, double min, double size, std::uint32_t cells) noexcept {
+    const double cell = (v - min) / size;
+    // NaN lands in the first cell.
+    if (!(cell >= 0.0)) return 0;
+    if (cell >= static_cast<double>(cells)) return cells - 1;
+    return static_cast<std::uint32_t>(cell);
+}
+
+// Distance from v to the extent of cell index along one axis; the edge
+// cells are open-ended.
+double gapTo(double v, std::uint32_t index, double min, double size, std::uint32_t cells) noexcept {
+    const double lo = index == 0 ? -std::numeric_limits<double>::infinity() : min + index * size;
+    const double hi = index + 1 == cells ? std::numeric_limits<double>::infinity() : min + (index + 1) * size;
+    if (v < lo) return lo - v;
+    if (v > hi) return v - hi;
+    return 0.0;
+}
+
+// Threat, then confidence, descending; NaN confidence last; then id.
+bool moreSevere(const TargetRecord& a, const TargetRecord& b) noexcept {
+    if (a.threat_level != b.threat_level) return a.threat_level > b.threat_level;
+    const double ca = std::isnan(a.confidence) ? -std::numeric_limits<double>::infinity() : a.confidence;
+    const double cb = std::isnan(b.confidence) ? -std::numeric_limits<double>::infinity() : b.confidence;
+    if (ca != cb) return ca > cb;
+    return a.id < b.id;
+}
+
+template <typename T>
+void store(std::byte* out, std::size_t& offset, const T& value) noexcept {
+    std::memcpy(out + offset, &value, sizeof(T));
+    offset += sizeof(T);
+}
+
+template <typename T>
+T load(const std::byte* in, std::size_t offset) noexcept {
+    T value;
+    std::memcpy(&value, in + offset, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+std::uint32_t ShardLayout::shardOf(double x, double y) const noexcept {
+    const std::uint32_t column = cellOf(x, min_x, (max_x - min_x) / columns, columns);
+    const std::uint32_t row = cellOf(y, min_y, (max_y - min_y) / rows, rows);
+    return row * columns + column;
+}
+
+void ShardLayout::neighboursNear(std::uint32_t shard, double x, double y, std::vector<std::uint32_t>& out) const {
+    const double width = (max_x - min_x) / columns;
+    const double height = (max_y - min_y) / rows;
+    const std::int64_t column = shard % columns;
+    const std::int64_t row = shard / columns;
+    const double margin_sq = handoff_margin * handoff_margin;
+    for (std::int64_t r = row - 1; r <= row + 1; ++r) {
+        if (r < 0 || r >= rows) continue;
+        const double dy = gapTo(y, static_cast<std::uint32_t>(r), min_y, height, rows);
+        for (std::int64_t c = column - 1; c <= column + 1; ++c) {
+            if (c < 0 || c >= columns || (r == row && c == column)) continue;
+            const double dx = gapTo(x, static_cast<std::uint32_t>(c), min_x, width, columns);
+            if (dx * dx + dy * dy <= margin_sq) out.push_back(static_cast<std::uint32_t>(r * columns + c));
+        }
+    }
+}
+
+void ShardLayout::route(const RadarFrameView& frame, std::span<RadarFrame> shards) const {
+    for (std::size_t i = 0; i < frame.size(); ++i) {
+        shards[shardOf(frame.x[i], frame.y[i])].push(frame.x[i], frame.y[i], frame.z[i], frame.velocity[i]);
+    }
+}
+
+ShardWorker::ShardWorker(const ShardLayout& layout, std::uint32_t shard, TargetDetector& detector,
+                         TargetTracker& tracker, ShardTransport& transport, ShardWorkerConfig config)
+    : layout_(layout), shard_(shard), detector_(detector), tracker_(tracker), transport_(transport),
+      config_(config), outbox_(layout.shardCount()) {}
+
+TrackerConfig ShardWorker::trackerConfig(const ShardLayout& layout, std::uint32_t shard, TrackerConfig base) {
+    base.first_track_id = shard + 1;
+    base.track_id_stride = layout.shardCount();
+    return base;
+}
+
+std::span<const Target> ShardWorker::scan(const RadarFrameView& frame, std::chrono::system_clock::time_point stamp) {
+    ++stats_.scans;
+    adoptHandoffs();
+    detector_.scan(frame, targets_);
+    tracker_.update(targets_, stamp);
+    sendHandoffs(stamp);
+    sendReport(stamp);
+    return targets_;
+}
+
+void ShardWorker::adoptHandoffs() {
+    for (auto datagram = transport_.receive(); !datagram.empty(); datagram = transport_.receive()) {
+        inbox_.clear();
+        std::chrono::system_clock::time_point stamp;
+        if (!decodeHandoff(datagram, inbox_, stamp)) {
+            ++stats_.malformed_messages;
+            continue;
+        }
+        for (const TrackView& track : inbox_) {
+            if (tracker_.adoptTrack(track, stamp)) ++stats_.handoffs_adopted;
+        }
+    }
+}
+
+// Only tracks associated this scan are handed off: a shard coasting a copy
+// it adopted earlier has nothing new to tell the shard that sent it.
+void ShardWorker::sendHandoffs(std::chrono::system_clock::time_point stamp) {
+    for (auto& batch : outbox_) batch.clear();
+    for (std::size_t i = 0; i < tracker_.trackCount(); ++i) {
+        const TrackView track = tracker_.track(i);
+        if (track.misses != 0) continue;
+        neighbours_.clear();
+        layout_.neighboursNear(shard_, track.x, track.y, neighbours_);
+        for (const std::uint32_t neighbour : neighbours_) outbox_[neighbour].push_back(track);
+    }
+
+    const std::size_t per_datagram = std::max<std::size_t>(
+        (std::max(config_.max_datagram_bytes, kShardHeaderBytes) - kShardHeaderBytes) / kHandoffTrackBytes, 1);
+    for (std::uint32_t neighbour = 0; neighbour < outbox_.size(); ++neighbour) {
+        const std::span<const TrackView> batch = outbox_[neighbour];
+        for (std::size_t begin = 0; begin < batch.size(); begin += per_datagram) {
+            const auto tracks = batch.subspan(begin, std::min(per_datagram, batch.size() - begin));
+            datagram_.resize(handoffRecordBytes(tracks.size()));
+            encodeHandoff(datagram_, shard_, stats_.scans, stamp, tracks);
+            if (transport_.send(neighbour, datagram_)) {
+                stats_.handoffs_sent += tracks.size();
+            } else {
+                ++stats_.send_failures;
+            }
+        }
+    }
+}
+
+// Sent every scan, empty or not, so the coordinator drops threats that
+// have left this shard.
+void ShardWorker::sendReport(std::chrono::system_clock::time_point stamp) {
+    const std::size_t fit = (std::max(config_.max_datagram_bytes, kShardHeaderBytes) - kShardHeaderBytes)
+        / sizeof(TargetRecord);
+    records_.clear();
+    for (const Target& target : targets_) records_.push_back(StreamSink::toRecord(target, stats_.scans));
+    const std::size_t count = std::min({config_.report_targets, fit, records_.size()});
+    std::partial_sort(records_.begin(), records_.begin() + static_cast<std::ptrdiff_t>(count), records_.end(),
+                      moreSevere);
+
+    datagram_.resize(threatReportBytes(count));
+    std::size_t offset = 0;
+    store(datagram_.data(), offset, FrameRecordHeader{kThreatReportMagic, static_cast<std::uint32_t>(count),
+                                                      toStampNs(stamp)});
+    store(datagram_.data(), offset, ShardMessageHeader{shard_, 0, stats_.scans});
+    if (count > 0) std::memcpy(datagram_.data() + offset, records_.data(), count * sizeof(TargetRecord));
+    if (transport_.send(ShardTransport::kCoordinator, datagram_)) {
+        ++stats_.reports_sent;
+    } else {
+        ++stats_.send_failures;
+    }
+}
+
+std::size_t ShardWorker::encodeHandoff(std::span<std::byte> out, std::uint32_t source_shard, std::uint64_t sequence,
+                                       std::chrono::system_clock::time_point stamp,
+                                       std::span<const TrackView> tracks) {
+    const std::size_t bytes = handoffRecordBytes(tracks.size());
+    if (out.size() < bytes || tracks.size() > std::numeric_limits<std::uint32_t>::max()) return 0;
+
+    std::byte* data = out.data();
+    std::size_t offset = 0;
+    store(data, offset, FrameRecordHeader{kHandoffMagic, static_cast<std::uint32_t>(tracks.size()),
+                                          toStampNs(stamp)});
+    store(data, offset, ShardMessageHeader{source_shard, 0, sequence});
+    const auto column = [&](auto field) {
+        for (const TrackView& track : tracks) store(data, offset, static_cast<double>(track.*field));
+    };
+    column(&TrackView::x);
+    column(&TrackView::y);
+    column(&TrackView::z);
+    column(&TrackView::vx);
+    column(&TrackView::vy);
+    column(&TrackView::vz);
+    column(&TrackView::position_variance);
+    column(&TrackView::velocity_variance);
+    for (const TrackView& track : tracks) {
+        store(data, offset, static_cast<std::uint64_t>(track.id) | static_cast<std::uint64_t>(track.hits) << 32);
+    }
+    return bytes;
+}
+
+bool ShardWorker::decodeHandoff(std::span<const std::byte> datagram, std::vector<TrackView>& out,
+                                std::chrono::system_clock::time_point& stamp) {
+    if (datagram.size() < kShardHeaderBytes) return false;
+    const std::byte* data = datagram.data();
+    const auto header = load<FrameRecordHeader>(data, 0);
+    if (header.magic != kHandoffMagic || datagram.size() != handoffRecordBytes(header.count)) return false;
+
+    const std::size_t count = header.count;
+    const std::size_t first = out.size();
+    out.resize(first + count);
+    const auto column = [&](std::size_t index, auto field) {
+        const std::size_t base = kShardHeaderBytes + index * count * sizeof(double);
+        for (std::size_t i = 0; i < count; ++i) out[first + i].*field = load<double>(data, base + i * sizeof(double));
+    };
+    column(0, &TrackView::x);
+    column(1, &TrackView::y);
+    column(2, &TrackView::z);
+    column(3, &TrackView::vx);
+    column(4, &TrackView::vy);
+    column(5, &TrackView::vz);
+    column(6, &TrackView::position_variance);
+    column(7, &TrackView::velocity_variance);
+    const std::size_t ids = kShardHeaderBytes + kHandoffColumns * count * sizeof(double);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto packed = load<std::uint64_t>(data, ids + i * sizeof(std::uint64_t));
+        TrackView& track = out[first + i];
+        track.id = static_cast<std::uint32_t>(packed);
+        track.hits = static_cast<std::uint32_t>(packed >> 32);
+        track.misses = 0;
+    }
+    stamp = fromStampNs(header.stamp_ns);
+    return true;
+}
+
+ShardCoordinator::ShardCoordinator(std::uint32_t shard_count, ShardCoordinatorConfig config)
+    : config_(config), reports_(shard_count) {}
+
+bool ShardCoordinator::accept(std::span<const std::byte> datagram) {
+    if (datagram.size() < kShardHeaderBytes) return false;
+    const std::byte* data = datagram.data();
+    const auto header = load<FrameRecordHeader>(data, 0);
+    const auto message = load<ShardMessageHeader>(data, sizeof(FrameRecordHeader));
+    if (header.magic != kThreatReportMagic || datagram.size() != threatReportBytes(header.count)
+        || message.source_shard >= reports_.size()) {
+        return false;
+    }
+
+    Report& report = reports_[message.source_shard];
+    ++stats_.reports;
+    if (report.valid && header.stamp_ns < report.stamp_ns) {
+        // A little older is a reordered datagram; far older, the shard has
+        // started over.
+        if (report.stamp_ns - header.stamp_ns <= config_.resync_after.count()) {
+            ++stats_.reordered;
+            return true;
+        }
+        ++stats_.resyncs;
+    }
+    report.stamp_ns = header.stamp_ns;
+    report.valid = true;
+    report.records.resize(header.count);
+    if (header.count > 0) {
+        std::memcpy(report.records.data(), data + kShardHeaderBytes, header.count * sizeof(TargetRecord));
+    }
+    dirty_ = true;
+    return true;
+}
+
+std::size_t ShardCoordinator::poll(ShardTransport& transport) {
+    std::size_t accepted = 0;
+    for (auto datagram = transport.receive(); !datagram.empty(); datagram = transport.receive()) {
+        if (accept(datagram)) ++accepted;
+    }
+    return accepted;
+}
+
+std::span<const TargetRecord> ShardCoordinator::topThreats() {
+    if (!dirty_) return merged_;
+    dirty_ = false;
+    merged_.clear();
+    const std::int64_t newest = toStampNs(newestStamp());
+    for (const Report& report : reports_) {
+        if (!report.valid || report.stamp_ns < newest - config_.max_lag.count()) continue;
+        merged_.insert(merged_.end(), report.records.begin(), report.records.end());
+    }
+
+    // One entry per track id, the most severe of its records.
+    std::ranges::sort(merged_, [](const TargetRecord& a, const TargetRecord& b) {
+        return a.id != b.id ? a.id < b.id : moreSevere(a, b);
+    });
+    const auto duplicates = std::ranges::unique(merged_, {}, &TargetRecord::id);
+    merged_.erase(duplicates.begin(), duplicates.end());
+
+    const std::size_t count = std::min(config_.top_n, merged_.size());
+    std::partial_sort(merged_.begin(), merged_.begin() + static_cast<std::ptrdiff_t>(count), merged_.end(),
+                      moreSevere);
+    merged_.resize(count);
+    return merged_;
+}
+
+std::chrono::system_clock::time_point ShardCoordinator::newestStamp() const noexcept {
+    std::int64_t newest = std::numeric_limits<std::int64_t>::min();
+    for (const Report& report : reports_) {
+        if (report.valid) newest = std::max(newest, report.stamp_ns);
+    }
+    return newest == std::numeric_limits<std::int64_t>::min() ? std::chrono::system_clock::time_point{}
+                                                               : fromStampNs(newest);
+}
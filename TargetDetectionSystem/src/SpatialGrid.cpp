@@ -0,0 +1,202 @@
+#include "SpatialGrid.h"
+#include <bit>
+#include <queue>
+
+SpatialGrid::SpatialGrid(double cell_size)
+    : cell_size_(cell_size) {}
+
+void SpatialGrid::clear() noexcept {
+    px_.clear();
+    py_.clear();
+    pz_.clear();
+    index_.clear();
+    next_.clear();
+    built_ = 0;
+    std::fill(cells_.begin(), cells_.end(), Cell{});
+    occupied_ = 0;
+}
+
+void SpatialGrid::build(std::span<const double> x, std::span<const double> y, std::span<const double> z) {
+    const std::size_t n = x.size();
+    inv_cell_ = 1.0 / cell_size_;
+
+    // Load factor of at most one half keeps probe chains short.
+    const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(16, n * 2));
+    cells_.assign(capacity, Cell{});
+    occupied_ = 0;
+    mask_ = capacity - 1;
+
+    slot_of_.resize(n);
+    for (int axis = 0; axis < 3; ++axis) {
+        lo_[axis] = kAxisBias;
+        hi_[axis] = -kAxisBias;
+    }
+
+    // Pass 1: find each point's cell and count its population.
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::int64_t c[3] = {cellCoord(x[i]), cellCoord(y[i]), cellCoord(z[i])};
+        for (int axis = 0; axis < 3; ++axis) {
+            lo_[axis] = std::min(lo_[axis], c[axis]);
+            hi_[axis] = std::max(hi_[axis], c[axis]);
+        }
+        const std::uint32_t slot = insertCell(packKey(c[0], c[1], c[2]));
+        slot_of_[i] = slot;
+        ++cells_[slot].end;
+    }
+
+    // Pass 2: prefix sum into run starts; end becomes the write cursor.
+    std::uint32_t offset = 0;
+    for (auto& cell : cells_) {
+        if (cell.key == kEmpty) continue;
+        const std::uint32_t count = cell.end;
+        cell.begin = offset;
+        cell.end = offset;
+        offset += count;
+    }
+
+    // Pass 3: scatter, leaving each cell's points contiguous.
+    px_.resize(n);
+    py_.resize(n);
+    pz_.resize(n);
+    index_.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint32_t at = cells_[slot_of_[i]].end++;
+        px_[at] = x[i];
+        py_[at] = y[i];
+        pz_[at] = z[i];
+        index_[at] = static_cast<std::uint32_t>(i);
+    }
+    next_.clear();
+    built_ = n;
+}
+
+void SpatialGrid::insert(double x, double y, double z, std::uint32_t index) {
+    if (2 * (occupied_ + 1) > cells_.size()) growCells();
+    const std::int64_t c[3] = {cellCoord(x), cellCoord(y), cellCoord(z)};
+    for (int axis = 0; axis < 3; ++axis) {
+        lo_[axis] = std::min(lo_[axis], c[axis]);
+        hi_[axis] = std::max(hi_[axis], c[axis]);
+    }
+    Cell& cell = cells_[insertCell(packKey(c[0], c[1], c[2]))];
+    const auto at = static_cast<std::uint32_t>(px_.size());
+    px_.push_back(x);
+    py_.push_back(y);
+    pz_.push_back(z);
+    index_.push_back(index);
+    next_.push_back(cell.inserted);
+    cell.inserted = at;
+}
+
+void SpatialGrid::radiusQuery(double x, double y, double z, double radius, std::vector<Neighbor>& out) const {
+    out.clear();
+    forEachInRadius(x, y, z, radius, [&](std::uint32_t index, double distance_sq) {
+        out.push_back({index, distance_sq});
+    });
+}
+
+void SpatialGrid::nearest(double x, double y, double z, std::size_t k, std::vector<Neighbor>& out) const {
+    out.clear();
+    if (empty() || k == 0) return;
+
+    auto farther = [](const Neighbor& a, const Neighbor& b) { return a.distance_sq < b.distance_sq; };
+    std::priority_queue<Neighbor, std::vector<Neighbor>, decltype(farther)> best(farther);
+    auto offer = [&](std::uint32_t index, double distance_sq) {
+        if (best.size() < k) {
+            best.push({index, distance_sq});
+        } else if (distance_sq < best.top().distance_sq) {
+            best.pop();
+            best.push({index, distance_sq});
+        }
+    };
+
+    // Visit shells of cells at growing Chebyshev distance from the query
+    // cell. Anything beyond shell r lies at least r cells away, so once k
+    // points are held and the worst is closer than that, the search is done.
+    const std::int64_t c[3] = {cellCoord(x), cellCoord(y), cellCoord(z)};
+    std::int64_t first_ring = 0;
+    std::int64_t last_ring = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        first_ring = std::max({first_ring, lo_[axis] - c[axis], c[axis] - hi_[axis]});
+        last_ring = std::max({last_ring, c[axis] - lo_[axis], hi_[axis] - c[axis]});
+    }
+
+    for (std::int64_t ring = first_ring; ring <= last_ring; ++ring) {
+        const std::int64_t x0 = std::max(c[0] - ring, lo_[0]), x1 = std::min(c[0] + ring, hi_[0]);
+        const std::int64_t y0 = std::max(c[1] - ring, lo_[1]), y1 = std::min(c[1] + ring, hi_[1]);
+        const std::int64_t z0 = std::max(c[2] - ring, lo_[2]), z1 = std::min(c[2] + ring, hi_[2]);
+        for (std::int64_t cx = x0; cx <= x1; ++cx) {
+            for (std::int64_t cy = y0; cy <= y1; ++cy) {
+                if (std::abs(cx - c[0]) == ring || std::abs(cy - c[1]) == ring) {
+                    for (std::int64_t cz = z0; cz <= z1; ++cz) scanCell(cx, cy, cz, x, y, z, offer);
+                } else {
+                    // Interior column: only the two caps belong to this shell.
+                    if (c[2] - ring >= lo_[2]) scanCell(cx, cy, c[2] - ring, x, y, z, offer);
+                    if (ring > 0 && c[2] + ring <= hi_[2]) scanCell(cx, cy, c[2] + ring, x, y, z, offer);
+                }
+            }
+        }
+        const double reach = static_cast<double>(ring) * cell_size_;
+        if (best.size() == k && best.top().distance_sq <= reach * reach) break;
+    }
+
+    out.resize(best.size());
+    for (std::size_t i = out.size(); i-- > 0;) {
+        out[i] = best.top();
+        best.pop();
+    }
+}
+
+std::int64_t SpatialGrid::cellCoord(double v) const noexcept {
+    double c = std::floor(v * inv_cell_);
+    // Also catches NaN, which lands in the lowest cell.
+    if (!(c >= static_cast<double>(-kAxisBias))) c = static_cast<double>(-kAxisBias);
+    if (c > static_cast<double>(kAxisBias - 1)) c = static_cast<double>(kAxisBias - 1);
+    return static_cast<std::int64_t>(c);
+}
+
+std::uint64_t SpatialGrid::packKey(std::int64_t cx, std::int64_t cy, std::int64_t cz) noexcept {
+    const auto field = [](std::int64_t c) { return static_cast<std::uint64_t>(c + kAxisBias); };
+    return field(cx) | (field(cy) << kAxisBits) | (field(cz) << (2 * kAxisBits));
+}
+
+std::uint64_t SpatialGrid::hashKey(std::uint64_t key) noexcept {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key;
+}
+
+const SpatialGrid::Cell* SpatialGrid::findCell(std::uint64_t key) const noexcept {
+    for (std::uint64_t slot = hashKey(key) & mask_;; slot = (slot + 1) & mask_) {
+        const Cell& cell = cells_[slot];
+        if (cell.key == key) return &cell;
+        if (cell.key == kEmpty) return nullptr;
+    }
+}
+
+std::uint32_t SpatialGrid::insertCell(std::uint64_t key) {
+    for (std::uint64_t slot = hashKey(key) & mask_;; slot = (slot + 1) & mask_) {
+        Cell& cell = cells_[slot];
+        if (cell.key == key) return static_cast<std::uint32_t>(slot);
+        if (cell.key == kEmpty) {
+            cell.key = key;
+            ++occupied_;
+            return static_cast<std::uint32_t>(slot);
+        }
+    }
+}
+
+void SpatialGrid::growCells() {
+    std::vector<Cell> old = std::move(cells_);
+    cells_.assign(std::max<std::size_t>(16, old.size() * 2), Cell{});
+    mask_ = cells_.size() - 1;
+    for (const Cell& cell : old) {
+        if (cell.key == kEmpty) continue;
+        for (std::uint64_t slot = hashKey(cell.key) & mask_;; slot = (slot + 1) & mask_) {
+            if (cells_[slot].key == kEmpty) {
+                cells_[slot] = cell;
+                break;
+            }
+        }
+    }
+}
@@ -1,80 +1,292 @@
 #define _USE_MATH_DEFINES
 #include "TargetDetector.h"
+#include "TargetSink.h"
 #include <iostream>
 #include <cmath>
 #include <numbers>
+#include <array>
+#include <memory>
+#include <utility>
 
-TargetDetector::TargetDetector(double threshold) 
-    : confidence_threshold_(threshold) {}
+TargetDetectorCore::TargetDetectorCore(double threshold)
+    : confidence_threshold_(threshold),
+      signal_description_(descriptions_.intern("Detected Signal")) {}
 
-std::vector<Target> TargetDetector::detectRadarTargets(const std::vector<std::vector<double>>& raw_data) {
-    detected_targets_.clear();
+void TargetDetectorCore::setOrdering(TargetOrdering ordering, std::size_t top_k) {
+    ordering_ = ordering;
+    top_k_ = top_k;
+}
 
-    for (const auto& signal : raw_data) {
-        if (auto target = processSignal(signal)) {
-            detected_targets_.push_back(*target);
-        }
-    }
+void TargetDetectorCore::setThreadPool(ThreadPool* pool, std::size_t chunk_size) {
+    pool_ = pool;
+    chunk_size_ = std::max<std::size_t>(chunk_size, 1);
+}
 
-    
-    std::ranges::sort(detected_targets_, std::greater{});
+void TargetDetectorCore::forEachChunk(std::size_t chunks, const std::function<void(std::size_t)>& body) {
+    if (pool_ && chunks > 1) {
+        pool_->parallelFor(chunks, body);
+    } else {
+        for (std::size_t c = 0; c < chunks; ++c) body(c);
+    }
+}
 
-    return detected_targets_;
+void TargetDetectorCore::setOffload(DetectionBackend* backend, std::size_t min_returns) {
+    offload_ = backend;
+    offload_min_returns_ = min_returns;
 }
 
-std::optional<Target> TargetDetector::processSignal(const std::vector<double>& signal) {
-    if (signal.size() < 4) return std::nullopt;
+std::size_t TargetDetectorCore::prepareChunks(std::size_t count, double threshold_range, bool can_offload) {
+    scan_started_ = std::chrono::steady_clock::now();
+    kernel_ = kernel_scratch_.prepare(count);
+    if (prefilter_) {
+        prefilter_->setRangeLimit(threshold_range);
+        candidates_ = prefilter_scratch_.prepare(count);
+    }
 
-    double x = signal[0];
-    double y = signal[1];
-    double z = signal[2];
-    double velocity = signal[3];
+    // Serial mode is the single-chunk case of the parallel layout, and an
+    // offloaded frame is one chunk for the backend to split as it likes.
+    offloading_ = can_offload && offload_ && count >= offload_min_returns_;
+    active_chunk_ = pool_ && !offloading_ && count > chunk_size_ ? chunk_size_ : std::max<std::size_t>(count, 1);
+    const std::size_t chunks = (count + active_chunk_ - 1) / active_chunk_;
+    chunk_offsets_.assign(chunks + 1, 0);
+    return chunks;
+}
 
-    
-    double distance = std::sqrt(x*x + y*y + z*z);
-    double confidence = 1.0 / (1.0 + distance * 0.001); 
+void TargetDetectorCore::setClustering(std::optional<ClusterConfig> config) {
+    if (config) {
+        clusterer_.emplace(*config);
+    } else {
+        clusterer_.reset();
+    }
+    clusters_ = {};
+}
 
-    if (confidence < confidence_threshold_) {
-        return std::nullopt;
+void TargetDetectorCore::setPrefilter(std::optional<PrefilterConfig> config) {
+    if (config) {
+        prefilter_.emplace(std::move(*config));
+    } else {
+        prefilter_.reset();
     }
+}
+
+std::size_t TargetDetectorCore::offloadChunk(const ThresholdKernelParams& params, const RadarFrameView& chunk,
+                                             const KernelOutput& out) {
+    return offload_->runThreshold(params, chunk, confidence_threshold_, out, precision_);
+}
 
-    ThreatLevel threat = calculateThreat(velocity, distance);
-    
-    return Target(
-        next_target_id_++,
-        x, y, z,
-        velocity,
-        confidence,
-        threat,
-        "Detected Signal"
-    );
+RadarFrameView TargetDetectorCore::gateChunk(const RadarFrameView& frame, std::size_t begin, std::size_t len) {
+    const RadarFrameView chunk = frame.subview(begin, len);
+    if (!prefilter_) return chunk;
+    // Survivors land at the chunk's own offset, so kernel indices stay
+    // chunk-relative exactly as without the prefilter.
+    const PrefilterColumns slot = candidates_.subspan(begin, len);
+    const std::size_t kept = prefilter_->apply(chunk, slot);
+    PROFILE_COUNT(Counter::Prefiltered, len - kept);
+    return slot.view(kept);
 }
 
-ThreatLevel TargetDetector::calculateThreat(double velocity, double distance) const {
-    if (distance < 500.0 && std::abs(velocity) > 100.0) return ThreatLevel::CRITICAL;
-    if (distance < 1000.0) return ThreatLevel::HIGH;
-    if (std::abs(velocity) > 50.0) return ThreatLevel::MEDIUM;
-    return ThreatLevel::LOW;
+std::size_t TargetDetectorCore::finishChunks(const RadarFrameView& frame) {
+    // Prefix sum over per-chunk counts gives every chunk its output slot
+    // and id range, so ids match what a serial scan would hand out.
+    const std::size_t chunks = chunk_offsets_.size() - 1;
+    for (std::size_t c = 0; c < chunks; ++c) {
+        chunk_offsets_[c + 1] += chunk_offsets_[c];
+    }
+    source_ = prefilter_ ? candidates_.view(frame.size()) : frame;
+    return clusterer_ ? clusterSurvivors() : chunk_offsets_.back();
 }
 
-void TargetDetector::printTargets() const {
-    std::cout << "--- Detected Targets: " << detected_targets_.size() << " ---\n";
-    for (const auto& t : detected_targets_) {
-        std::string threat_str;
-        switch(t.threat_level) {
-            case ThreatLevel::CRITICAL: threat_str = "CRITICAL"; break;
-            case ThreatLevel::HIGH:     threat_str = "HIGH"; break;
-            case ThreatLevel::MEDIUM:   threat_str = "MEDIUM"; break;
-            case ThreatLevel::LOW:      threat_str = "LOW"; break;
+std::size_t TargetDetectorCore::clusterSurvivors() {
+    const std::size_t survivors = chunk_offsets_.back();
+    survivor_x_.resize(survivors);
+    survivor_y_.resize(survivors);
+    survivor_z_.resize(survivors);
+    survivor_velocity_.resize(survivors);
+    survivor_confidence_.resize(survivors);
+    survivor_threat_.resize(survivors);
+
+    forEachChunk(chunk_offsets_.size() - 1, [&](std::size_t c) {
+        const std::size_t begin = c * active_chunk_;
+        const std::size_t first = chunk_offsets_[c];
+        const std::size_t selected = chunk_offsets_[c + 1] - first;
+        for (std::size_t k = 0; k < selected; ++k) {
+            const std::size_t i = begin + kernel_.selected[begin + k];
+            survivor_x_[first + k] = source_.x[i];
+            survivor_y_[first + k] = source_.y[i];
+            survivor_z_[first + k] = source_.z[i];
+            survivor_velocity_[first + k] = source_.velocity[i];
+            survivor_confidence_[first + k] = kernel_.confidence[i];
+            survivor_threat_[first + k] = kernel_.threat[i];
         }
-        
-        std::cout << "ID: " << t.id 
-                  << " | Threat: " << threat_str 
-                  << " | Conf: " << t.confidence 
-                  << " | Vel: " << t.velocity << " m/s\n";
+    });
+
+    clusters_ = clusterer_->cluster({survivor_x_, survivor_y_, survivor_z_, survivor_velocity_,
+                                     survivor_confidence_, survivor_threat_}, pool_);
+    return clusters_.size();
+}
+
+void TargetDetectorCore::materializeClusters(std::span<Target> out, std::chrono::system_clock::time_point scan_time,
+                                             std::uint32_t first_id) {
+    for (std::size_t k = 0; k < clusters_.size(); ++k) {
+        const ReturnCluster& cluster = clusters_[k];
+        std::construct_at(&out[k], first_id + static_cast<std::uint32_t>(k),
+                          cluster.x, cluster.y, cluster.z, cluster.velocity, cluster.confidence,
+                          cluster.threat_level, scan_time, signal_description_);
+    }
+}
+
+void TargetDetectorCore::materialize(const RadarFrameView& frame, std::span<Target> out) {
+    const auto scan_time = std::chrono::system_clock::now();
+    const std::uint32_t first_id = next_target_id_;
+    const std::size_t chunks = chunk_offsets_.size() - 1;
+
+    if (clusterer_) {
+        materializeClusters(out, scan_time, first_id);
+        chunk_stats_.assign(1, summarize(out));
+    } else {
+        chunk_stats_.resize(chunks);
+        forEachChunk(chunks, [&](std::size_t c) {
+            const std::size_t begin = c * active_chunk_;
+            const std::size_t first = chunk_offsets_[c];
+            const std::size_t selected = chunk_offsets_[c + 1] - first;
+            for (std::size_t k = 0; k < selected; ++k) {
+                const std::size_t i = begin + kernel_.selected[begin + k];
+                std::construct_at(&out[first + k],
+                    first_id + static_cast<std::uint32_t>(first + k),
+                    source_.x[i], source_.y[i], source_.z[i],
+                    source_.velocity[i],
+                    kernel_.confidence[i],
+                    static_cast<ThreatLevel>(kernel_.threat[i]),
+                    scan_time,
+                    signal_description_
+                );
+            }
+            chunk_stats_[c] = summarize(out.subspan(first, selected));
+        });
+    }
+    next_target_id_ += static_cast<std::uint32_t>(out.size());
+    PROFILE_COUNT(Counter::Frames, 1);
+    PROFILE_COUNT(Counter::Returns, frame.size());
+    PROFILE_COUNT(Counter::Targets, out.size());
+
+    orderTargets(out);
+    publishStats(frame.size(), out);
+}
+
+TargetDetectorCore::ChunkStats TargetDetectorCore::summarize(std::span<const Target> targets) noexcept {
+    ChunkStats stats;
+    if (targets.empty()) return stats;
+    double confidence_sum = 0.0;
+    double velocity_sum = 0.0;
+    for (const auto& t : targets) {
+        ++stats.threats[static_cast<std::size_t>(t.threat_level)];
+        confidence_sum += t.confidence;
+        velocity_sum += t.velocity;
+    }
+    // Second pass over the still-cached slice for stable squared deviations.
+    const double n = static_cast<double>(targets.size());
+    stats.confidence = {targets.size(), confidence_sum / n, 0.0};
+    stats.velocity = {targets.size(), velocity_sum / n, 0.0};
+    for (const auto& t : targets) {
+        const double dc = t.confidence - stats.confidence.mean;
+        const double dv = t.velocity - stats.velocity.mean;
+        stats.confidence.m2 += dc * dc;
+        stats.velocity.m2 += dv * dv;
+    }
+    return stats;
+}
+
+void TargetDetectorCore::publishStats(std::size_t returns, std::span<const Target> targets) {
+    DetectionStats& s = totals_;
+    s.last_threats = {};
+    s.last_confidence = {};
+    s.last_velocity = {};
+    // Merged in chunk order, so the sums match a serial scan.
+    for (const ChunkStats& chunk : chunk_stats_) {
+        for (std::size_t level = 0; level < kThreatLevels; ++level) s.last_threats[level] += chunk.threats[level];
+        s.last_confidence.merge(chunk.confidence);
+        s.last_velocity.merge(chunk.velocity);
+    }
+    for (std::size_t level = 0; level < kThreatLevels; ++level) s.total_threats[level] += s.last_threats[level];
+    s.confidence.merge(s.last_confidence);
+    s.velocity.merge(s.last_velocity);
+
+    ++s.scans;
+    s.total_detections += targets.size();
+    s.last_returns = returns;
+    s.last_targets = targets.size();
+    s.last_scan_time = targets.empty() ? std::chrono::system_clock::now() : targets.front().detection_time;
+    s.last_cycle_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scan_started_).count();
+    s.cycle_ewma_ms = s.scans == 1 ? s.last_cycle_ms
+                                   : s.cycle_ewma_ms + kCycleSmoothing * (s.last_cycle_ms - s.cycle_ewma_ms);
+    stats_.store(s);
+}
+
+RadarFrameView TargetDetectorCore::stage(const std::vector<std::vector<double>>& raw_data) {
+    staging_frame_.clear();
+    staging_frame_.reserve(raw_data.size());
+
+    for (const auto& signal : raw_data) {
+        if (signal.size() < RadarFrame::kStride) continue;
+        staging_frame_.push(signal[0], signal[1], signal[2], signal[3]);
+    }
+    return staging_frame_.view();
+}
+
+void TargetDetectorCore::orderTargets(std::span<Target> targets) {
+    PROFILE_SCOPE(Stage::Sort);
+    switch (ordering_) {
+        case TargetOrdering::FullSort:
+            std::ranges::sort(targets, std::greater{});
+            break;
+        case TargetOrdering::ThreatBuckets:
+            orderByThreatBuckets(targets);
+            break;
+        case TargetOrdering::None:
+            break;
+    }
+}
+
+void TargetDetectorCore::orderByThreatBuckets(std::span<Target> targets) {
+    constexpr std::size_t kLevels = 4;
+
+    std::array<std::size_t, kLevels> counts{};
+    for (const auto& t : targets) {
+        ++counts[static_cast<std::size_t>(t.threat_level)];
+    }
+
+    // Bucket offsets run from CRITICAL down to LOW.
+    std::array<std::size_t, kLevels> offsets{};
+    std::size_t running = 0;
+    for (std::size_t level = kLevels; level-- > 0;) {
+        offsets[level] = running;
+        running += counts[level];
     }
+
+    order_scratch_.resize(targets.size());
+    auto cursor = offsets;
+    for (const auto& t : targets) {
+        order_scratch_[cursor[static_cast<std::size_t>(t.threat_level)]++] = t;
+    }
+    std::ranges::copy(order_scratch_, targets.begin());
+
+    auto by_confidence = [](const Target& a, const Target& b) { return a.confidence > b.confidence; };
+    std::size_t remaining = top_k_ == 0 ? targets.size() : top_k_;
+    for (std::size_t level = kLevels; level-- > 0 && remaining > 0;) {
+        auto first = targets.begin() + static_cast<std::ptrdiff_t>(offsets[level]);
+        auto last = first + static_cast<std::ptrdiff_t>(counts[level]);
+        const std::size_t k = std::min(remaining, counts[level]);
+        std::partial_sort(first, first + static_cast<std::ptrdiff_t>(k), last, by_confidence);
+        remaining -= k;
+    }
+}
+
+void TargetDetectorCore::printTargets() const {
+    std::string text;
+    StreamSink::formatText(detected_targets_, text);
+    std::cout << text;
 }
 
-size_t TargetDetector::getTargetCount() const {
+size_t TargetDetectorCore::getTargetCount() const {
     return detected_targets_.size();
 }
\ No newline at end of file
@@ -0,0 +1,464 @@
+#include "TargetHistory.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include "BitStream.h"
+#include "RecordingFormat.h"
+
+namespace {
+
+std::uint64_t signExtend(std::uint64_t value, unsigned bits) noexcept {
+    return bits < 64 && (value >> (bits - 1)) & 1 ? value | ~std::uint64_t{0} << bits : value;
+}
+
+// Delta-of-delta buckets after Gorilla: a '0' for an unchanged delta,
+// then prefixes of growing length for 7, 9, 12, 32 and 64-bit values.
+constexpr unsigned kStampBuckets[] = {7, 9, 12, 32, 64};
+
+void encodeStamps(std::span<const std::int64_t> stamps, std::vector<std::uint64_t>& words) {
+    BitWriter out(words);
+    std::uint64_t previous = static_cast<std::uint64_t>(stamps[0]);
+    std::uint64_t previous_delta = 0;
+    out.put(previous, 64);
+    for (std::size_t i = 1; i < stamps.size(); ++i) {
+        // Unsigned, so far-apart stamps wrap instead of overflowing.
+        const std::uint64_t delta = static_cast<std::uint64_t>(stamps[i]) - previous;
+        const auto dod = static_cast<std::int64_t>(delta - previous_delta);
+        previous = static_cast<std::uint64_t>(stamps[i]);
+        previous_delta = delta;
+        if (dod == 0) {
+            out.put(0, 1);
+            continue;
+        }
+        for (std::size_t b = 0; b < std::size(kStampBuckets); ++b) {
+            const unsigned bits = kStampBuckets[b];
+            const std::int64_t limit = bits == 64 ? 0 : std::int64_t{1} << (bits - 1);
+            if (bits == 64 || (dod >= -limit && dod < limit)) {
+                // b + 1 ones, then a zero except after the last bucket.
+                out.put((std::uint64_t{1} << (b + 1)) - 1, static_cast<unsigned>(b + 1));
+                if (b + 1 < std::size(kStampBuckets)) out.put(0, 1);
+                out.put(static_cast<std::uint64_t>(dod), bits);
+                break;
+            }
+        }
+    }
+}
+
+void decodeStamps(std::span<const std::uint64_t> words, std::size_t rows, std::vector<std::int64_t>& stamps) {
+    stamps.resize(rows);
+    BitReader in(words);
+    std::uint64_t previous = in.get(64);
+    std::uint64_t previous_delta = 0;
+    stamps[0] = static_cast<std::int64_t>(previous);
+    for (std::size_t i = 1; i < rows; ++i) {
+        std::size_t bucket = 0;
+        while (bucket < std::size(kStampBuckets) && in.bit()) ++bucket;
+        if (bucket > 0) {
+            const unsigned bits = kStampBuckets[bucket - 1];
+            previous_delta += signExtend(in.get(bits), bits);
+        }
+        previous += previous_delta;
+        stamps[i] = static_cast<std::int64_t>(previous);
+    }
+}
+
+// Gorilla XOR: '0' for a repeat, '10' plus the meaningful bits when they
+// fit the previous leading/trailing-zero window, else '11', 5 bits of
+// leading zeros, 6 bits of length and the bits themselves.
+template <typename Get>
+void encodeDoubles(std::size_t rows, Get get, std::vector<std::uint64_t>& words) {
+    BitWriter out(words);
+    std::uint64_t previous = std::bit_cast<std::uint64_t>(get(0));
+    out.put(previous, 64);
+    bool window = false;
+    unsigned leading = 0;
+    unsigned trailing = 0;
+    for (std::size_t i = 1; i < rows; ++i) {
+        const std::uint64_t value = std::bit_cast<std::uint64_t>(get(i));
+        const std::uint64_t x = value ^ previous;
+        previous = value;
+        if (x == 0) {
+            out.put(0, 1);
+            continue;
+        }
+        const unsigned lead = std::min(static_cast<unsigned>(std::countl_zero(x)), 31u);
+        const unsigned trail = static_cast<unsigned>(std::countr_zero(x));
+        if (window && lead >= leading && trail >= trailing) {
+            out.put(0b01, 2);
+            out.put(x >> trailing, 64 - leading - trailing);
+            continue;
+        }
+        const unsigned meaningful = 64 - lead - trail;
+        out.put(0b11, 2);
+        out.put(lead, 5);
+        out.put(meaningful - 1, 6);
+        out.put(x >> trail, meaningful);
+        window = true;
+        leading = lead;
+        trailing = trail;
+    }
+}
+
+void decodeDoubles(std::span<const std::uint64_t> words, std::size_t rows, std::vector<double>& values) {
+    values.resize(rows);
+    BitReader in(words);
+    std::uint64_t previous = in.get(64);
+    values[0] = std::bit_cast<double>(previous);
+    unsigned leading = 0;
+    unsigned trailing = 0;
+    for (std::size_t i = 1; i < rows; ++i) {
+        if (in.bit()) {
+            if (in.bit()) {
+                leading = static_cast<unsigned>(in.get(5));
+                const unsigned meaningful = static_cast<unsigned>(in.get(6)) + 1;
+                trailing = 64 - leading - meaningful;
+            }
+            previous ^= in.get(64 - leading - trailing) << trailing;
+        }
+        values[i] = std::bit_cast<double>(previous);
+    }
+}
+
+// Rounded to multiples of quantum, then each delta from the previous row
+// zigzagged and written as its 7-bit width and the bits below its top
+// one. Fails, writing nothing useful, if a value is not finite or rounds
+// outside +/-2^52, where the quantum no longer fits a double exactly.
+template <typename Get>
+bool encodeQuantized(std::size_t rows, Get get, double quantum, std::vector<std::uint64_t>& words) {
+    constexpr double kLimit = 4503599627370496.0;
+    BitWriter out(words);
+    std::int64_t previous = 0;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const double scaled = std::nearbyint(get(i) / quantum);
+        if (!(std::fabs(scaled) <= kLimit)) return false;
+        const auto value = static_cast<std::int64_t>(scaled);
+        const auto delta = static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(previous);
+        const std::uint64_t zigzag = (delta << 1) ^ (std::int64_t(delta) < 0 ? ~std::uint64_t{0} : 0);
+        const auto width = static_cast<unsigned>(std::bit_width(zigzag));
+        out.put(width, 7);
+        if (width > 1) out.put(zigzag, width - 1);
+        previous = value;
+    }
+    return true;
+}
+
+void decodeQuantized(std::span<const std::uint64_t> words, std::size_t rows, double quantum,
+                     std::vector<double>& values) {
+    values.resize(rows);
+    BitReader in(words);
+    std::uint64_t previous = 0;
+    for (std::size_t i = 0; i < rows; ++i) {
+        const auto width = static_cast<unsigned>(in.get(7));
+        std::uint64_t zigzag = 0;
+        if (width > 0) zigzag = std::uint64_t{1} << (width - 1) | (width > 1 ? in.get(width - 1) : 0);
+        previous += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        values[i] = static_cast<double>(static_cast<std::int64_t>(previous)) * quantum;
+    }
+}
+
+void encodeIds(std::span<const std::uint32_t> ids, std::vector<std::uint64_t>& words) {
+    BitWriter out(words);
+    out.put(ids[0], 32);
+    for (std::size_t i = 1; i < ids.size(); ++i) {
+        const std::uint32_t gap = ids[i] - ids[i - 1];
+        if (gap == 0) {
+            out.put(0, 1);
+        } else if (gap == 1) {
+            out.put(0b01, 2);
+        } else {
+            out.put(0b11, 2);
+            out.put(ids[i], 32);
+        }
+    }
+}
+
+void decodeIds(std::span<const std::uint64_t> words, std::size_t rows, std::vector<std::uint32_t>& ids) {
+    ids.resize(rows);
+    BitReader in(words);
+    ids[0] = static_cast<std::uint32_t>(in.get(32));
+    for (std::size_t i = 1; i < rows; ++i) {
+        if (!in.bit()) {
+            ids[i] = ids[i - 1];
+        } else if (!in.bit()) {
+            ids[i] = ids[i - 1] + 1;
+        } else {
+            ids[i] = static_cast<std::uint32_t>(in.get(32));
+        }
+    }
+}
+
+void decodeThreats(std::span<const std::uint64_t> words, std::size_t rows, std::vector<std::uint8_t>& threats) {
+    threats.resize(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        threats[i] = static_cast<std::uint8_t>(words[i / 32] >> (2 * (i % 32)) & 0x3);
+    }
+}
+
+void decodeDescriptions(std::span<const std::uint64_t> words, std::size_t rows,
+                        std::vector<std::uint16_t>& descriptions) {
+    descriptions.resize(rows);
+    BitReader in(words);
+    for (std::size_t i = 0; i < rows;) {
+        const auto value = static_cast<std::uint16_t>(in.get(16));
+        const auto run = static_cast<std::size_t>(in.get(32));
+        std::fill_n(descriptions.begin() + static_cast<std::ptrdiff_t>(i), std::min(run, rows - i), value);
+        i += run;
+    }
+}
+
+std::int64_t floorTo(std::int64_t ns, std::int64_t span) noexcept {
+    const std::int64_t q = ns / span;
+    return (q - (ns % span < 0)) * span;
+}
+
+} // namespace
+
+std::size_t TargetHistory::Chunk::bytes() const noexcept {
+    std::size_t total = sizeof(Chunk);
+    for (const auto& stream : streams) total += stream.capacity() * sizeof(std::uint64_t);
+    return total;
+}
+
+TargetHistory::TargetHistory(HistoryConfig config)
+    : config_(config) {
+    if (config_.chunk_span <= std::chrono::seconds::zero()) config_.chunk_span = std::chrono::seconds(1);
+}
+
+void TargetHistory::append(std::span<const Target> targets) {
+    if (targets.empty()) return;
+    const std::int64_t span = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.chunk_span).count();
+    std::unique_lock lock(mutex_);
+    std::int64_t newest = std::numeric_limits<std::int64_t>::min();
+    for (const Target& target : targets) {
+        const std::int64_t ns = toStampNs(target.detection_time);
+        if (open_.empty()) {
+            open_start_ns_ = floorTo(ns, span);
+        } else if (ns - open_start_ns_ >= span) {
+            seal();
+            open_start_ns_ = floorTo(ns, span);
+        }
+        open_.push_back(target);
+        newest = std::max(newest, ns);
+    }
+    rows_ += targets.size();
+    evict(newest);
+}
+
+// Row order is (id, stamp), so each track's rows are contiguous and its
+// stamps and positions change smoothly from one row to the next.
+void TargetHistory::seal() {
+    const std::size_t rows = open_.size();
+    if (rows == 0) return;
+    order_.resize(rows);
+    for (std::uint32_t i = 0; i < rows; ++i) order_[i] = i;
+    std::ranges::stable_sort(order_, [&](std::uint32_t a, std::uint32_t b) {
+        if (open_[a].id != open_[b].id) return open_[a].id < open_[b].id;
+        return open_[a].detection_time < open_[b].detection_time;
+    });
+    const auto row = [&](std::size_t i) -> const Target& { return open_[order_[i]]; };
+
+    Chunk chunk;
+    chunk.rows = rows;
+    chunk.first_id = row(0).id;
+    chunk.last_id = row(rows - 1).id;
+
+    std::vector<std::int64_t> stamps(rows);
+    std::vector<std::uint32_t> ids(rows);
+    chunk.first_ns = std::numeric_limits<std::int64_t>::max();
+    chunk.last_ns = std::numeric_limits<std::int64_t>::min();
+    for (std::size_t i = 0; i < rows; ++i) {
+        stamps[i] = toStampNs(row(i).detection_time);
+        ids[i] = row(i).id;
+        chunk.first_ns = std::min(chunk.first_ns, stamps[i]);
+        chunk.last_ns = std::max(chunk.last_ns, stamps[i]);
+    }
+    encodeStamps(stamps, chunk.streams[kStampStream]);
+    encodeIds(ids, chunk.streams[kIdStream]);
+
+    auto& threats = chunk.streams[kThreatStream];
+    threats.assign((rows + 31) / 32, 0);
+    for (std::size_t i = 0; i < rows; ++i) {
+        const auto level = static_cast<std::uint64_t>(row(i).threat_level) & 0x3;
+        threats[i / 32] |= level << (2 * (i % 32));
+        chunk.threat_mask |= static_cast<std::uint8_t>(1u << level);
+    }
+
+    BitWriter descriptions(chunk.streams[kDescriptionStream]);
+    for (std::size_t i = 0; i < rows;) {
+        std::size_t run = 1;
+        while (i + run < rows && row(i + run).description_id == row(i).description_id) ++run;
+        descriptions.put(row(i).description_id, 16);
+        descriptions.put(run, 32);
+        i += run;
+    }
+
+    const auto encode = [&](Stream stream, double Target::* field, double quantum) {
+        const auto get = [&](std::size_t i) { return row(i).*field; };
+        if (quantum > 0.0 && encodeQuantized(rows, get, quantum, chunk.streams[stream])) {
+            chunk.quantized |= static_cast<std::uint16_t>(1u << stream);
+        } else {
+            encodeDoubles(rows, get, chunk.streams[stream]);
+        }
+    };
+    encode(kXStream, &Target::x, config_.position_quantum);
+    encode(kYStream, &Target::y, config_.position_quantum);
+    encode(kZStream, &Target::z, config_.position_quantum);
+    encode(kVelocityStream, &Target::velocity, config_.velocity_quantum);
+    encode(kConfidenceStream, &Target::confidence, config_.confidence_quantum);
+    for (auto& stream : chunk.streams) stream.shrink_to_fit();
+
+    chunks_.push_back(std::move(chunk));
+    open_.clear();
+}
+
+void TargetHistory::evict(std::int64_t newest_ns) {
+    if (config_.retention <= std::chrono::seconds::zero()) return;
+    const std::int64_t horizon =
+        newest_ns - std::chrono::duration_cast<std::chrono::nanoseconds>(config_.retention).count();
+    std::size_t expired = 0;
+    while (expired < chunks_.size() && chunks_[expired].last_ns < horizon) {
+        rows_ -= chunks_[expired].rows;
+        ++expired;
+    }
+    chunks_.erase(chunks_.begin(), chunks_.begin() + static_cast<std::ptrdiff_t>(expired));
+}
+
+bool TargetHistory::mayMatch(const Chunk& chunk, const HistoryQuery& query, std::int64_t from_ns,
+                             std::int64_t to_ns) noexcept {
+    const auto min_level = static_cast<unsigned>(query.min_threat);
+    return chunk.last_ns >= from_ns && chunk.first_ns < to_ns
+        && (chunk.threat_mask >> min_level) != 0
+        && (!query.id || (*query.id >= chunk.first_id && *query.id <= chunk.last_id));
+}
+
+// Fills scratch.selected with the matching rows of chunk, decoding only
+// the columns whose filter the chunk's summary cannot settle.
+void TargetHistory::select(const Chunk& chunk, const HistoryQuery& query, std::int64_t from_ns,
+                           std::int64_t to_ns, Scratch& scratch) {
+    const auto min_level = static_cast<unsigned>(query.min_threat);
+    const bool by_time = chunk.first_ns < from_ns || chunk.last_ns >= to_ns;
+    const bool by_threat = (chunk.threat_mask & ((1u << min_level) - 1)) != 0;
+    const bool by_id = query.id && (chunk.first_id != *query.id || chunk.last_id != *query.id);
+    if (by_time) decodeStamps(chunk.streams[kStampStream], chunk.rows, scratch.stamps);
+    if (by_threat) decodeThreats(chunk.streams[kThreatStream], chunk.rows, scratch.threats);
+    if (by_id) decodeIds(chunk.streams[kIdStream], chunk.rows, scratch.ids);
+
+    scratch.selected.clear();
+    for (std::uint32_t i = 0; i < chunk.rows; ++i) {
+        if (by_time && (scratch.stamps[i] < from_ns || scratch.stamps[i] >= to_ns)) continue;
+        if (by_threat && scratch.threats[i] < min_level) continue;
+        if (by_id && scratch.ids[i] != *query.id) continue;
+        scratch.selected.push_back(i);
+    }
+}
+
+bool TargetHistory::matches(const Target& target, const HistoryQuery& query) noexcept {
+    return target.detection_time >= query.from && target.detection_time < query.to
+        && target.threat_level >= query.min_threat && (!query.id || target.id == *query.id);
+}
+
+std::size_t TargetHistory::query(const HistoryQuery& query, std::vector<Target>& out, std::uint32_t columns) const {
+    const std::int64_t from_ns = toStampNs(query.from);
+    const std::int64_t to_ns = toStampNs(query.to);
+    const std::size_t before = out.size();
+    Scratch scratch;
+    std::shared_lock lock(mutex_);
+
+    for (const Chunk& chunk : chunks_) {
+        if (!mayMatch(chunk, query, from_ns, to_ns)) continue;
+        select(chunk, query, from_ns, to_ns, scratch);
+        if (scratch.selected.empty()) continue;
+
+        const std::size_t base = out.size();
+        out.resize(base + scratch.selected.size());
+        const auto rows = std::span(out).subspan(base);
+        const auto& selected = scratch.selected;
+        // Streams decode front to back, so stop at the last selected row.
+        const std::size_t needed = selected.back() + 1;
+
+        if (columns & kHistoryStamp) {
+            decodeStamps(chunk.streams[kStampStream], needed, scratch.stamps);
+            for (std::size_t k = 0; k < rows.size(); ++k) rows[k].detection_time = fromStampNs(scratch.stamps[selected[k]]);
+        }
+        if (columns & kHistoryId) {
+            decodeIds(chunk.streams[kIdStream], needed, scratch.ids);
+            for (std::size_t k = 0; k < rows.size(); ++k) rows[k].id = scratch.ids[selected[k]];
+        }
+        if (columns & kHistoryThreat) {
+            decodeThreats(chunk.streams[kThreatStream], needed, scratch.threats);
+            for (std::size_t k = 0; k < rows.size(); ++k) {
+                rows[k].threat_level = static_cast<ThreatLevel>(scratch.threats[selected[k]]);
+            }
+        }
+        if (columns & kHistoryDescription) {
+            decodeDescriptions(chunk.streams[kDescriptionStream], needed, scratch.descriptions);
+            for (std::size_t k = 0; k < rows.size(); ++k) rows[k].description_id = scratch.descriptions[selected[k]];
+        }
+        const auto fill = [&](Stream stream, double Target::* field, double quantum) {
+            if (chunk.quantized & (1u << stream)) {
+                decodeQuantized(chunk.streams[stream], needed, quantum, scratch.values);
+            } else {
+                decodeDoubles(chunk.streams[stream], needed, scratch.values);
+            }
+            for (std::size_t k = 0; k < rows.size(); ++k) rows[k].*field = scratch.values[selected[k]];
+        };
+        if (columns & kHistoryPosition) {
+            fill(kXStream, &Target::x, config_.position_quantum);
+            fill(kYStream, &Target::y, config_.position_quantum);
+            fill(kZStream, &Target::z, config_.position_quantum);
+        }
+        if (columns & kHistoryVelocity) fill(kVelocityStream, &Target::velocity, config_.velocity_quantum);
+        if (columns & kHistoryConfidence) {
+            fill(kConfidenceStream, &Target::confidence, config_.confidence_quantum);
+        }
+    }
+
+    // The open chunk is still raw; copy whole rows, then clear what was
+    // not asked for so results look the same either side of a seal.
+    for (const Target& target : open_) {
+        if (!matches(target, query)) continue;
+        Target row;
+        if (columns & kHistoryStamp) row.detection_time = target.detection_time;
+        if (columns & kHistoryId) row.id = target.id;
+        if (columns & kHistoryThreat) row.threat_level = target.threat_level;
+        if (columns & kHistoryDescription) row.description_id = target.description_id;
+        if (columns & kHistoryPosition) {
+            row.x = target.x;
+            row.y = target.y;
+            row.z = target.z;
+        }
+        if (columns & kHistoryVelocity) row.velocity = target.velocity;
+        if (columns & kHistoryConfidence) row.confidence = target.confidence;
+        out.push_back(row);
+    }
+    return out.size() - before;
+}
+
+std::size_t TargetHistory::count(const HistoryQuery& query) const {
+    const std::int64_t from_ns = toStampNs(query.from);
+    const std::int64_t to_ns = toStampNs(query.to);
+    Scratch scratch;
+    std::shared_lock lock(mutex_);
+
+    std::size_t total = 0;
+    for (const Chunk& chunk : chunks_) {
+        if (!mayMatch(chunk, query, from_ns, to_ns)) continue;
+        select(chunk, query, from_ns, to_ns, scratch);
+        total += scratch.selected.size();
+    }
+    for (const Target& target : open_) total += matches(target, query) ? 1 : 0;
+    return total;
+}
+
+HistoryStats TargetHistory::stats() const {
+    std::shared_lock lock(mutex_);
+    HistoryStats stats;
+    stats.rows = rows_;
+    stats.chunks = chunks_.size() + (open_.empty() ? 0 : 1);
+    stats.bytes = open_.capacity() * sizeof(Target);
+    for (const Chunk& chunk : chunks_) stats.bytes += chunk.bytes();
+    stats.raw_bytes = static_cast<std::size_t>(rows_) * sizeof(Target);
+    return stats;
+}
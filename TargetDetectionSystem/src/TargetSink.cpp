@@ -0,0 +1,207 @@
+#include "TargetSink.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include "RecordingFormat.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+template <typename T>
+void appendBytes(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+StreamSink::StreamSink(SinkFormat format)
+    : format_(format) {}
+
+StreamSink::StreamSink(std::FILE* out, SinkFormat format)
+    : file_(out), format_(format) {}
+
+StreamSink::~StreamSink() {
+    close();
+}
+
+bool StreamSink::open(const std::string& path) {
+    close();
+    file_ = std::fopen(path.c_str(), format_ == SinkFormat::Binary ? "wb" : "w");
+    owned_ = file_ != nullptr;
+    return owned_;
+}
+
+bool StreamSink::close() {
+    if (!file_) return true;
+    bool ok = std::fflush(file_) == 0;
+    if (owned_) ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    owned_ = false;
+    return ok;
+}
+
+bool StreamSink::write(std::span<const Target> targets, std::uint64_t sequence) {
+    if (!file_) return false;
+    buffer_.clear();
+    if (format_ == SinkFormat::Text) {
+        formatText(targets, buffer_);
+    } else {
+        const TargetBatchHeader header{kTargetBatchMagic, static_cast<std::uint32_t>(targets.size()), sequence,
+                                       targets.empty() ? 0 : toStampNs(targets.front().detection_time)};
+        buffer_.reserve(sizeof(header) + targets.size() * sizeof(TargetRecord));
+        appendBytes(buffer_, header);
+        for (const auto& target : targets) appendBytes(buffer_, toRecord(target, sequence));
+    }
+    return std::fwrite(buffer_.data(), 1, buffer_.size(), file_) == buffer_.size();
+}
+
+bool StreamSink::flush() {
+    return file_ && std::fflush(file_) == 0;
+}
+
+void StreamSink::formatText(std::span<const Target> targets, std::string& out) {
+    char line[128];
+    int written = std::snprintf(line, sizeof(line), "--- Detected Targets: %zu ---\n", targets.size());
+    out.append(line, static_cast<std::size_t>(std::max(written, 0)));
+    for (const auto& t : targets) {
+        const std::string_view threat = threatLevelName(t.threat_level);
+        written = std::snprintf(line, sizeof(line), "ID: %u | Threat: %.*s | Conf: %.3f | Vel: %.1f m/s\n",
+                                t.id, static_cast<int>(threat.size()), threat.data(), t.confidence, t.velocity);
+        out.append(line, std::min(static_cast<std::size_t>(std::max(written, 0)), sizeof(line) - 1));
+    }
+}
+
+TargetRecord StreamSink::toRecord(const Target& target, std::uint64_t sequence) noexcept {
+    return {
+        target.id,
+        target.description_id,
+        static_cast<std::uint8_t>(target.threat_level),
+        0,
+        sequence,
+        toStampNs(target.detection_time),
+        target.x, target.y, target.z,
+        target.velocity,
+        target.confidence
+    };
+}
+
+SharedRingSink::SharedRingSink(std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1)) {}
+
+SharedRingSink::~SharedRingSink() {
+    close();
+}
+
+bool SharedRingSink::open(const std::string& path) {
+    close();
+    const std::size_t size = sizeof(SharedRingHeader) + capacity_ * sizeof(TargetRecord);
+    if (!map(path, size)) return false;
+
+    // The mapping starts zeroed; the magic goes in last so a reader that
+    // sees it also sees a consistent header.
+    header_->version = kSharedRingVersion;
+    header_->record_bytes = sizeof(TargetRecord);
+    header_->capacity = capacity_;
+    header_->head.store(0, std::memory_order_relaxed);
+    header_->last_sequence.store(0, std::memory_order_relaxed);
+    header_->write_head.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, kSharedRingMagic, sizeof(header_->magic));
+    return true;
+}
+
+void SharedRingSink::close() {
+    unmap();
+    header_ = nullptr;
+    records_ = nullptr;
+}
+
+std::uint64_t SharedRingSink::head() const noexcept {
+    return header_ ? header_->head.load(std::memory_order_relaxed) : 0;
+}
+
+bool SharedRingSink::write(std::span<const Target> targets, std::uint64_t sequence) {
+    if (!header_) return false;
+    const std::uint64_t head = header_->head.load(std::memory_order_relaxed);
+    const std::uint64_t end = head + targets.size();
+    // Reserve before touching a slot, so a reader that copied a slot
+    // mid-write also sees the reservation that invalidates it.
+    header_->write_head.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // Of a batch larger than the ring only the newest capacity records
+    // would survive, so the rest are never written.
+    const std::size_t skip = targets.size() > capacity_ ? targets.size() - capacity_ : 0;
+    for (std::size_t i = skip; i < targets.size(); ++i) {
+        records_[(head + i) % capacity_] = StreamSink::toRecord(targets[i], sequence);
+    }
+    header_->last_sequence.store(sequence, std::memory_order_relaxed);
+    header_->head.store(end, std::memory_order_release);
+    return true;
+}
+
+#ifdef _WIN32
+
+bool SharedRingSink::map(const std::string& path, std::size_t size) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    const auto wide = static_cast<unsigned long long>(size);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(wide >> 32),
+                                        static_cast<DWORD>(wide & 0xffffffffu), nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    std::memset(view, 0, size);
+    header_ = std::construct_at(static_cast<SharedRingHeader*>(view));
+    records_ = reinterpret_cast<TargetRecord*>(header_ + 1);
+    size_ = size;
+    return true;
+}
+
+void SharedRingSink::unmap() {
+    if (header_) UnmapViewOfFile(header_);
+    if (mapping_handle_) CloseHandle(mapping_handle_);
+    if (file_handle_) CloseHandle(file_handle_);
+    size_ = 0;
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+}
+
+#else
+
+bool SharedRingSink::map(const std::string& path, std::size_t size) {
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* view = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // The mapping keeps the file referenced once established.
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+
+    header_ = std::construct_at(static_cast<SharedRingHeader*>(view));
+    records_ = reinterpret_cast<TargetRecord*>(header_ + 1);
+    size_ = size;
+    return true;
+}
+
+void SharedRingSink::unmap() {
+    if (header_) ::munmap(header_, size_);
+    size_ = 0;
+}
+
+#endif
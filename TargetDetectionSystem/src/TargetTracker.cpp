@@ -0,0 +1,256 @@
+#include "TargetTracker.h"
+#include <algorithm>
+#include "Instrumentation.h"
+
+TargetTracker::TargetTracker(TrackerConfig config)
+    : config_(config), next_track_id_(config.first_track_id) {}
+
+void TargetTracker::update(std::span<Target> detections, std::chrono::system_clock::time_point stamp) {
+    PROFILE_SCOPE(Stage::Track);
+    beginScan(stamp);
+    correct(detections);
+    endScan();
+}
+
+void TargetTracker::beginScan(std::chrono::system_clock::time_point stamp) {
+    const double dt = has_stamp_
+        ? std::max(0.0, std::chrono::duration<double>(stamp - last_stamp_).count()) : 0.0;
+    last_stamp_ = stamp;
+    has_stamp_ = true;
+
+    const std::size_t count = ids_.size();
+    updated_.assign(count, 0);
+    grid_valid_ = false;
+    if (dt == 0.0) return;
+
+    // Constant-velocity prediction with white-acceleration process noise.
+    const double q = config_.process_noise;
+    const double q_pp = q * dt * dt * dt / 3.0;
+    const double q_pv = q * dt * dt / 2.0;
+    const double q_vv = q * dt;
+    for (std::size_t axis = 0; axis < kAxes; ++axis) {
+        double* pos = pos_[axis].data();
+        const double* vel = vel_[axis].data();
+        double* pp = p_pp_[axis].data();
+        double* pv = p_pv_[axis].data();
+        double* vv = p_vv_[axis].data();
+        for (std::size_t i = 0; i < count; ++i) {
+            pos[i] += vel[i] * dt;
+            pp[i] += 2.0 * dt * pv[i] + dt * dt * vv[i] + q_pp;
+            pv[i] += dt * vv[i] + q_pv;
+            vv[i] += q_vv;
+        }
+    }
+}
+
+void TargetTracker::correct(std::span<Target> detections, const std::array<double, 3>& measurement_sigma) {
+    double variance[kAxes];
+    for (std::size_t axis = 0; axis < kAxes; ++axis) {
+        variance[axis] = measurement_sigma[axis] * measurement_sigma[axis];
+    }
+    gatherCandidates(detections);
+
+    // Global nearest neighbour, greedy: closest pairs claim first.
+    std::ranges::sort(candidates_, {}, &Candidate::distance_sq);
+    detection_taken_.assign(detections.size(), 0);
+    track_taken_.assign(ids_.size(), 0);
+    for (const auto& candidate : candidates_) {
+        if (detection_taken_[candidate.detection] || track_taken_[candidate.track]) continue;
+        detection_taken_[candidate.detection] = 1;
+        track_taken_[candidate.track] = 1;
+        updated_[candidate.track] = 1;
+
+        Target& detection = detections[candidate.detection];
+        applyMeasurement(candidate.track, detection, variance);
+        detection.id = ids_[candidate.track];
+    }
+
+    for (std::size_t d = 0; d < detections.size(); ++d) {
+        if (detection_taken_[d]) continue;
+        detections[d].id = spawnTrack(detections[d], variance);
+    }
+}
+
+void TargetTracker::endScan() {
+    for (std::size_t i = ids_.size(); i-- > 0;) {
+        if (updated_[i]) {
+            ++hits_[i];
+            misses_[i] = 0;
+        } else if (++misses_[i] > config_.max_misses) {
+            eraseTrack(i);
+        }
+    }
+}
+
+bool TargetTracker::adoptTrack(const TrackView& track, std::chrono::system_clock::time_point stamp) {
+    const double dt = has_stamp_ ? std::chrono::duration<double>(last_stamp_ - stamp).count() : 0.0;
+    const double velocity[kAxes] = {track.vx, track.vy, track.vz};
+    const double position[kAxes] = {track.x + velocity[0] * dt, track.y + velocity[1] * dt,
+                                    track.z + velocity[2] * dt};
+
+    const auto found = std::ranges::find(ids_, track.id);
+    std::size_t index = static_cast<std::size_t>(found - ids_.begin());
+    if (found == ids_.end()) {
+        // A target that crossed before its handoff arrived has been spawned
+        // here under a local id. Of that track and the adopted one, the one
+        // with more hits survives, so the target is tracked once.
+        const std::size_t local = nearestLocalTrack(position);
+        if (local == ids_.size()) {
+            index = pushTrack(track.id);
+        } else if (hits_[local] > track.hits) {
+            return false;
+        } else {
+            index = local;
+            ids_[index] = track.id;
+        }
+    } else if (misses_[index] == 0) {
+        return false;
+    }
+
+    for (std::size_t axis = 0; axis < kAxes; ++axis) {
+        pos_[axis][index] = position[axis];
+        vel_[axis][index] = velocity[axis];
+        p_pp_[axis][index] = track.position_variance;
+        p_pv_[axis][index] = 0.0;
+        p_vv_[axis][index] = track.velocity_variance;
+    }
+    hits_[index] = track.hits;
+    misses_[index] = track.misses;
+    grid_valid_ = false;
+    return true;
+}
+
+std::size_t TargetTracker::nearestLocalTrack(const double* position) const noexcept {
+    const std::uint32_t stride = std::max(config_.track_id_stride, 1u);
+    const std::uint32_t own = config_.first_track_id % stride;
+    double nearest_sq = config_.gate_radius * config_.gate_radius;
+    std::size_t nearest = ids_.size();
+    for (std::size_t i = 0; i < ids_.size(); ++i) {
+        if (ids_[i] % stride != own) continue;
+        const double dx = pos_[0][i] - position[0];
+        const double dy = pos_[1][i] - position[1];
+        const double dz = pos_[2][i] - position[2];
+        const double distance_sq = dx * dx + dy * dy + dz * dz;
+        if (distance_sq <= nearest_sq) {
+            nearest_sq = distance_sq;
+            nearest = i;
+        }
+    }
+    return nearest;
+}
+
+TrackView TargetTracker::track(std::size_t index) const {
+    TrackView view;
+    view.id = ids_[index];
+    view.x = pos_[0][index];
+    view.y = pos_[1][index];
+    view.z = pos_[2][index];
+    view.vx = vel_[0][index];
+    view.vy = vel_[1][index];
+    view.vz = vel_[2][index];
+    view.position_variance = (p_pp_[0][index] + p_pp_[1][index] + p_pp_[2][index]) / 3.0;
+    view.velocity_variance = (p_vv_[0][index] + p_vv_[1][index] + p_vv_[2][index]) / 3.0;
+    view.hits = hits_[index];
+    view.misses = misses_[index];
+    view.confirmed = hits_[index] >= config_.confirm_hits;
+    return view;
+}
+
+void TargetTracker::gatherCandidates(std::span<const Target> detections) {
+    candidates_.clear();
+    if (ids_.empty()) return;
+
+    // Index the predicted positions on the first correction of a scan.
+    // Tracks are only erased in endScan(), so indices stay valid until then.
+    if (!grid_valid_) {
+        track_grid_.setCellSize(config_.gate_radius);
+        track_grid_.build(pos_[0], pos_[1], pos_[2]);
+        grid_valid_ = true;
+    }
+
+    for (std::size_t d = 0; d < detections.size(); ++d) {
+        const Target& det = detections[d];
+        const auto detection = static_cast<std::uint32_t>(d);
+        track_grid_.forEachInRadius(det.x, det.y, det.z, config_.gate_radius,
+            [&](std::uint32_t track, double distance_sq) {
+                candidates_.push_back({distance_sq, detection, track});
+            });
+    }
+}
+
+void TargetTracker::applyMeasurement(std::size_t track, const Target& detection, const double* variance) {
+    const double measured[kAxes] = {detection.x, detection.y, detection.z};
+    for (std::size_t axis = 0; axis < kAxes; ++axis) {
+        double& pos = pos_[axis][track];
+        double& vel = vel_[axis][track];
+        double& pp = p_pp_[axis][track];
+        double& pv = p_pv_[axis][track];
+        double& vv = p_vv_[axis][track];
+
+        const double s = pp + variance[axis];
+        const double k_pos = pp / s;
+        const double k_vel = pv / s;
+        const double innovation = measured[axis] - pos;
+
+        pos += k_pos * innovation;
+        vel += k_vel * innovation;
+        vv -= k_vel * pv;
+        pv *= 1.0 - k_pos;
+        pp *= 1.0 - k_pos;
+    }
+}
+
+std::uint32_t TargetTracker::spawnTrack(const Target& detection, const double* variance) {
+    const std::uint32_t id = next_track_id_;
+    next_track_id_ += config_.track_id_stride;
+    const double measured[kAxes] = {detection.x, detection.y, detection.z};
+    const double velocity_variance = config_.initial_velocity_sigma * config_.initial_velocity_sigma;
+
+    const std::size_t index = pushTrack(id);
+    for (std::size_t axis = 0; axis < kAxes; ++axis) {
+        pos_[axis][index] = measured[axis];
+        p_pp_[axis][index] = variance[axis];
+        p_vv_[axis][index] = velocity_variance;
+    }
+    // Later correct() calls in this scan associate against it too.
+    if (grid_valid_) track_grid_.insert(measured[0], measured[1], measured[2], static_cast<std::uint32_t>(index));
+    // Counts as associated this scan, so endScan() records its first hit.
+    updated_[index] = 1;
+    return id;
+}
+
+std::size_t TargetTracker::pushTrack(std::uint32_t id) {
+    ids_.push_back(id);
+    for (std::size_t axis = 0; axis < kAxes; ++axis) {
+        pos_[axis].push_back(0.0);
+        vel_[axis].push_back(0.0);
+        p_pp_[axis].push_back(0.0);
+        p_pv_[axis].push_back(0.0);
+        p_vv_[axis].push_back(0.0);
+    }
+    hits_.push_back(0);
+    misses_.push_back(0);
+    updated_.push_back(0);
+    return ids_.size() - 1;
+}
+
+void TargetTracker::eraseTrack(std::size_t index) {
+    const std::size_t last = ids_.size() - 1;
+    auto erase = [&](auto& column) {
+        column[index] = column[last];
+        column.pop_back();
+    };
+
+    erase(ids_);
+    for (std::size_t axis = 0; axis < kAxes; ++axis) {
+        erase(pos_[axis]);
+        erase(vel_[axis]);
+        erase(p_pp_[axis]);
+        erase(p_pv_[axis]);
+        erase(p_vv_[axis]);
+    }
+    erase(hits_);
+    erase(misses_);
+    erase(updated_);
+    grid_valid_ = false;
+}
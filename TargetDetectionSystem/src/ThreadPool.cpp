@@ -0,0 +1,136 @@
+#include "ThreadPool.h"
+
+namespace {
+
+thread_local bool inside_pool_task = false;
+
+constexpr std::uint64_t pack(std::uint32_t begin, std::uint32_t end) noexcept {
+    return (static_cast<std::uint64_t>(begin) << 32) | end;
+}
+
+constexpr std::uint32_t rangeBegin(std::uint64_t range) noexcept {
+    return static_cast<std::uint32_t>(range >> 32);
+}
+
+constexpr std::uint32_t rangeEnd(std::uint64_t range) noexcept {
+    return static_cast<std::uint32_t>(range);
+}
+
+} // namespace
+
+std::size_t ThreadPool::defaultWorkerCount() noexcept {
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 0;
+}
+
+ThreadPool::ThreadPool(std::size_t worker_count)
+    : slots_(std::make_unique<Slot[]>(worker_count + 1)) {
+    workers_.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i + 1); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stopping_.store(true, std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t task_count, const std::function<void(std::size_t)>& body) {
+    if (task_count == 0) return;
+
+    if (workers_.empty() || task_count == 1 || inside_pool_task) {
+        for (std::size_t i = 0; i < task_count; ++i) body(i);
+        return;
+    }
+
+    std::lock_guard lock(submit_mutex_);
+
+    const std::size_t participants = participantCount();
+    for (std::size_t p = 0; p < participants; ++p) {
+        const auto begin = static_cast<std::uint32_t>(task_count * p / participants);
+        const auto end = static_cast<std::uint32_t>(task_count * (p + 1) / participants);
+        slots_[p].range.store(pack(begin, end), std::memory_order_relaxed);
+    }
+
+    body_ = &body;
+    busy_workers_.store(workers_.size(), std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+
+    participate(0);
+
+    // The job (and body) live on this stack frame: wait until every worker
+    // has left it before returning.
+    for (std::size_t busy = busy_workers_.load(std::memory_order_acquire); busy != 0;
+         busy = busy_workers_.load(std::memory_order_acquire)) {
+        busy_workers_.wait(busy, std::memory_order_acquire);
+    }
+    body_ = nullptr;
+}
+
+void ThreadPool::workerLoop(std::size_t slot) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        generation_.wait(seen, std::memory_order_acquire);
+        seen = generation_.load(std::memory_order_acquire);
+        if (stopping_.load(std::memory_order_relaxed)) return;
+
+        participate(slot);
+
+        if (busy_workers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            busy_workers_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::participate(std::size_t slot) {
+    inside_pool_task = true;
+    std::uint32_t task = 0;
+    while (takeOwn(slot, task) || steal(slot, task)) {
+        (*body_)(task);
+    }
+    inside_pool_task = false;
+}
+
+bool ThreadPool::takeOwn(std::size_t slot, std::uint32_t& task) {
+    auto& range = slots_[slot].range;
+    std::uint64_t current = range.load(std::memory_order_acquire);
+    for (;;) {
+        const std::uint32_t begin = rangeBegin(current);
+        const std::uint32_t end = rangeEnd(current);
+        if (begin >= end) return false;
+        if (range.compare_exchange_weak(current, pack(begin + 1, end), std::memory_order_acq_rel)) {
+            task = begin;
+            return true;
+        }
+    }
+}
+
+bool ThreadPool::steal(std::size_t thief, std::uint32_t& task) {
+    const std::size_t participants = participantCount();
+    for (std::size_t offset = 1; offset < participants; ++offset) {
+        auto& victim = slots_[(thief + offset) % participants].range;
+        std::uint64_t current = victim.load(std::memory_order_acquire);
+        for (;;) {
+            const std::uint32_t begin = rangeBegin(current);
+            const std::uint32_t end = rangeEnd(current);
+            if (begin >= end) break;
+
+            // Take the back half; the victim keeps [begin, mid).
+            const std::uint32_t mid = begin + (end - begin) / 2;
+            if (victim.compare_exchange_weak(current, pack(begin, mid), std::memory_order_acq_rel)) {
+                // The thief's own slot is empty here, so only thieves could
+                // touch it, and they skip empty ranges.
+                slots_[thief].range.store(pack(mid + 1, end), std::memory_order_release);
+                task = mid;
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,256 @@
+#include "UdpIngest.h"
+#include <cstring>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+struct UdpIngest::Batch {
+#ifdef __linux__
+    std::vector<mmsghdr> messages;
+    std::vector<iovec> vectors;
+#endif
+};
+
+UdpIngest::UdpIngest(UdpIngestConfig config)
+    : config_(std::move(config)) {}
+
+UdpIngest::~UdpIngest() {
+    close();
+}
+
+#ifdef __linux__
+
+bool UdpIngest::open() {
+    close();
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    // A deep kernel buffer absorbs bursts while the detector is busy.
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &config_.socket_buffer_bytes, sizeof(config_.socket_buffer_bytes));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    socklen_t length = sizeof(address);
+    if (::inet_pton(AF_INET, config_.bind_address.c_str(), &address.sin_addr) != 1
+        || ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    bound_port_ = ntohs(address.sin_port);
+
+    const std::size_t batch = std::max<std::size_t>(config_.batch_size, 1);
+    stride_ = (std::max(config_.max_packet_bytes, sizeof(IngestPacketHeader)) + 63) & ~std::size_t{63};
+    storage_.assign(batch * stride_, std::byte{});
+    batch_ = std::make_unique<Batch>();
+    batch_->messages.assign(batch, mmsghdr{});
+    batch_->vectors.assign(batch, iovec{});
+    for (std::size_t i = 0; i < batch; ++i) {
+        batch_->vectors[i] = {storage_.data() + i * stride_, stride_};
+        batch_->messages[i].msg_hdr.msg_iov = &batch_->vectors[i];
+        batch_->messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    batch_count_ = 0;
+    batch_cursor_ = 0;
+    have_sequence_ = false;
+    stop_requested_.store(false, std::memory_order_release);
+    return true;
+}
+
+void UdpIngest::close() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    bound_port_ = 0;
+}
+
+bool UdpIngest::receiveBatch() {
+    // poll() bounds the wait so stop() is noticed; recvmmsg's own timeout
+    // is only checked between datagrams.
+    pollfd waiter{fd_, POLLIN, 0};
+    const int ready = ::poll(&waiter, 1, static_cast<int>(config_.poll_interval.count()));
+    if (ready <= 0) return false;
+
+    const int received = ::recvmmsg(fd_, batch_->messages.data(), static_cast<unsigned>(batch_->messages.size()),
+                                    MSG_DONTWAIT, nullptr);
+    bump(receive_calls_);
+    if (received <= 0) return false;
+
+    batch_count_ = static_cast<std::size_t>(received);
+    batch_cursor_ = 0;
+    return true;
+}
+
+std::span<const std::byte> UdpIngest::packet(std::size_t index) const noexcept {
+    return {storage_.data() + index * stride_, batch_->messages[index].msg_len};
+}
+
+bool UdpIngest::truncated(std::size_t index) const noexcept {
+    return (batch_->messages[index].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+}
+
+#else
+
+bool UdpIngest::open() {
+    return false;
+}
+
+void UdpIngest::close() {}
+
+bool UdpIngest::receiveBatch() {
+    return false;
+}
+
+std::span<const std::byte> UdpIngest::packet(std::size_t) const noexcept {
+    return {};
+}
+
+bool UdpIngest::truncated(std::size_t) const noexcept {
+    return false;
+}
+
+#endif
+
+bool UdpIngest::fill(RadarFrame& frame) {
+    frame.clear();
+    bool frame_open = false;
+    std::uint32_t frame_id = 0;
+
+    while (isOpen() && !stop_requested_.load(std::memory_order_acquire)) {
+        if (batch_cursor_ == batch_count_ && !receiveBatch()) continue;
+
+        if (truncated(batch_cursor_)) {
+            bump(truncated_);
+            ++batch_cursor_;
+            continue;
+        }
+        const auto datagram = packet(batch_cursor_);
+        IngestPacketHeader header{};
+        if (datagram.size() >= sizeof(header)) std::memcpy(&header, datagram.data(), sizeof(header));
+        if (datagram.size() < sizeof(header) || header.magic != kIngestMagic || header.version != kIngestVersion
+            || datagram.size() != sizeof(header) + header.count * kIngestReturnBytes) {
+            bump(malformed_);
+            ++batch_cursor_;
+            continue;
+        }
+
+        // Stale packets go before the boundary check, so a late one from
+        // an earlier frame cannot cut the open frame short.
+        if (isStale(header.sequence)) {
+            ++batch_cursor_;
+            bump(packets_);
+            bump(bytes_, datagram.size());
+            bump(reordered_);
+            continue;
+        }
+        // A packet from a newer frame, or from a restarted sender, closes the
+        // current one early; it stays queued and opens the next fill().
+        if (frame_open
+            && (static_cast<std::int32_t>(header.frame_id - frame_id) > 0 || isRestart(header.sequence))) {
+            bump(incomplete_frames_);
+            bump(frames_);
+            return true;
+        }
+        ++batch_cursor_;
+        bump(packets_);
+        bump(bytes_, datagram.size());
+        trackSequence(header.sequence);
+        // In sequence but tagged with an older frame: out of order all the
+        // same, and never merged into the open frame.
+        if (frame_open && header.frame_id != frame_id) {
+            bump(reordered_);
+            continue;
+        }
+
+        frame_open = true;
+        frame_id = header.frame_id;
+        decodeReturns(datagram.data() + sizeof(header), header.count, frame);
+        bump(returns_, header.count);
+
+        if (header.flags & kIngestEndOfFrame) {
+            bump(frames_);
+            return true;
+        }
+    }
+    return false;
+}
+
+void UdpIngest::trackSequence(std::uint64_t sequence) {
+    if (isRestart(sequence)) {
+        bump(resyncs_);
+    } else if (have_sequence_ && sequence > expected_sequence_) {
+        bump(gaps_);
+        bump(lost_, sequence - expected_sequence_);
+    }
+    have_sequence_ = true;
+    expected_sequence_ = sequence + 1;
+}
+
+void UdpIngest::decodeReturns(const std::byte* payload, std::size_t count, RadarFrame& frame) {
+    const std::size_t base = frame.size();
+    frame.x.resize(base + count);
+    frame.y.resize(base + count);
+    frame.z.resize(base + count);
+    frame.velocity.resize(base + count);
+
+    // Interleaved on the wire, columnar in the frame: one pass transposes.
+    for (std::size_t i = 0; i < count; ++i) {
+        double r[4];
+        std::memcpy(r, payload + i * kIngestReturnBytes, sizeof(r));
+        frame.x[base + i] = r[0];
+        frame.y[base + i] = r[1];
+        frame.z[base + i] = r[2];
+        frame.velocity[base + i] = r[3];
+    }
+}
+
+UdpIngestStats UdpIngest::stats() const noexcept {
+    const auto read = [](const std::atomic<std::uint64_t>& counter) {
+        return counter.load(std::memory_order_relaxed);
+    };
+    UdpIngestStats out;
+    out.packets = read(packets_);
+    out.bytes = read(bytes_);
+    out.returns = read(returns_);
+    out.frames = read(frames_);
+    out.incomplete_frames = read(incomplete_frames_);
+    out.malformed_packets = read(malformed_);
+    out.truncated_packets = read(truncated_);
+    out.sequence_gaps = read(gaps_);
+    out.packets_lost = read(lost_);
+    out.packets_reordered = read(reordered_);
+    out.sequence_resyncs = read(resyncs_);
+    out.receive_calls = read(receive_calls_);
+    return out;
+}
+
+std::size_t UdpIngest::encodePacket(std::span<std::byte> out, std::uint64_t sequence, std::uint32_t frame_id,
+                                    std::chrono::system_clock::time_point stamp, bool end_of_frame,
+                                    const RadarFrameView& returns) {
+    const std::size_t count = returns.size();
+    const std::size_t size = sizeof(IngestPacketHeader) + count * kIngestReturnBytes;
+    if (count > 0xffff || out.size() < size) return 0;
+
+    IngestPacketHeader header{};
+    header.magic = kIngestMagic;
+    header.version = kIngestVersion;
+    header.count = static_cast<std::uint16_t>(count);
+    header.sequence = sequence;
+    header.stamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stamp.time_since_epoch()).count();
+    header.frame_id = frame_id;
+    header.flags = end_of_frame ? kIngestEndOfFrame : 0;
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    std::byte* cursor = out.data() + sizeof(header);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double r[4] = {returns.x[i], returns.y[i], returns.z[i], returns.velocity[i]};
+        std::memcpy(cursor + i * kIngestReturnBytes, r, sizeof(r));
+    }
+    return size;
+}
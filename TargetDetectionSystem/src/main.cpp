@@ -3,14 +3,92 @@
 #include <random>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <csignal>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <optional>
+#include <cstdio>
 #include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "../include/CudaBackend.h"
+#include "../include/DetectionPipeline.h"
+#include "../include/FrameRecorder.h"
+#include "../include/FrameReplay.h"
+#include "../include/Instrumentation.h"
+#include "../include/MetricsExporter.h"
+#include "../include/MonitorInterface.h"
+#include "../include/RadarFrame.h"
+#include "../include/ScanScheduler.h"
+#include "../include/ScenarioGenerator.h"
 #include "../include/TargetDetector.h"
+#include "../include/TargetHistory.h"
+#include "../include/TargetSink.h"
+#include "../include/TargetTracker.h"
+#include "../include/UdpIngest.h"
 
 using namespace std::chrono_literals;
 
-std::vector<std::vector<double>> generateMockData() {
-    std::vector<std::vector<double>> data;
-    
+namespace {
+ScanScheduler* g_scheduler = nullptr;
+// Blocked in a receive, so it has to be woken explicitly.
+UdpIngest* g_udp = nullptr;
+
+void requestStop(int) {
+    if (g_scheduler) g_scheduler->requestStop();
+    if (g_udp) g_udp->stop();
+}
+
+// One simulated sensor: a frame into the pipeline at every tick of its own
+// cadence. A full frame queue blocks here and shows up as overruns.
+ScanScheduler::Task sensorLoop(ScanScheduler& scheduler, std::size_t cadence, DetectionPipeline& pipeline,
+                               const DetectionPipeline::FrameSource& fill) {
+    for (;;) {
+        const bool running = co_await scheduler.tick(cadence);
+        if (!running) break;
+        if (!pipeline.submit(fill)) scheduler.requestStop();
+    }
+}
+
+// Ends the run at the deadline, or once a self-paced source has ended.
+ScanScheduler::Task supervise(ScanScheduler& scheduler, std::size_t cadence,
+                              std::optional<ScanScheduler::Clock::time_point> deadline,
+                              const std::atomic<bool>& source_done) {
+    for (;;) {
+        const bool running = co_await scheduler.tick(cadence);
+        if (!running) break;
+        if (source_done.load(std::memory_order_acquire)
+            || (deadline && ScanScheduler::Clock::now() >= *deadline)) {
+            scheduler.requestStop();
+        }
+    }
+}
+
+// SPEC is text:FILE, binary:FILE or ring:PATH; FILE "-" is stdout.
+std::unique_ptr<TargetSink> openSink(std::string_view spec) {
+    const auto colon = spec.find(':');
+    if (colon == std::string_view::npos) return nullptr;
+    const std::string_view kind = spec.substr(0, colon);
+    const std::string path(spec.substr(colon + 1));
+
+    if (kind == "ring") {
+        auto ring = std::make_unique<SharedRingSink>();
+        return ring->open(path) ? std::move(ring) : nullptr;
+    }
+    if (kind != "text" && kind != "binary") return nullptr;
+    const SinkFormat format = kind == "text" ? SinkFormat::Text : SinkFormat::Binary;
+    if (path == "-") return std::make_unique<StreamSink>(stdout, format);
+    auto stream = std::make_unique<StreamSink>(format);
+    return stream->open(path) ? std::move(stream) : nullptr;
+}
+} // namespace
+
+void generateMockData(RadarFrame& data) {
+    data.clear();
+
     static std::random_device rd;
     static std::mt19937 gen(rd()); 
 
@@ -21,51 +99,284 @@ std::vector<std::vector<double>> generateMockData() {
     std::uniform_real_distribution<> vel_dist(-400.0, 400.0);
 
     for(int i = 0; i < count; ++i) {
-        data.push_back({
-            pos_dist(gen),
-            pos_dist(gen),
-            pos_dist(gen),
-            vel_dist(gen)
-        });
-    }
-    return data;
+        double x = pos_dist(gen);
+        double y = pos_dist(gen);
+        double z = pos_dist(gen);
+        data.push(x, y, z, vel_dist(gen));
+    }
 }
 
-void clearScreen() {
-#ifdef _WIN32
-    std::system("cls");
-#else
-    std::system("clear");
-#endif
-}
+// Usage: radar_detection [--record FILE] [--stats FILE] [--metrics PORT] [--sink SPEC] [--cluster METRES] [--prefilter] [--sector AZMIN:AZMAX] [--float32] [--offload MIN_RETURNS] [--rate HZ]... [--duration SECONDS] [--scans N] [--history SECONDS] [--replay FILE [--fast] | --udp PORT | --scenario OBJECTS]
+int main(int argc, char** argv) {
+    std::string record_path;
+    std::string stats_path;
+    std::string sink_spec;
+    std::string replay_path;
+    bool replay_fast = false;
+    int udp_port = -1;
+    int metrics_port = -1;
+    long scenario_objects = 0;
+    double cluster_radius = 0.0;
+    std::optional<PrefilterConfig> prefilter;
+    KernelPrecision precision = KernelPrecision::Float64;
+    long offload_returns = -1;
+    std::vector<double> rates_hz;
+    double duration_s = 0.0;
+    long scan_limit = 0;
+    double history_s = -1.0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (arg == "--stats" && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else if (arg == "--sink" && i + 1 < argc) {
+            sink_spec = argv[++i];
+        } else if (arg == "--cluster" && i + 1 < argc) {
+            cluster_radius = std::max(std::atof(argv[++i]), 0.0);
+        } else if (arg == "--prefilter") {
+            if (!prefilter) prefilter.emplace();
+        } else if (arg == "--sector" && i + 1 < argc) {
+            if (!prefilter) prefilter.emplace();
+            if (std::sscanf(argv[++i], "%lf:%lf", &prefilter->azimuth_min, &prefilter->azimuth_max) != 2) {
+                std::cerr << "invalid sector " << argv[i] << "\n";
+                return 2;
+            }
+        } else if (arg == "--offload" && i + 1 < argc) {
+            offload_returns = std::max(std::atol(argv[++i]), 0L);
+        } else if (arg == "--rate" && i + 1 < argc) {
+            const double hz = std::atof(argv[++i]);
+            if (!(hz > 0.0)) {
+                std::cerr << "invalid rate " << argv[i] << "\n";
+                return 2;
+            }
+            rates_hz.push_back(hz);
+        } else if (arg == "--duration" && i + 1 < argc) {
+            duration_s = std::max(std::atof(argv[++i]), 0.0);
+        } else if (arg == "--scans" && i + 1 < argc) {
+            scan_limit = std::max(std::atol(argv[++i]), 0L);
+        } else if (arg == "--history" && i + 1 < argc) {
+            history_s = std::max(std::atof(argv[++i]), 0.0);
+        } else if (arg == "--float32") {
+            precision = KernelPrecision::Float32;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (arg == "--fast") {
+            replay_fast = true;
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            metrics_port = std::atoi(argv[++i]);
+            if (metrics_port < 0 || metrics_port > 65535) metrics_port = -2;
+        } else if (arg == "--udp" && i + 1 < argc) {
+            udp_port = std::atoi(argv[++i]);
+            if (udp_port < 0 || udp_port > 65535) udp_port = -2;
+        } else if (arg == "--scenario" && i + 1 < argc) {
+            scenario_objects = std::max(std::atol(argv[++i]), 1L);
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--record FILE] [--stats FILE] [--metrics PORT] [--sink SPEC] [--cluster METRES] [--prefilter] [--sector AZMIN:AZMAX] [--float32] [--offload MIN_RETURNS] [--rate HZ]... [--duration SECONDS] [--scans N] [--history SECONDS] [--replay FILE [--fast] | --udp PORT | --scenario OBJECTS]\n";
+            return 2;
+        }
+    }
+
+    FrameRecorder recorder;
+    if (!record_path.empty() && !recorder.open(record_path)) {
+        std::cerr << "cannot create recording " << record_path << "\n";
+        return 1;
+    }
+    std::unique_ptr<TargetSink> sink;
+    if (!sink_spec.empty() && !(sink = openSink(sink_spec))) {
+        std::cerr << "cannot open sink " << sink_spec << "\n";
+        return 1;
+    }
+    FrameReplay replay(replay_fast ? ReplayMode::AsFastAsPossible : ReplayMode::RealTime);
+    if (!replay_path.empty() && !replay.open(replay_path)) {
+        std::cerr << "cannot open recording " << replay_path << "\n";
+        return 1;
+    }
+
+    if (udp_port == -2) {
+        std::cerr << "invalid UDP port\n";
+        return 2;
+    }
+    UdpIngestConfig udp_config;
+    udp_config.port = static_cast<std::uint16_t>(udp_port);
+    UdpIngest udp(udp_config);
+    if (udp_port >= 0) {
+        if (!udp.open()) {
+            std::cerr << "cannot bind UDP port " << udp_port << "\n";
+            return 1;
+        }
+        g_udp = &udp;
+    }
+
+    if (metrics_port == -2) {
+        std::cerr << "invalid metrics port\n";
+        return 2;
+    }
+    MetricsConfig metrics_config;
+    metrics_config.port = static_cast<std::uint16_t>(metrics_port);
+    MetricsExporter metrics(metrics_config);
+    if (metrics_port >= 0 && !metrics.start()) {
+        std::cerr << "cannot serve metrics on port " << metrics_port << "\n";
+        return 1;
+    }
+
+    ScenarioConfig scenario_config;
+    scenario_config.objects = static_cast<std::size_t>(scenario_objects);
+    scenario_config.clutter_per_frame = scenario_config.objects * 4;
 
-int main() {
     TargetDetector detector(0.4);
-    int scan_cycle = 1;
+    if (cluster_radius > 0.0) {
+        ClusterConfig cluster_config;
+        cluster_config.epsilon = cluster_radius;
+        detector.setClustering(cluster_config);
+    }
+    detector.setPrefilter(std::move(prefilter));
+    detector.setPrecision(precision);
+    std::unique_ptr<CudaBackend> offload;
+    if (offload_returns >= 0) {
+        if ((offload = CudaBackend::create())) {
+            detector.setOffload(offload.get(), static_cast<std::size_t>(offload_returns));
+        } else {
+            std::cerr << "no CUDA device; detecting on the CPU\n";
+        }
+    }
+    TargetTracker tracker;
+    DetectionPipeline pipeline(detector);
+    pipeline.setTracker(&tracker);
+    MonitorInterface monitor(10.0);
+    // Tracked targets, retained for --history seconds (0 keeps all), to a
+    // centimetre, a centimetre per second and 1e-4 confidence.
+    std::optional<TargetHistory> history;
+    if (history_s >= 0.0) {
+        HistoryConfig config;
+        config.position_quantum = 0.01;
+        config.velocity_quantum = 0.01;
+        config.confidence_quantum = 1e-4;
+        config.retention = std::chrono::seconds(static_cast<long>(history_s));
+        history.emplace(config);
+    }
 
     std::cout << "--- SENTINEL RADAR SYSTEM ACTIVATED ---\n";
     std::this_thread::sleep_for(1s);
 
-    while (true) {
-        auto raw_data = generateMockData();
-        auto targets = detector.detectRadarTargets(raw_data);
+    // Ctrl-C, --duration and --scans all end the stream cleanly, so a
+    // recording gets its index.
+    ScanScheduler scheduler;
+    g_scheduler = &scheduler;
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
 
-        clearScreen();
-        std::cout << "========================================\n";
-        std::cout << "      SENTINEL RADAR - LIVE FEED        \n";
-        std::cout << "========================================\n";
-        std::cout << "Scan Cycle: " << scan_cycle++ << "\n";
-        std::cout << "Raw Signals Received: " << raw_data.size() << "\n";
-        std::cout << "Active Targets Locked: " << detector.getTargetCount() << "\n";
-        std::cout << "----------------------------------------\n";
-        
-        detector.printTargets();
+    std::uint64_t scans = 0;
+    std::atomic<bool> source_done{false};
+    auto record = [&](RadarFrame& frame) {
+        if (recorder.isOpen()) recorder.write(frame, std::chrono::system_clock::now());
+        return scan_limit == 0 || ++scans < static_cast<std::uint64_t>(scan_limit);
+    };
+    auto output = [&](const ScanResult& result) {
+        monitor.updateDisplay(result.targets, result.stats);
+        if (sink) sink->write(result.targets, result.sequence);
+        if (history) history->append(result.targets);
+        if (metrics.isRunning()) {
+            const UdpIngestStats ingest = udp.stats();
+            metrics.update(result.stats, pipeline.stats(), udp.isOpen() ? &ingest : nullptr);
+        }
+    };
 
-        std::cout << "\n[Scanning for new threats...]\n";
-        std::cout << "(Press Ctrl+C to abort simulation)\n";
+    // Replay and network sources pace themselves and run on the pipeline's
+    // producer thread. Simulated sensors are coroutines on the scheduler,
+    // each on a fixed-rate cadence, so cycle time never drifts the sweep.
+    const bool self_paced = replay.isOpen() || udp.isOpen();
+    const auto started = ScanScheduler::Clock::now();
+    bool limit_reached = false;
+    // Each simulated sensor has its own scene, seeded by its index, and
+    // numbers its own sweeps.
+    struct SimulatedSensor {
+        explicit SimulatedSensor(const ScenarioConfig& config) : scenario(config) {}
+        ScenarioGenerator scenario;
+        std::uint64_t sweep{0};
+        DetectionPipeline::FrameSource fill;
+    };
+    std::deque<SimulatedSensor> simulated;
+    auto generate = [&](SimulatedSensor& sensor, RadarFrame& frame) {
+        if (limit_reached) return false;
+        if (scenario_objects > 0) {
+            const double time_s = std::chrono::duration<double>(ScanScheduler::Clock::now() - started).count();
+            sensor.scenario.generate(sensor.sweep++, time_s, frame);
+        } else {
+            generateMockData(frame);
+        }
+        limit_reached = !record(frame);
+        return true;
+    };
 
-        std::this_thread::sleep_for(1500ms);
+    // The display runs on its own stage so slow console output never
+    // delays the next scan.
+    monitor.startMonitoring();
+    std::vector<std::size_t> sensors;
+    if (self_paced) {
+        pipeline.start(
+            [&](RadarFrame& frame) {
+                const bool more = !limit_reached && !scheduler.stopRequested()
+                    && (replay.isOpen() ? replay.fill(frame) : udp.fill(frame));
+                if (more) {
+                    limit_reached = !record(frame);
+                } else {
+                    source_done.store(true, std::memory_order_release);
+                }
+                return more;
+            },
+            output);
+    } else {
+        pipeline.start(output);
+        if (rates_hz.empty()) rates_hz.push_back(1.0 / 1.5);
+        for (const double hz : rates_hz) {
+            ScenarioConfig config = scenario_config;
+            config.seed += simulated.size();
+            SimulatedSensor& sensor = simulated.emplace_back(config);
+            sensor.fill = [&generate, state = &sensor](RadarFrame& frame) { return generate(*state, frame); };
+            sensors.push_back(scheduler.addCadence(
+                std::chrono::duration_cast<ScanScheduler::Clock::duration>(std::chrono::duration<double>(1.0 / hz))));
+            scheduler.spawn(sensorLoop(scheduler, sensors.back(), pipeline, sensor.fill));
+        }
     }
+    std::optional<ScanScheduler::Clock::time_point> deadline;
+    if (duration_s > 0.0) {
+        deadline = started + std::chrono::duration_cast<ScanScheduler::Clock::duration>(
+            std::chrono::duration<double>(duration_s));
+    }
+    scheduler.spawn(supervise(scheduler, scheduler.addCadence(100ms), deadline, source_done));
+    scheduler.run();
 
+    if (udp.isOpen()) udp.stop();
+    if (!self_paced) pipeline.finish();
+    pipeline.wait();
+    g_scheduler = nullptr;
+    for (std::size_t i = 0; i < sensors.size(); ++i) {
+        const CadenceStats cadence = scheduler.stats(sensors[i]);
+        std::printf("sensor %zu at %.2f Hz: %llu scans, %llu overruns (%llu deadlines skipped), "
+                    "lateness mean %.1f us, max %.1f us\n",
+                    i, rates_hz[i], static_cast<unsigned long long>(cadence.ticks),
+                    static_cast<unsigned long long>(cadence.overruns),
+                    static_cast<unsigned long long>(cadence.skipped), cadence.mean_lateness_us,
+                    cadence.max_lateness_us);
+    }
+    if (sink) sink->flush();
+    if (history) {
+        const HistoryStats kept = history->stats();
+        HistoryQuery critical;
+        critical.min_threat = ThreatLevel::CRITICAL;
+        std::printf("history: %llu rows in %zu chunks, %.1f KiB (%.1f KiB as Targets), %zu critical\n",
+                    static_cast<unsigned long long>(kept.rows), kept.chunks,
+                    static_cast<double>(kept.bytes) / 1024.0, static_cast<double>(kept.raw_bytes) / 1024.0,
+                    history->count(critical));
+    }
+
+    if (!stats_path.empty()) {
+        std::FILE* stats = std::fopen(stats_path.c_str(), "w");
+        const bool written = stats && Instrumentation::writeJson(stats);
+        if (stats) std::fclose(stats);
+        if (!written) std::cerr << "cannot write stats to " << stats_path << "\n";
+    }
     return 0;
-}
\ No newline at end of file
+}
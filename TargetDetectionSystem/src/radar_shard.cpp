@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "RadarFrame.h"
+#include "RecordingFormat.h"
+#include "ScanScheduler.h"
+#include "ScenarioGenerator.h"
+#include "ShardTransport.h"
+#include "ShardedDetection.h"
+#include "TargetDetector.h"
+#include "TargetTracker.h"
+
+// One node of a sharded deployment over UDP: a shard worker, or the
+// coordinator merging the workers' threat reports.
+//
+// Every worker generates the same seeded scene and keeps the returns of its
+// own cell, standing in for a feed split upstream. Scans are numbered off
+// the wall clock, scan k at k / rate seconds since the Unix epoch, so
+// workers on synchronised clocks see the same scene at the same stamp;
+// they need not start together. Scene time repeats every kScenePeriodS,
+// since diving objects accelerate without bound.
+//
+// Usage: radar_shard --shard-worker ID --layout COLSxROWS --peers ADDR,ADDR,... [--report-to ADDR]
+//                    [--scenario OBJECTS] [--rate HZ] [--duration SECONDS]
+//        radar_shard --coordinator --layout COLSxROWS [--port PORT] [--top N] [--duration SECONDS]
+// ADDR is a.b.c.d:port; --peers lists every shard's address in shard order,
+// this worker's own included, and the worker binds to its port.
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr double kThreshold = 0.4;
+constexpr std::uint64_t kScenePeriodS = 30;
+
+ScanScheduler* g_scheduler = nullptr;
+
+void requestStop(int) {
+    if (g_scheduler) g_scheduler->requestStop();
+}
+
+struct NodeOptions {
+    std::optional<std::uint32_t> worker;
+    bool coordinator{false};
+    ShardLayout layout;
+    std::vector<std::string> peers;
+    std::string report_to{"127.0.0.1:47900"};
+    std::uint16_t port{47900};
+    std::size_t top_n{10};
+    std::size_t objects{200};
+    double rate_hz{10.0};
+    double duration_s{0.0};
+};
+
+// "COLSxROWS"; the cells split ScenarioConfig's default scene cube.
+bool parseLayout(const char* spec, ShardLayout& layout) {
+    unsigned columns = 0;
+    unsigned rows = 0;
+    char tail = '\0';
+    if (std::sscanf(spec, "%ux%u%c", &columns, &rows, &tail) != 2 || columns == 0 || rows == 0) return false;
+    const double extent = ScenarioConfig{}.extent;
+    layout.min_x = layout.min_y = -extent;
+    layout.max_x = layout.max_y = extent;
+    layout.columns = columns;
+    layout.rows = rows;
+    return true;
+}
+
+std::vector<std::string> splitList(std::string_view list) {
+    std::vector<std::string> items;
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        items.emplace_back(list.substr(0, comma));
+        if (comma == std::string_view::npos) break;
+        list.remove_prefix(comma + 1);
+    }
+    return items;
+}
+
+std::optional<std::uint16_t> portOf(const std::string& address) {
+    const auto colon = address.rfind(':');
+    if (colon == std::string::npos) return std::nullopt;
+    const long port = std::atol(address.c_str() + colon + 1);
+    if (port <= 0 || port > 65535) return std::nullopt;
+    return static_cast<std::uint16_t>(port);
+}
+
+std::optional<ScanScheduler::Clock::time_point> deadlineAfter(double duration_s) {
+    if (!(duration_s > 0.0)) return std::nullopt;
+    return ScanScheduler::Clock::now()
+        + std::chrono::duration_cast<ScanScheduler::Clock::duration>(std::chrono::duration<double>(duration_s));
+}
+
+bool pastDeadline(const std::optional<ScanScheduler::Clock::time_point>& deadline) {
+    return deadline && ScanScheduler::Clock::now() >= *deadline;
+}
+
+struct Worker {
+    const NodeOptions& options;
+    const ScenarioGenerator& scenario;
+    ShardWorker& shard;
+    TargetTracker& tracker;
+    RadarFrame scene;
+    RadarFrame own;
+    std::uint64_t last_sweep{0};
+};
+
+ScanScheduler::Task workerLoop(ScanScheduler& scheduler, std::size_t cadence, Worker& worker,
+                               std::optional<ScanScheduler::Clock::time_point> deadline) {
+    const NodeOptions& options = worker.options;
+    const auto report_every = static_cast<std::uint64_t>(std::max(std::lround(options.rate_hz), 1L));
+    for (;;) {
+        const bool running = co_await scheduler.tick(cadence);
+        if (!running) break;
+        if (pastDeadline(deadline)) scheduler.requestStop();
+
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        const double now_s = std::chrono::duration<double>(now).count();
+        const auto sweep = static_cast<std::uint64_t>(now_s * options.rate_hz);
+        if (sweep == worker.last_sweep) continue;
+        worker.last_sweep = sweep;
+        const double scene_s = static_cast<double>(sweep) / options.rate_hz;
+        const auto stamp = fromStampNs(static_cast<std::int64_t>(scene_s * 1e9));
+        worker.scenario.generate(sweep, std::fmod(scene_s, static_cast<double>(kScenePeriodS)), worker.scene);
+
+        worker.own.clear();
+        const RadarFrameView scene = worker.scene.view();
+        for (std::size_t i = 0; i < scene.size(); ++i) {
+            if (options.layout.shardOf(scene.x[i], scene.y[i]) == *options.worker) {
+                worker.own.push(scene.x[i], scene.y[i], scene.z[i], scene.velocity[i]);
+            }
+        }
+        const auto targets = worker.shard.scan(worker.own, stamp);
+
+        const ShardWorkerStats& stats = worker.shard.stats();
+        if (stats.scans % report_every == 0) {
+            std::printf("shard %u scan %" PRIu64 ": %zu returns, %zu targets, %zu tracks, handoffs %" PRIu64
+                        " sent %" PRIu64 " adopted, %" PRIu64 " reports, %" PRIu64 " send failures\n",
+                        *options.worker, stats.scans, worker.own.size(), targets.size(), worker.tracker.trackCount(),
+                        stats.handoffs_sent, stats.handoffs_adopted, stats.reports_sent, stats.send_failures);
+            std::fflush(stdout);
+        }
+    }
+}
+
+ScanScheduler::Task coordinatorLoop(ScanScheduler& scheduler, std::size_t cadence, ShardCoordinator& coordinator,
+                                    ShardTransport& transport,
+                                    std::optional<ScanScheduler::Clock::time_point> deadline) {
+    std::uint64_t ticks = 0;
+    for (;;) {
+        const bool running = co_await scheduler.tick(cadence);
+        if (!running) break;
+        if (pastDeadline(deadline)) scheduler.requestStop();
+        coordinator.poll(transport);
+        if (++ticks % 10 != 0) continue;
+
+        const auto threats = coordinator.topThreats();
+        const double stamp_s = std::chrono::duration<double>(coordinator.newestStamp().time_since_epoch()).count();
+        std::printf("as of %.1f s: %zu top threats\n", stamp_s, threats.size());
+        for (const TargetRecord& threat : threats) {
+            std::printf("  ID %-6u %-8s conf %.2f at (%.0f, %.0f, %.0f) vel %.1f m/s\n", threat.id,
+                        threatLevelName(static_cast<ThreatLevel>(threat.threat_level)).data(), threat.confidence,
+                        threat.x, threat.y, threat.z, threat.velocity);
+        }
+        std::fflush(stdout);
+    }
+}
+
+int runWorker(const NodeOptions& options) {
+    const std::uint32_t id = *options.worker;
+    const auto port = portOf(options.peers[id]);
+    if (!port) {
+        std::fprintf(stderr, "invalid address %s for shard %u\n", options.peers[id].c_str(), id);
+        return 2;
+    }
+    UdpShardConfig config;
+    config.port = *port;
+    config.shards = options.peers;
+    config.coordinator = options.report_to;
+    UdpShardTransport transport(config);
+    if (!transport.open()) {
+        std::fprintf(stderr, "cannot open shard %u on port %u\n", id, static_cast<unsigned>(*port));
+        return 1;
+    }
+
+    ScenarioConfig scenario_config;
+    scenario_config.objects = options.objects;
+    scenario_config.clutter_per_frame = options.objects * 4;
+    const ScenarioGenerator scenario(scenario_config);
+    TargetDetector detector(kThreshold);
+    TargetTracker tracker(ShardWorker::trackerConfig(options.layout, id));
+    ShardWorker shard(options.layout, id, detector, tracker, transport);
+    Worker worker{options, scenario, shard, tracker, {}, {}, 0};
+
+    std::printf("shard %u of %u on port %u, reporting to %s\n", id, options.layout.shardCount(),
+                static_cast<unsigned>(transport.boundPort()), options.report_to.c_str());
+    ScanScheduler scheduler;
+    g_scheduler = &scheduler;
+    // The cadence runs faster than the scan rate: scans follow the wall
+    // clock, and a tick that finds no new scan number does nothing.
+    const auto period = std::chrono::duration_cast<ScanScheduler::Clock::duration>(
+        std::chrono::duration<double>(0.25 / options.rate_hz));
+    scheduler.spawn(workerLoop(scheduler, scheduler.addCadence(period), worker, deadlineAfter(options.duration_s)));
+    scheduler.run();
+    g_scheduler = nullptr;
+    return 0;
+}
+
+int runCoordinator(const NodeOptions& options) {
+    UdpShardConfig config;
+    config.port = options.port;
+    UdpShardTransport transport(config);
+    if (!transport.open()) {
+        std::fprintf(stderr, "cannot open the coordinator on port %u\n", static_cast<unsigned>(options.port));
+        return 1;
+    }
+    ShardCoordinatorConfig coordinator_config;
+    coordinator_config.top_n = options.top_n;
+    ShardCoordinator coordinator(options.layout.shardCount(), coordinator_config);
+
+    std::printf("coordinator for %u shards on port %u\n", options.layout.shardCount(),
+                static_cast<unsigned>(transport.boundPort()));
+    ScanScheduler scheduler;
+    g_scheduler = &scheduler;
+    scheduler.spawn(coordinatorLoop(scheduler, scheduler.addCadence(100ms), coordinator, transport,
+                                    deadlineAfter(options.duration_s)));
+    scheduler.run();
+    g_scheduler = nullptr;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    NodeOptions options;
+    bool layout_given = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--shard-worker" && i + 1 < argc) {
+            options.worker = static_cast<std::uint32_t>(std::max(std::atol(argv[++i]), 0L));
+        } else if (arg == "--coordinator") {
+            options.coordinator = true;
+        } else if (arg == "--layout" && i + 1 < argc) {
+            if (!parseLayout(argv[++i], options.layout)) {
+                std::fprintf(stderr, "invalid layout %s\n", argv[i]);
+                return 2;
+            }
+            layout_given = true;
+        } else if (arg == "--peers" && i + 1 < argc) {
+            options.peers = splitList(argv[++i]);
+        } else if (arg == "--report-to" && i + 1 < argc) {
+            options.report_to = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            const long port = std::atol(argv[++i]);
+            if (port < 0 || port > 65535) {
+                std::fprintf(stderr, "invalid port %s\n", argv[i]);
+                return 2;
+            }
+            options.port = static_cast<std::uint16_t>(port);
+        } else if (arg == "--top" && i + 1 < argc) {
+            options.top_n = static_cast<std::size_t>(std::max(std::atol(argv[++i]), 1L));
+        } else if (arg == "--scenario" && i + 1 < argc) {
+            options.objects = static_cast<std::size_t>(std::max(std::atol(argv[++i]), 1L));
+        } else if (arg == "--rate" && i + 1 < argc) {
+            options.rate_hz = std::atof(argv[++i]);
+            if (!(options.rate_hz > 0.0)) {
+                std::fprintf(stderr, "invalid rate %s\n", argv[i]);
+                return 2;
+            }
+        } else if (arg == "--duration" && i + 1 < argc) {
+            options.duration_s = std::max(std::atof(argv[++i]), 0.0);
+        } else {
+            options = {};
+            layout_given = false;
+            break;
+        }
+    }
+
+    const bool worker_ok = options.worker && !options.coordinator
+        && options.peers.size() == options.layout.shardCount() && *options.worker < options.layout.shardCount();
+    if (!layout_given || !(worker_ok || (options.coordinator && !options.worker))) {
+        std::fprintf(stderr,
+                     "usage: %s --shard-worker ID --layout COLSxROWS --peers ADDR,ADDR,... [--report-to ADDR] "
+                     "[--scenario OBJECTS] [--rate HZ] [--duration SECONDS]\n"
+                     "       %s --coordinator --layout COLSxROWS [--port PORT] [--top N] [--duration SECONDS]\n",
+                     argv[0], argv[0]);
+        return 2;
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    return options.coordinator ? runCoordinator(options) : runWorker(options);
+}
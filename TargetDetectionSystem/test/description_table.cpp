@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "DescriptionTable.h"
+
+namespace {
+
+static_assert(!std::is_copy_constructible_v<DescriptionTable>);
+static_assert(!std::is_copy_assignable_v<DescriptionTable>);
+static_assert(std::is_move_constructible_v<DescriptionTable>);
+static_assert(std::is_move_assignable_v<DescriptionTable>);
+
+TEST(DescriptionTable, InternsAndReservesNone) {
+    DescriptionTable table;
+    EXPECT_EQ(table.intern(""), DescriptionTable::kNone);
+    const auto id = table.intern("inbound");
+    EXPECT_NE(id, DescriptionTable::kNone);
+    EXPECT_EQ(table.intern(std::string("inbound")), id);
+    EXPECT_EQ(table.lookup(id), "inbound");
+    EXPECT_EQ(table.lookup(DescriptionTable::kNone), "");
+    EXPECT_EQ(table.lookup(999), "");
+    EXPECT_EQ(table.size(), 1u);
+}
+
+// Short strings live inside the std::string itself, so these views survive
+// only if the move leaves the strings where they are.
+TEST(DescriptionTable, MoveKeepsLookupsAndIndex) {
+    DescriptionTable source;
+    const auto short_id = source.intern("a");
+    const auto long_id = source.intern(std::string(100, 'b'));
+
+    DescriptionTable moved(std::move(source));
+    EXPECT_EQ(moved.lookup(short_id), "a");
+    EXPECT_EQ(moved.intern("a"), short_id);
+    EXPECT_EQ(moved.intern(std::string(100, 'b')), long_id);
+
+    // The moved-from table reads as empty and interns from id 1 again.
+    EXPECT_EQ(source.size(), 0u);
+    EXPECT_EQ(source.lookup(short_id), "");
+    EXPECT_EQ(source.lookup(DescriptionTable::kNone), "");
+    EXPECT_EQ(source.intern("a"), 1u);
+    EXPECT_EQ(source.lookup(1), "a");
+    EXPECT_EQ(source.size(), 1u);
+
+    DescriptionTable assigned;
+    assigned.intern("replaced");
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.intern("a"), short_id);
+    EXPECT_EQ(assigned.lookup(long_id), std::string(100, 'b'));
+    EXPECT_EQ(assigned.intern("c"), long_id + 1);
+    EXPECT_EQ(assigned.size(), 3u);
+    EXPECT_EQ(moved.size(), 0u);
+    EXPECT_EQ(moved.lookup(long_id), "");
+}
+
+} // namespace
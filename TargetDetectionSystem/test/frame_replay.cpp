@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+#include "FrameRecorder.h"
+#include "FrameReplay.h"
+#include "RadarFrame.h"
+#include "RecordingFormat.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+const auto kStamp = std::chrono::system_clock::time_point{} + 1'700'000'000s;
+constexpr std::size_t kFrames = 5;
+
+std::string tempPath(const char* name) {
+    return ::testing::TempDir() + "frame_replay_" + name + ".rec";
+}
+
+std::vector<char> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+void writeFile(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// Frame i holds i * 3 returns, so frame 0 is empty; every value is
+// distinct and carries its frame and return index.
+RadarFrame frameAt(std::size_t i) {
+    RadarFrame frame;
+    for (std::size_t r = 0; r < i * 3; ++r) {
+        const double base = static_cast<double>(i * 1000 + r);
+        frame.push(base + 0.25, -base, base * 1e-3, std::nextafter(base, 0.0));
+    }
+    return frame;
+}
+
+std::chrono::system_clock::time_point stampAt(std::size_t i) {
+    return kStamp + static_cast<std::int64_t>(i) * 100ms;
+}
+
+std::string record(const char* name) {
+    const std::string path = tempPath(name);
+    FrameRecorder recorder;
+    EXPECT_TRUE(recorder.open(path));
+    for (std::size_t i = 0; i < kFrames; ++i) EXPECT_TRUE(recorder.write(frameAt(i).view(), stampAt(i)));
+    EXPECT_EQ(recorder.frameCount(), kFrames);
+    EXPECT_TRUE(recorder.close());
+    return path;
+}
+
+RecordingHeader headerOf(const std::vector<char>& bytes) {
+    RecordingHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    return header;
+}
+
+void setHeader(std::vector<char>& bytes, const RecordingHeader& header) {
+    std::memcpy(bytes.data(), &header, sizeof(header));
+}
+
+// Offset of frame i in a file written by record().
+std::size_t offsetOf(std::size_t i) {
+    std::size_t offset = sizeof(RecordingHeader);
+    for (std::size_t f = 0; f < i; ++f) offset += frameRecordBytes(f * 3);
+    return offset;
+}
+
+void expectFrame(const ReplayFrame& replayed, std::size_t i) {
+    EXPECT_EQ(replayed.index, i);
+    EXPECT_EQ(replayed.stamp, stampAt(i));
+    const RadarFrame expected = frameAt(i);
+    ASSERT_EQ(replayed.view.size(), expected.size());
+    for (std::size_t r = 0; r < expected.size(); ++r) {
+        EXPECT_EQ(replayed.view.x[r], expected.x[r]);
+        EXPECT_EQ(replayed.view.y[r], expected.y[r]);
+        EXPECT_EQ(replayed.view.z[r], expected.z[r]);
+        EXPECT_EQ(replayed.view.velocity[r], expected.velocity[r]);
+    }
+}
+
+void expectFrames(FrameReplay& replay, std::size_t frames) {
+    ASSERT_EQ(replay.frameCount(), frames);
+    for (std::size_t i = 0; i < frames; ++i) {
+        const auto replayed = replay.next();
+        ASSERT_TRUE(replayed);
+        expectFrame(*replayed, i);
+    }
+    EXPECT_FALSE(replay.next());
+}
+
+TEST(FrameReplay, RoundTripsAFinishedRecording) {
+    FrameReplay replay;
+    ASSERT_TRUE(replay.open(record("finished")));
+    expectFrames(replay, kFrames);
+
+    for (std::size_t i = kFrames; i-- > 0;) expectFrame(replay.frame(i), i);
+
+    RadarFrame copy;
+    ASSERT_TRUE(replay.seek(4));
+    ASSERT_TRUE(replay.fill(copy));
+    EXPECT_EQ(copy.velocity, frameAt(4).velocity);
+    EXPECT_FALSE(replay.fill(copy));
+}
+
+TEST(FrameReplay, SeeksByIndexAndTime) {
+    FrameReplay replay;
+    ASSERT_TRUE(replay.open(record("seek")));
+
+    ASSERT_TRUE(replay.seek(3));
+    EXPECT_EQ(replay.next()->index, 3u);
+    EXPECT_TRUE(replay.seek(kFrames));
+    EXPECT_FALSE(replay.next());
+    EXPECT_FALSE(replay.seek(kFrames + 1));
+    EXPECT_EQ(replay.position(), kFrames);
+
+    // The first frame stamped at or after the time.
+    ASSERT_TRUE(replay.seekTime(stampAt(2)));
+    EXPECT_EQ(replay.position(), 2u);
+    ASSERT_TRUE(replay.seekTime(stampAt(2) + 1ns));
+    EXPECT_EQ(replay.position(), 3u);
+    ASSERT_TRUE(replay.seekTime(kStamp - 1h));
+    EXPECT_EQ(replay.position(), 0u);
+    ASSERT_TRUE(replay.seekTime(stampAt(kFrames)));
+    EXPECT_EQ(replay.position(), kFrames);
+}
+
+TEST(FrameReplay, UnfinishedRecordingIsWalked) {
+    std::vector<char> bytes = readFile(record("unfinished_source"));
+    // As the recorder leaves it before close(): no counts, no index.
+    RecordingHeader header = headerOf(bytes);
+    bytes.resize(header.index_offset);
+    header.frame_count = 0;
+    header.index_offset = 0;
+    setHeader(bytes, header);
+    const std::string path = tempPath("unfinished");
+    writeFile(path, bytes);
+
+    FrameReplay replay;
+    ASSERT_TRUE(replay.open(path));
+    expectFrames(replay, kFrames);
+    ASSERT_TRUE(replay.seekTime(stampAt(1)));
+    EXPECT_EQ(replay.position(), 1u);
+}
+
+TEST(FrameReplay, TruncatedRecordingKeepsItsWholeFrames) {
+    const std::vector<char> finished = readFile(record("truncated_source"));
+    const std::string path = tempPath("truncated");
+
+    // Cut inside frame 3: the index now points past the end, so the file
+    // is walked and the partial frame is left out.
+    std::vector<char> bytes(finished.begin(), finished.begin() + static_cast<std::ptrdiff_t>(offsetOf(3) + 40));
+    writeFile(path, bytes);
+    FrameReplay replay;
+    ASSERT_TRUE(replay.open(path));
+    expectFrames(replay, 3);
+
+    // Cut inside the index alone: every frame is still there.
+    bytes.assign(finished.begin(), finished.end() - 4);
+    writeFile(path, bytes);
+    ASSERT_TRUE(replay.open(path));
+    expectFrames(replay, kFrames);
+
+    // Header only.
+    bytes.assign(finished.begin(), finished.begin() + sizeof(RecordingHeader));
+    writeFile(path, bytes);
+    ASSERT_TRUE(replay.open(path));
+    EXPECT_EQ(replay.frameCount(), 0u);
+}
+
+TEST(FrameReplay, CorruptFrameCountFallsBackToWalking) {
+    const std::vector<char> finished = readFile(record("corrupt_source"));
+    const std::string path = tempPath("corrupt");
+    // Counts whose byte size wraps to something small, and the largest.
+    for (const std::uint64_t count : {(std::uint64_t{1} << 61) + 1, std::numeric_limits<std::uint64_t>::max(),
+                                      std::uint64_t{kFrames + 1}}) {
+        SCOPED_TRACE(count);
+        std::vector<char> bytes = finished;
+        RecordingHeader header = headerOf(bytes);
+        header.frame_count = count;
+        setHeader(bytes, header);
+        writeFile(path, bytes);
+
+        FrameReplay replay;
+        ASSERT_TRUE(replay.open(path));
+        expectFrames(replay, kFrames);
+    }
+}
+
+TEST(FrameReplay, RejectsWhatIsNotARecording) {
+    const std::string path = tempPath("invalid");
+    FrameReplay replay;
+    EXPECT_FALSE(replay.open(tempPath("missing")));
+
+    writeFile(path, {});
+    EXPECT_FALSE(replay.open(path));
+
+    std::vector<char> bytes = readFile(record("invalid_source"));
+    bytes[0] = 'X';
+    writeFile(path, bytes);
+    EXPECT_FALSE(replay.open(path));
+    EXPECT_FALSE(replay.isOpen());
+
+    bytes.resize(sizeof(RecordingHeader) - 1);
+    writeFile(path, bytes);
+    EXPECT_FALSE(replay.open(path));
+}
+
+} // namespace
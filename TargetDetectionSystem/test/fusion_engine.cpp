@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "FusionEngine.h"
+#include "RadarFrame.h"
+#include "TargetDetector.h"
+#include "TargetTracker.h"
+#include "ThreadPool.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+using TimePoint = std::chrono::system_clock::time_point;
+
+// Off the window grid on purpose: the grid is anchored at the first report.
+const auto kEpoch = TimePoint{} + 1'700'000'000s + 30ms;
+
+SensorSpec sensorNamed(const char* name, double sigma = 10.0) {
+    SensorSpec spec;
+    spec.name = name;
+    spec.position_sigma = {sigma, sigma, sigma};
+    return spec;
+}
+
+RadarFrame oneReturn(double x, double y = 0.0) {
+    RadarFrame frame;
+    frame.push(x, y, 0.0, 50.0);
+    return frame;
+}
+
+// Target's operator== compares threat and confidence only.
+bool sameTarget(const Target& a, const Target& b) {
+    const auto bits = [](double v) { return std::bit_cast<std::uint64_t>(v); };
+    return a.id == b.id && a.description_id == b.description_id && a.threat_level == b.threat_level
+        && bits(a.x) == bits(b.x) && bits(a.y) == bits(b.y) && bits(a.z) == bits(b.z)
+        && bits(a.velocity) == bits(b.velocity) && bits(a.confidence) == bits(b.confidence)
+        && a.detection_time == b.detection_time;
+}
+
+struct SeenWindow {
+    TimePoint start;
+    TimePoint end;
+    std::size_t sensors;
+    std::vector<Target> targets;
+};
+
+TEST(FusionEngine, CutsWindowsOnTheSharedGridUpToTheWatermark) {
+    FusionEngine engine(100ms);
+    const std::size_t radar = engine.addSensor(sensorNamed("radar"));
+    const std::size_t eo = engine.addSensor(sensorNamed("eo"));
+    ASSERT_TRUE(engine.submit(radar, kEpoch, oneReturn(100.0).view()));
+    ASSERT_TRUE(engine.submit(radar, kEpoch + 50ms, oneReturn(110.0).view()));
+    ASSERT_TRUE(engine.submit(eo, kEpoch + 70ms, oneReturn(-300.0).view()));
+    ASSERT_TRUE(engine.submit(eo, kEpoch + 120ms, oneReturn(-310.0).view()));
+    // Nothing from 200 to 400 ms: those windows are skipped.
+    ASSERT_TRUE(engine.submit(radar, kEpoch + 430ms, oneReturn(120.0).view()));
+
+    std::vector<SeenWindow> seen;
+    const auto collect = [&](const FusionWindow& window) {
+        seen.push_back({window.start, window.end, window.sensors, {window.targets.begin(), window.targets.end()}});
+    };
+
+    // The first window ends at 100 ms, past the watermark.
+    EXPECT_EQ(engine.fuse(kEpoch + 99ms, collect), 0u);
+    // A window ending exactly at the watermark is complete.
+    EXPECT_EQ(engine.fuse(kEpoch + 100ms, collect), 1u);
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0].start, kEpoch);
+    EXPECT_EQ(seen[0].end, kEpoch + 100ms);
+    EXPECT_EQ(seen[0].sensors, 2u);
+    ASSERT_EQ(seen[0].targets.size(), 3u);
+    for (const Target& target : seen[0].targets) {
+        // Stamped with the window's latest report.
+        EXPECT_EQ(target.detection_time, kEpoch + 70ms);
+        EXPECT_NE(target.id, 0u);
+    }
+    EXPECT_EQ(engine.getDescriptions().lookup(seen[0].targets[0].description_id), "radar");
+    EXPECT_EQ(engine.getDescriptions().lookup(seen[0].targets[2].description_id), "eo");
+    EXPECT_EQ(engine.lastWindow().end, kEpoch + 100ms);
+
+    EXPECT_EQ(engine.fuse(kEpoch + 1s, collect), 2u);
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_EQ(seen[1].start, kEpoch + 100ms);
+    EXPECT_EQ(seen[1].sensors, 1u);
+    EXPECT_EQ(seen[2].start, kEpoch + 400ms);
+    EXPECT_EQ(seen[2].end, kEpoch + 500ms);
+    ASSERT_EQ(seen[2].targets.size(), 1u);
+    EXPECT_EQ(seen[2].targets[0].detection_time, kEpoch + 430ms);
+    // Nothing left to fuse.
+    EXPECT_EQ(engine.fuse(kEpoch + 10s, collect), 0u);
+    EXPECT_EQ(engine.lateReports(), 0u);
+}
+
+TEST(FusionEngine, RejectsReportsOutOfOrderOrBehindTheFusedWindows) {
+    FusionEngine engine(100ms);
+    const std::size_t a = engine.addSensor(sensorNamed("a"));
+    const std::size_t b = engine.addSensor(sensorNamed("b"));
+    ASSERT_TRUE(engine.submit(a, kEpoch, oneReturn(100.0).view()));
+    ASSERT_TRUE(engine.submit(a, kEpoch + 250ms, oneReturn(100.0).view()));
+    // Older than a's last report.
+    EXPECT_FALSE(engine.submit(a, kEpoch + 240ms, oneReturn(100.0).view()));
+    // Order is per sensor: b may still report earlier than a's last.
+    EXPECT_TRUE(engine.submit(b, kEpoch + 40ms, oneReturn(-100.0).view()));
+    EXPECT_EQ(engine.lateReports(), 1u);
+
+    ASSERT_EQ(engine.fuse(kEpoch + 200ms), 1u);
+    // Behind a fused window, though in order for b.
+    EXPECT_FALSE(engine.submit(b, kEpoch + 90ms, oneReturn(-100.0).view()));
+    EXPECT_FALSE(engine.submit(b, kEpoch - 1s, oneReturn(-100.0).view()));
+    EXPECT_EQ(engine.lateReports(), 3u);
+    // The fused window ended at 100 ms, so a report after it still counts.
+    EXPECT_TRUE(engine.submit(b, kEpoch + 100ms, oneReturn(-100.0).view()));
+
+    std::size_t remaining_returns = 0;
+    engine.fuse(kEpoch + 1s, [&](const FusionWindow& window) { remaining_returns += window.targets.size(); });
+    // b's 100 ms report and a's 250 ms one.
+    EXPECT_EQ(remaining_returns, 2u);
+}
+
+// Both sensors see one stationary target, 20 m apart. The fused track
+// follows the low-noise sensor whichever it is.
+double fusedX(double sigma_a, double sigma_b) {
+    FusionEngine engine(100ms);
+    const std::size_t a = engine.addSensor(sensorNamed("a", sigma_a));
+    const std::size_t b = engine.addSensor(sensorNamed("b", sigma_b));
+    for (int scan = 0; scan < 20; ++scan) {
+        const auto stamp = kEpoch + scan * 100ms;
+        EXPECT_TRUE(engine.submit(a, stamp, oneReturn(500.0).view()));
+        EXPECT_TRUE(engine.submit(b, stamp + 10ms, oneReturn(520.0).view()));
+    }
+    EXPECT_EQ(engine.fuse(kEpoch + 2s), 20u);
+
+    // One track, corrected by both.
+    const FusionWindow& last = engine.lastWindow();
+    EXPECT_EQ(engine.tracker().trackCount(), 1u);
+    EXPECT_EQ(last.sensors, 2u);
+    EXPECT_EQ(last.targets.size(), 2u);
+    if (last.targets.size() == 2) {
+        EXPECT_EQ(last.targets[0].id, last.targets[1].id);
+    }
+    return engine.tracker().track(0).x;
+}
+
+TEST(FusionEngine, EachSensorCorrectsTheTrackWithItsOwnNoise) {
+    const double precise_a = fusedX(1.0, 50.0);
+    const double precise_b = fusedX(50.0, 1.0);
+    EXPECT_NEAR(precise_a, 500.0, 1.0);
+    EXPECT_NEAR(precise_b, 520.0, 1.0);
+    // Equal noise lands in between.
+    EXPECT_NEAR(fusedX(10.0, 10.0), 510.0, 2.0);
+}
+
+std::vector<SeenWindow> fuseScene(ThreadPool* pool) {
+    FusionEngine engine(100ms);
+    engine.setThreadPool(pool);
+    constexpr std::size_t kSensors = 4;
+    for (std::size_t s = 0; s < kSensors; ++s) {
+        SensorSpec spec = sensorNamed(("sensor" + std::to_string(s)).c_str(), 5.0 + 10.0 * s);
+        spec.confidence_threshold = s == 3 ? 0.0 : 0.4;
+        engine.addSensor(spec);
+    }
+
+    // Forty objects moving across the field, each sensor seeing them with
+    // its own noise, rate and phase.
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> start(-1500.0, 1500.0);
+    std::vector<double> ox(40), oy(40);
+    for (std::size_t o = 0; o < ox.size(); ++o) {
+        ox[o] = start(rng);
+        oy[o] = start(rng);
+    }
+    std::vector<SeenWindow> seen;
+    const auto collect = [&](const FusionWindow& window) {
+        seen.push_back({window.start, window.end, window.sensors, {window.targets.begin(), window.targets.end()}});
+    };
+    for (int step = 0; step < 60; ++step) {
+        for (std::size_t s = 0; s < kSensors; ++s) {
+            if (step % (s + 1) != 0) continue;
+            std::normal_distribution<double> noise(0.0, 5.0 + 10.0 * s);
+            RadarFrame frame;
+            for (std::size_t o = 0; o < ox.size(); ++o) {
+                frame.push(ox[o] + 3.0 * step + noise(rng), oy[o] - 2.0 * step + noise(rng), noise(rng),
+                           30.0 + static_cast<double>(o));
+            }
+            engine.submit(s, kEpoch + step * 50ms + s * 7ms, frame.view());
+        }
+        if (step % 5 == 4) engine.fuse(kEpoch + step * 50ms, collect);
+    }
+    engine.fuse(kEpoch + 1h, collect);
+    return seen;
+}
+
+TEST(FusionEngine, PoolAndSerialRunsAreIdentical) {
+    ThreadPool pool(3);
+    const auto serial = fuseScene(nullptr);
+    const auto parallel = fuseScene(&pool);
+    ASSERT_EQ(parallel.size(), serial.size());
+    ASSERT_GT(serial.size(), 20u);
+    std::size_t targets = 0;
+    for (std::size_t w = 0; w < serial.size(); ++w) {
+        EXPECT_EQ(parallel[w].start, serial[w].start);
+        EXPECT_EQ(parallel[w].sensors, serial[w].sensors);
+        ASSERT_EQ(parallel[w].targets.size(), serial[w].targets.size());
+        for (std::size_t t = 0; t < serial[w].targets.size(); ++t) {
+            EXPECT_TRUE(sameTarget(parallel[w].targets[t], serial[w].targets[t])) << "window " << w << " target " << t;
+        }
+        targets += serial[w].targets.size();
+    }
+    EXPECT_GT(targets, 1000u);
+}
+
+} // namespace
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "DetectionKernel.h"
+#include "RadarFrame.h"
+
+// Every backend and precision against calculateThreat, at and one ulp
+// either side of each doctrine boundary, on signed zeros and NaN, over a
+// frame whose length is no multiple of any lane width.
+
+namespace {
+
+constexpr double kThreshold = 0.4;
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// A boundary value and its neighbours, one double ulp and one float ulp
+// away on each side.
+std::vector<double> around(double value) {
+    const auto f = static_cast<float>(value);
+    return {std::nextafter(value, -kInf), value, std::nextafter(value, kInf),
+            static_cast<double>(std::nextafter(f, -std::numeric_limits<float>::infinity())),
+            static_cast<double>(std::nextafter(f, std::numeric_limits<float>::infinity()))};
+}
+
+struct Case {
+    double x, y, z, velocity;
+};
+
+std::vector<Case> boundaryCases() {
+    std::vector<double> ranges = {0.0, -0.0, kNaN, kInf};
+    for (const double r : {500.0, 1000.0}) {
+        for (const double v : around(r)) ranges.push_back(v);
+    }
+    std::vector<double> speeds = {0.0, -0.0, kNaN, kInf, -kInf};
+    for (const double s : {50.0, 100.0}) {
+        for (const double v : around(s)) {
+            speeds.push_back(v);
+            speeds.push_back(-v);
+        }
+    }
+
+    // A range along one axis is exact: sqrt(r * r) == |r|. Rotating the
+    // axis puts boundary ranges in every column.
+    std::vector<Case> cases;
+    std::size_t axis = 0;
+    for (const double r : ranges) {
+        for (const double v : speeds) {
+            Case c{0.0, 0.0, 0.0, v};
+            (axis == 0 ? c.x : axis == 1 ? c.y : c.z) = (axis % 2 ? -r : r);
+            axis = (axis + 1) % 3;
+            cases.push_back(c);
+        }
+    }
+    // Off-axis returns, then a tail that no lane width divides.
+    cases.push_back({300.0, 400.0, 0.0, 100.0});
+    cases.push_back({-0.0, -0.0, -0.0, -0.0});
+    cases.push_back({kNaN, 1.0, 1.0, 60.0});
+    while (cases.size() % 16 != 13) cases.push_back({1.5 * static_cast<double>(cases.size()), 7.0, -3.0, 75.0});
+    return cases;
+}
+
+RadarFrame frameOf(const std::vector<Case>& cases) {
+    RadarFrame frame;
+    for (const Case& c : cases) frame.push(c.x, c.y, c.z, c.velocity);
+    return frame;
+}
+
+struct Result {
+    KernelScratch scratch;
+    KernelOutput out;
+    std::size_t selected{};
+};
+
+void run(KernelBackend backend, KernelPrecision precision, const RadarFrame& frame, Result& result) {
+    result.out = result.scratch.prepare(frame.size());
+    result.selected = DetectionKernel::run(backend, frame.view(), kThreshold, result.out, precision);
+}
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+using Param = std::tuple<KernelBackend, KernelPrecision>;
+
+class KernelParity : public ::testing::TestWithParam<Param> {};
+
+TEST_P(KernelParity, MatchesCalculateThreatAndScalar) {
+    const auto [backend, precision] = GetParam();
+    if (!KernelDispatch::isSupported(backend)) {
+        GTEST_SKIP() << KernelDispatch::backendName(backend) << " not supported by this CPU";
+    }
+
+    const auto cases = boundaryCases();
+    ASSERT_NE(cases.size() % 8, 0u);
+    const RadarFrame frame = frameOf(cases);
+    Result reference;
+    Result result;
+    run(KernelBackend::Scalar, precision, frame, reference);
+    run(backend, precision, frame, result);
+
+    const bool f32 = precision == KernelPrecision::Float32;
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        const Case& c = cases[i];
+        SCOPED_TRACE("return " + std::to_string(i) + " at (" + std::to_string(c.x) + ", " + std::to_string(c.y) +
+                     ", " + std::to_string(c.z) + ") velocity " + std::to_string(c.velocity));
+        EXPECT_TRUE(sameBits(result.out.range[i], reference.out.range[i]));
+        EXPECT_TRUE(sameBits(result.out.confidence[i], reference.out.confidence[i]));
+        EXPECT_EQ(result.out.threat[i], reference.out.threat[i]);
+
+        // The float path classifies the float-rounded velocity against the
+        // float range it reports; both widen to double exactly.
+        const double velocity = f32 ? static_cast<double>(static_cast<float>(c.velocity)) : c.velocity;
+        EXPECT_EQ(static_cast<ThreatLevel>(result.out.threat[i]),
+                  DetectionKernel::calculateThreat(velocity, result.out.range[i]));
+
+        // On an axis the range is the coordinate itself.
+        const int axes = (c.x != 0.0) + (c.y != 0.0) + (c.z != 0.0);
+        if (axes == 1 && !std::isnan(c.x + c.y + c.z)) {
+            const double r = std::abs(c.x + c.y + c.z);
+            EXPECT_TRUE(sameBits(result.out.range[i], f32 ? static_cast<double>(static_cast<float>(r)) : r));
+        }
+    }
+
+    ASSERT_EQ(result.selected, reference.selected);
+    for (std::size_t k = 0; k < result.selected; ++k) EXPECT_EQ(result.out.selected[k], reference.out.selected[k]);
+}
+
+// The boundaries themselves, spelled out: strict comparisons, so exactly
+// 500 m, 1000 m, 50 m/s and 100 m/s fall on the lower side.
+TEST(KernelParity, ExactBoundariesClassifyAsDoctrine) {
+    EXPECT_EQ(DetectionKernel::calculateThreat(100.0, 499.0), ThreatLevel::HIGH);
+    EXPECT_EQ(DetectionKernel::calculateThreat(std::nextafter(100.0, kInf), 499.0), ThreatLevel::CRITICAL);
+    EXPECT_EQ(DetectionKernel::calculateThreat(-std::nextafter(100.0, kInf), 499.0), ThreatLevel::CRITICAL);
+    EXPECT_EQ(DetectionKernel::calculateThreat(200.0, 500.0), ThreatLevel::HIGH);
+    EXPECT_EQ(DetectionKernel::calculateThreat(200.0, std::nextafter(500.0, 0.0)), ThreatLevel::CRITICAL);
+    EXPECT_EQ(DetectionKernel::calculateThreat(0.0, 1000.0), ThreatLevel::LOW);
+    EXPECT_EQ(DetectionKernel::calculateThreat(0.0, std::nextafter(1000.0, 0.0)), ThreatLevel::HIGH);
+    EXPECT_EQ(DetectionKernel::calculateThreat(50.0, 2000.0), ThreatLevel::LOW);
+    EXPECT_EQ(DetectionKernel::calculateThreat(std::nextafter(50.0, kInf), 2000.0), ThreatLevel::MEDIUM);
+    EXPECT_EQ(DetectionKernel::calculateThreat(-0.0, 0.0), ThreatLevel::HIGH);
+    EXPECT_EQ(DetectionKernel::calculateThreat(kNaN, 100.0), ThreatLevel::HIGH);
+    EXPECT_EQ(DetectionKernel::calculateThreat(kNaN, kNaN), ThreatLevel::LOW);
+}
+
+std::string paramName(const ::testing::TestParamInfo<Param>& info) {
+    const auto [backend, precision] = info.param;
+    return std::string(KernelDispatch::backendName(backend)) + "_" +
+           std::string(KernelDispatch::precisionName(precision));
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, KernelParity,
+                         ::testing::Combine(::testing::Values(KernelBackend::Scalar, KernelBackend::AVX2,
+                                                              KernelBackend::AVX512),
+                                            ::testing::Values(KernelPrecision::Float64, KernelPrecision::Float32)),
+                         paramName);
+
+} // namespace
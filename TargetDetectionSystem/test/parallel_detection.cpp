@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "RadarFrame.h"
+#include "ReturnPrefilter.h"
+#include "TargetDetector.h"
+#include "ThreadPool.h"
+
+// A pooled detector against a serial one over the same frames: same ids,
+// same fields, same order, for every chunking, ordering and prefilter.
+
+namespace {
+
+constexpr double kThreshold = 0.5;
+
+// detection_time is stamped per scan and so differs between detectors;
+// everything else must match to the bit.
+bool sameTarget(const Target& a, const Target& b) {
+    const auto bits = [](double v) { return std::bit_cast<std::uint64_t>(v); };
+    return a.id == b.id && a.description_id == b.description_id && a.threat_level == b.threat_level
+        && bits(a.x) == bits(b.x) && bits(a.y) == bits(b.y) && bits(a.z) == bits(b.z)
+        && bits(a.velocity) == bits(b.velocity) && bits(a.confidence) == bits(b.confidence);
+}
+
+// Frames of differing length, none a multiple of any chunk size tried,
+// one empty, with every threat level represented.
+std::vector<RadarFrame> makeFrames() {
+    std::mt19937_64 rng(6);
+    std::uniform_real_distribution<double> coord(-1500.0, 1500.0);
+    std::uniform_real_distribution<double> speed(-250.0, 250.0);
+    std::vector<RadarFrame> frames;
+    for (const std::size_t returns : {3001u, 0u, 1777u, 5u}) {
+        RadarFrame& frame = frames.emplace_back();
+        for (std::size_t i = 0; i < returns; ++i) frame.push(coord(rng), coord(rng), coord(rng) * 0.2, speed(rng));
+    }
+    return frames;
+}
+
+PrefilterConfig prefilter() {
+    PrefilterConfig config;
+    config.max_range = 1800.0;
+    config.azimuth_min = -120.0;
+    config.azimuth_max = 150.0;
+    config.exclusions.push_back({-200.0, -200.0, -500.0, 300.0, 200.0, 500.0});
+    return config;
+}
+
+void configure(TargetDetector& detector, TargetOrdering ordering, bool prefiltered) {
+    detector.setOrdering(ordering, ordering == TargetOrdering::ThreatBuckets ? 25 : 0);
+    if (prefiltered) detector.setPrefilter(prefilter());
+}
+
+std::vector<std::vector<Target>> scanAll(TargetDetector& detector, const std::vector<RadarFrame>& frames) {
+    std::vector<std::vector<Target>> results;
+    for (const RadarFrame& frame : frames) {
+        auto& out = results.emplace_back();
+        detector.scan(frame.view(), out);
+    }
+    return results;
+}
+
+void expectSame(const std::vector<std::vector<Target>>& actual, const std::vector<std::vector<Target>>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t f = 0; f < actual.size(); ++f) {
+        ASSERT_EQ(actual[f].size(), expected[f].size()) << "frame " << f;
+        for (std::size_t t = 0; t < actual[f].size(); ++t) {
+            EXPECT_TRUE(sameTarget(actual[f][t], expected[f][t])) << "frame " << f << " target " << t;
+        }
+        for (const Target& target : actual[f]) {
+            EXPECT_EQ(target.detection_time, actual[f].front().detection_time) << "frame " << f;
+        }
+    }
+}
+
+using Mode = std::tuple<std::size_t, TargetOrdering, bool>;
+
+class ParallelDetection : public ::testing::TestWithParam<Mode> {};
+
+TEST_P(ParallelDetection, MatchesSerial) {
+    const auto [chunk_size, ordering, prefiltered] = GetParam();
+    const std::vector<RadarFrame> frames = makeFrames();
+    ThreadPool pool(3);
+
+    TargetDetector serial(kThreshold);
+    TargetDetector parallel(kThreshold);
+    configure(serial, ordering, prefiltered);
+    configure(parallel, ordering, prefiltered);
+    parallel.setThreadPool(&pool, chunk_size);
+
+    const auto expected = scanAll(serial, frames);
+    ASSERT_GT(expected[0].size(), 100u);
+    expectSame(scanAll(parallel, frames), expected);
+    // Ids are dense and run on across frames rather than restarting.
+    std::vector<std::uint32_t> ids;
+    for (const auto& targets : expected) {
+        for (const Target& target : targets) ids.push_back(target.id);
+    }
+    std::sort(ids.begin(), ids.end());
+    for (std::size_t i = 0; i < ids.size(); ++i) EXPECT_EQ(ids[i], i + 1);
+}
+
+std::string modeName(const ::testing::TestParamInfo<Mode>& info) {
+    const auto [chunk_size, ordering, prefiltered] = info.param;
+    const char* ordering_name = ordering == TargetOrdering::FullSort        ? "FullSort"
+                              : ordering == TargetOrdering::ThreatBuckets ? "ThreatBuckets"
+                                                                          : "None";
+    return "Chunk" + std::to_string(chunk_size) + ordering_name + (prefiltered ? "Prefiltered" : "");
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Modes, ParallelDetection,
+    ::testing::Combine(::testing::Values(std::size_t{1}, std::size_t{7}, std::size_t{256}, std::size_t{4096}),
+                       ::testing::Values(TargetOrdering::FullSort, TargetOrdering::ThreatBuckets,
+                                         TargetOrdering::None),
+                       ::testing::Bool()),
+    modeName);
+
+// Detectors sharing one pool and scanning from inside its own parallelFor:
+// their chunk loops run serially on whichever thread holds the task.
+TEST(ParallelDetection, NestedInPoolMatchesSerial) {
+    const std::vector<RadarFrame> frames = makeFrames();
+    ThreadPool pool(3);
+    constexpr std::size_t kDetectors = 6;
+
+    std::vector<std::unique_ptr<TargetDetector>> nested;
+    std::vector<std::vector<std::vector<Target>>> results(kDetectors);
+    for (std::size_t d = 0; d < kDetectors; ++d) {
+        nested.push_back(std::make_unique<TargetDetector>(kThreshold));
+        configure(*nested[d], static_cast<TargetOrdering>(d % 3), d % 2 == 1);
+        nested[d]->setThreadPool(&pool, 64);
+    }
+    pool.parallelFor(kDetectors, [&](std::size_t d) { results[d] = scanAll(*nested[d], frames); });
+
+    for (std::size_t d = 0; d < kDetectors; ++d) {
+        SCOPED_TRACE("detector " + std::to_string(d));
+        TargetDetector serial(kThreshold);
+        configure(serial, static_cast<TargetOrdering>(d % 3), d % 2 == 1);
+        expectSame(results[d], scanAll(serial, frames));
+    }
+}
+
+} // namespace
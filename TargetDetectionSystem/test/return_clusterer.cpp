@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "ReturnClusterer.h"
+#include "ThreadPool.h"
+#include "ThreatLevel.h"
+
+namespace {
+
+constexpr std::uint32_t kNoise = ReturnClusterer::kNoise;
+
+// Owning columns behind a ClusterInput.
+struct Returns {
+    std::vector<double> x, y, z, velocity, confidence;
+    std::vector<std::uint8_t> threat;
+
+    void push(double px, double py, double pz, double v = 0.0, double c = 0.5,
+              ThreatLevel level = ThreatLevel::LOW) {
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        velocity.push_back(v);
+        confidence.push_back(c);
+        threat.push_back(static_cast<std::uint8_t>(level));
+    }
+    ClusterInput input() const { return {x, y, z, velocity, confidence, threat}; }
+    std::size_t size() const { return x.size(); }
+};
+
+// Blobs of varying density with scattered noise between them.
+Returns denseScene(std::size_t returns) {
+    std::mt19937_64 rng(21);
+    std::uniform_real_distribution<double> field(-3000.0, 3000.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> spread(0.0, 12.0);
+    std::vector<std::array<double, 3>> centres(returns / 40);
+    for (auto& c : centres) c = {field(rng), field(rng), field(rng) * 0.1};
+
+    Returns scene;
+    for (std::size_t i = 0; i < returns; ++i) {
+        const double confidence = unit(rng);
+        const auto level = static_cast<ThreatLevel>(i % 4);
+        if (i % 10 == 0) {
+            scene.push(field(rng), field(rng), field(rng) * 0.1, unit(rng) * 300.0, confidence, level);
+            continue;
+        }
+        const auto& c = centres[i % centres.size()];
+        scene.push(c[0] + spread(rng), c[1] + spread(rng), c[2] + spread(rng), unit(rng) * 300.0, confidence,
+                   level);
+    }
+    return scene;
+}
+
+// The result the header promises, by brute force: core returns joined
+// through core neighbours, borders on their nearest core return (lowest
+// index on a tie), clusters numbered by their lowest-index member.
+std::vector<std::uint32_t> referenceLabels(const Returns& r, const ClusterConfig& config) {
+    const std::size_t n = r.size();
+    const double eps_sq = config.epsilon * config.epsilon;
+    const auto d2 = [&](std::size_t i, std::size_t j) {
+        const double dx = r.x[i] - r.x[j];
+        const double dy = r.y[i] - r.y[j];
+        const double dz = r.z[i] - r.z[j];
+        return dx * dx + dy * dy + dz * dz;
+    };
+    std::vector<bool> core(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t neighbours = 0;
+        for (std::size_t j = 0; j < n; ++j) neighbours += d2(i, j) <= eps_sq;
+        core[i] = neighbours >= config.min_points;
+    }
+    std::vector<std::size_t> root(n);
+    std::iota(root.begin(), root.end(), std::size_t{0});
+    const auto find = [&](std::size_t i) {
+        while (root[i] != i) i = root[i];
+        return i;
+    };
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!core[i]) continue;
+        for (std::size_t j = 0; j < i; ++j) {
+            if (core[j] && d2(i, j) <= eps_sq) {
+                const std::size_t a = find(i);
+                const std::size_t b = find(j);
+                if (a != b) root[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+    std::vector<std::size_t> owner(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (core[i]) {
+            owner[i] = find(i);
+            continue;
+        }
+        double best = std::numeric_limits<double>::infinity();
+        for (std::size_t j = 0; j < n; ++j) {
+            if (core[j] && d2(i, j) <= eps_sq && d2(i, j) < best) {
+                best = d2(i, j);
+                owner[i] = find(j);
+            }
+        }
+    }
+    std::vector<std::uint32_t> labels(n, kNoise);
+    std::vector<std::uint32_t> label_of(n, kNoise);
+    std::uint32_t next = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (owner[i] == n) continue;
+        if (label_of[owner[i]] == kNoise) label_of[owner[i]] = next++;
+        labels[i] = label_of[owner[i]];
+    }
+    return labels;
+}
+
+bool sameCluster(const ReturnCluster& a, const ReturnCluster& b) {
+    const auto bits = [](double v) { return std::bit_cast<std::uint64_t>(v); };
+    return bits(a.x) == bits(b.x) && bits(a.y) == bits(b.y) && bits(a.z) == bits(b.z)
+        && bits(a.velocity) == bits(b.velocity) && bits(a.confidence) == bits(b.confidence)
+        && a.threat_level == b.threat_level && a.size == b.size;
+}
+
+class ClustererDensity : public ::testing::TestWithParam<std::size_t> {};
+
+TEST_P(ClustererDensity, PoolMatchesSerialAndTheReference) {
+    const Returns scene = denseScene(4000);
+    ClusterConfig config;
+    config.min_points = GetParam();
+    // Small chunks, so the pool splits every pass many ways.
+    config.chunk_size = 64;
+    ThreadPool pool(3);
+
+    ReturnClusterer serial(config);
+    ReturnClusterer parallel(config);
+    const auto expected = serial.cluster(scene.input());
+    const auto clusters = parallel.cluster(scene.input(), &pool);
+
+    const std::vector<std::uint32_t> reference = referenceLabels(scene, config);
+    const std::vector<std::uint32_t> serial_labels(serial.labels().begin(), serial.labels().end());
+    const std::vector<std::uint32_t> parallel_labels(parallel.labels().begin(), parallel.labels().end());
+    EXPECT_EQ(serial_labels, reference);
+    EXPECT_EQ(parallel_labels, serial_labels);
+    ASSERT_EQ(clusters.size(), expected.size());
+    for (std::size_t k = 0; k < clusters.size(); ++k) {
+        EXPECT_TRUE(sameCluster(clusters[k], expected[k])) << "cluster " << k;
+    }
+
+    // Dense enough that merging and, past min_points 1, noise both happen.
+    EXPECT_LT(clusters.size(), scene.size() / 4);
+    const auto noise = std::count(serial_labels.begin(), serial_labels.end(), kNoise);
+    if (config.min_points > 1) {
+        EXPECT_GT(noise, 0);
+    } else {
+        EXPECT_EQ(noise, 0);
+    }
+
+    // Reusing the clusterer gives the same answer again.
+    parallel.cluster(scene.input(), &pool);
+    EXPECT_EQ(std::vector<std::uint32_t>(parallel.labels().begin(), parallel.labels().end()), serial_labels);
+}
+
+INSTANTIATE_TEST_SUITE_P(MinPoints, ClustererDensity, ::testing::Values(1u, 4u, 8u));
+
+// Along the x axis with epsilon 10 and min_points 4:
+//     returns 0-3  core group at 125..132
+//     return  4    border at 116, 9 m from 125 and from 107
+//     returns 5-8  core group at 100..107, not within epsilon of the first
+//     return  9    border at 140, 8 m from 132
+//     return  10   noise at 200
+Returns borderScene() {
+    Returns r;
+    for (const double x : {125.0, 128.0, 130.0, 132.0}) r.push(x, 0.0, 0.0);
+    r.push(116.0, 0.0, 0.0);
+    for (const double x : {100.0, 102.0, 104.0, 107.0}) r.push(x, 0.0, 0.0);
+    r.push(140.0, 0.0, 0.0);
+    r.push(200.0, 0.0, 0.0);
+    return r;
+}
+
+TEST(ReturnClusterer, BorderReturnsJoinTheirNearestCoreWithoutBridging) {
+    const Returns scene = borderScene();
+    ClusterConfig config;
+    config.epsilon = 10.0;
+    config.min_points = 4;
+    ReturnClusterer clusterer(config);
+    const auto clusters = clusterer.cluster(scene.input());
+
+    ASSERT_EQ(clusters.size(), 2u);
+    const std::vector<std::uint32_t> labels(clusterer.labels().begin(), clusterer.labels().end());
+    // Equidistant from both groups: the lower index, 0, wins.
+    EXPECT_EQ(labels, (std::vector<std::uint32_t>{0, 0, 0, 0, 0, 1, 1, 1, 1, 0, kNoise}));
+    EXPECT_EQ(clusters[0].size, 6u);
+    EXPECT_EQ(clusters[1].size, 4u);
+    EXPECT_EQ(labels, referenceLabels(scene, config));
+
+    // At the default min_points of 1 nothing is noise and return 4 is core,
+    // bridging the two groups.
+    config.min_points = 1;
+    clusterer.setConfig(config);
+    ASSERT_EQ(clusterer.cluster(scene.input()).size(), 2u);
+    EXPECT_EQ(std::vector<std::uint32_t>(clusterer.labels().begin(), clusterer.labels().end()),
+              (std::vector<std::uint32_t>{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}));
+}
+
+TEST(ReturnClusterer, FusesByConfidence) {
+    Returns scene;
+    scene.push(0.0, 0.0, 0.0, 100.0, 0.5, ThreatLevel::MEDIUM);
+    scene.push(4.0, 8.0, -2.0, 200.0, 0.25, ThreatLevel::CRITICAL);
+    scene.push(2.0, 2.0, 2.0, 50.0, 0.8, ThreatLevel::LOW);
+    // Two zero-confidence returns far away: an unweighted mean, confidence 0.
+    scene.push(1000.0, 0.0, 0.0, 10.0, 0.0, ThreatLevel::HIGH);
+    scene.push(1010.0, 0.0, 0.0, 30.0, 0.0, ThreatLevel::LOW);
+
+    ClusterConfig config;
+    config.epsilon = 15.0;
+    ReturnClusterer clusterer(config);
+    const auto clusters = clusterer.cluster(scene.input());
+    ASSERT_EQ(clusters.size(), 2u);
+
+    const double w = 0.5 + 0.25 + 0.8;
+    EXPECT_DOUBLE_EQ(clusters[0].x, (0.25 * 4.0 + 0.8 * 2.0) / w);
+    EXPECT_DOUBLE_EQ(clusters[0].y, (0.25 * 8.0 + 0.8 * 2.0) / w);
+    EXPECT_DOUBLE_EQ(clusters[0].z, (0.25 * -2.0 + 0.8 * 2.0) / w);
+    EXPECT_DOUBLE_EQ(clusters[0].velocity, (0.5 * 100.0 + 0.25 * 200.0 + 0.8 * 50.0) / w);
+    EXPECT_DOUBLE_EQ(clusters[0].confidence, 1.0 - 0.5 * 0.75 * 0.2);
+    EXPECT_EQ(clusters[0].threat_level, ThreatLevel::CRITICAL);
+    EXPECT_EQ(clusters[0].size, 3u);
+
+    EXPECT_DOUBLE_EQ(clusters[1].x, 1005.0);
+    EXPECT_DOUBLE_EQ(clusters[1].velocity, 20.0);
+    EXPECT_EQ(clusters[1].confidence, 0.0);
+    EXPECT_EQ(clusters[1].threat_level, ThreatLevel::HIGH);
+}
+
+TEST(ReturnClusterer, EmptyInputGivesNoClusters) {
+    ReturnClusterer clusterer;
+    EXPECT_TRUE(clusterer.cluster(Returns{}.input()).empty());
+    EXPECT_TRUE(clusterer.labels().empty());
+}
+
+} // namespace
@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "RadarFrame.h"
+#include "ReturnPrefilter.h"
+
+// Every backend against a reference written with sqrt and atan2, away from
+// the gate boundaries where the two formulations may round differently,
+// and against the scalar path everywhere, boundaries included.
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+constexpr double kDegrees = 180.0 / std::numbers::pi;
+// Reference decisions this close to a boundary are not compared.
+constexpr double kMargin = 1e-6;
+
+struct Point {
+    double x, y, z;
+};
+
+// nullopt when the point is too close to a boundary to judge.
+std::optional<bool> referenceKeeps(const PrefilterConfig& config, double range_limit, const Point& p) {
+    if (std::isnan(p.x) || std::isnan(p.y) || std::isnan(p.z)) return true;
+    bool keep = true;
+    // Azimuth and elevation are undefined on the axis.
+    bool near = p.x == 0.0 && p.y == 0.0;
+    const auto gate = [&](double value, double lo, double hi) {
+        near |= std::abs(value - lo) < kMargin || std::abs(value - hi) < kMargin;
+        keep &= value >= lo && value <= hi;
+    };
+
+    const double max_range = config.gate_on_threshold ? std::min(config.max_range, range_limit) : config.max_range;
+    gate(std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z), config.min_range, max_range);
+
+    const double sweep = config.azimuth_max - config.azimuth_min;
+    if (sweep < 360.0) {
+        const double normalised = sweep - 360.0 * std::floor(sweep / 360.0);
+        double offset = std::atan2(p.y, p.x) * kDegrees - config.azimuth_min;
+        offset -= 360.0 * std::floor(offset / 360.0);
+        near |= offset < kMargin || 360.0 - offset < kMargin;
+        gate(offset, 0.0, normalised);
+    }
+    const double elevation = std::atan2(p.z, std::hypot(p.x, p.y)) * kDegrees;
+    gate(elevation, config.elevation_min, config.elevation_max);
+
+    for (const ExclusionBox& b : config.exclusions) {
+        const bool inside = p.x >= b.min_x && p.x <= b.max_x && p.y >= b.min_y && p.y <= b.max_y
+                         && p.z >= b.min_z && p.z <= b.max_z;
+        keep &= !inside;
+    }
+    if (near) return std::nullopt;
+    return keep;
+}
+
+std::vector<Point> samplePoints() {
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> coord(-3000.0, 3000.0);
+    std::vector<Point> points;
+    for (int i = 0; i < 4000; ++i) points.push_back({coord(rng), coord(rng), coord(rng) * 0.3});
+    // Gate and box boundaries exactly, NaN and a tail no lane width divides.
+    points.push_back({1000.0, 0.0, 0.0});
+    points.push_back({0.0, -2000.0, 0.0});
+    points.push_back({100.0, 100.0, 0.0});
+    points.push_back({0.0, 0.0, 0.0});
+    points.push_back({-0.0, -0.0, -0.0});
+    points.push_back({kNaN, 5.0, 5.0});
+    points.push_back({5.0, kNaN, 5.0});
+    points.push_back({5.0, 5.0, kNaN});
+    points.push_back({kInf, 0.0, 0.0});
+    while (points.size() % 16 != 11) points.push_back({3.0 * static_cast<double>(points.size()), 1.0, 2.0});
+    return points;
+}
+
+RadarFrame frameOf(const std::vector<Point>& points) {
+    RadarFrame frame;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        frame.push(points[i].x, points[i].y, points[i].z, static_cast<double>(i));
+    }
+    return frame;
+}
+
+struct NamedConfig {
+    const char* name;
+    PrefilterConfig config;
+    double range_limit;
+};
+
+std::vector<NamedConfig> configs() {
+    std::vector<NamedConfig> out;
+    out.push_back({"open", {}, kInf});
+
+    PrefilterConfig range;
+    range.min_range = 200.0;
+    range.max_range = 2000.0;
+    out.push_back({"range", range, 1500.0});
+    range.gate_on_threshold = false;
+    out.push_back({"range_without_threshold_gate", range, 1500.0});
+
+    PrefilterConfig narrow;
+    narrow.azimuth_min = -30.0;
+    narrow.azimuth_max = 60.0;
+    out.push_back({"narrow_sector", narrow, kInf});
+    // Reversed: sweeps the long way round, 270 degrees.
+    PrefilterConfig wide;
+    wide.azimuth_min = 60.0;
+    wide.azimuth_max = -30.0;
+    out.push_back({"wide_sector", wide, kInf});
+
+    PrefilterConfig elevation;
+    elevation.elevation_min = -5.0;
+    elevation.elevation_max = 20.0;
+    out.push_back({"elevation", elevation, kInf});
+    PrefilterConfig high;
+    high.elevation_min = 10.0;
+    out.push_back({"elevation_above", high, kInf});
+    PrefilterConfig low;
+    low.elevation_max = -10.0;
+    out.push_back({"elevation_below", low, kInf});
+
+    PrefilterConfig boxes;
+    boxes.exclusions.push_back({-500.0, -500.0, -1000.0, 500.0, 500.0, 1000.0});
+    boxes.exclusions.push_back({100.0, 100.0, 0.0, 2500.0, 150.0, 0.0});
+    out.push_back({"exclusions", boxes, kInf});
+
+    PrefilterConfig all = boxes;
+    all.min_range = 100.0;
+    all.max_range = 2800.0;
+    all.azimuth_min = 170.0;
+    all.azimuth_max = 100.0;
+    all.elevation_min = -30.0;
+    all.elevation_max = 30.0;
+    out.push_back({"combined", all, 2500.0});
+    return out;
+}
+
+ReturnPrefilter makeFilter(const NamedConfig& named) {
+    ReturnPrefilter filter(named.config);
+    filter.setRangeLimit(named.range_limit);
+    return filter;
+}
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+class PrefilterParity : public ::testing::TestWithParam<KernelBackend> {};
+
+TEST_P(PrefilterParity, MatchesReferenceAndScalar) {
+    const KernelBackend backend = GetParam();
+    if (!KernelDispatch::isSupported(backend)) {
+        GTEST_SKIP() << KernelDispatch::backendName(backend) << " not supported by this CPU";
+    }
+    const auto points = samplePoints();
+    const RadarFrame frame = frameOf(points);
+
+    for (const NamedConfig& named : configs()) {
+        SCOPED_TRACE(named.name);
+        const ReturnPrefilter filter = makeFilter(named);
+        PrefilterScratch scalar_scratch;
+        PrefilterScratch scratch;
+        const PrefilterColumns expected = scalar_scratch.prepare(frame.size());
+        const PrefilterColumns out = scratch.prepare(frame.size());
+        const std::size_t expected_count = filter.apply(KernelBackend::Scalar, frame.view(), expected);
+        const std::size_t count = filter.apply(backend, frame.view(), out);
+
+        ASSERT_EQ(count, expected_count);
+        for (std::size_t k = 0; k < count; ++k) {
+            EXPECT_TRUE(sameBits(out.x[k], expected.x[k]));
+            EXPECT_TRUE(sameBits(out.y[k], expected.y[k]));
+            EXPECT_TRUE(sameBits(out.z[k], expected.z[k]));
+            EXPECT_EQ(out.velocity[k], expected.velocity[k]);
+        }
+
+        // Velocity carries the input index, so survivors can be matched
+        // back; they must come out in input order.
+        std::vector<bool> kept(points.size(), false);
+        for (std::size_t k = 0; k < count; ++k) {
+            const auto index = static_cast<std::size_t>(out.velocity[k]);
+            if (k > 0) {
+                EXPECT_LT(out.velocity[k - 1], out.velocity[k]);
+            }
+            kept[index] = true;
+        }
+        std::size_t judged = 0;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            const auto reference = referenceKeeps(named.config, named.range_limit, points[i]);
+            if (!reference) continue;
+            ++judged;
+            EXPECT_EQ(kept[i], *reference) << "return " << i << " at (" << points[i].x << ", " << points[i].y
+                                           << ", " << points[i].z << ")";
+        }
+        EXPECT_GT(judged, points.size() * 9 / 10);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, PrefilterParity,
+                         ::testing::Values(KernelBackend::Scalar, KernelBackend::AVX2, KernelBackend::AVX512),
+                         [](const auto& info) { return std::string(KernelDispatch::backendName(info.param)); });
+
+TEST(ReturnPrefilter, GateBoundariesAreInclusive) {
+    PrefilterConfig config;
+    config.min_range = 100.0;
+    config.max_range = 1000.0;
+    config.exclusions.push_back({-10.0, -10.0, -10.0, 10.0, 10.0, 10.0});
+    const ReturnPrefilter filter(config);
+    RadarFrame frame;
+    frame.push(100.0, 0.0, 0.0, 1.0);
+    frame.push(0.0, -1000.0, 0.0, 2.0);
+    frame.push(std::nextafter(100.0, 0.0), 0.0, 0.0, 3.0);
+    frame.push(0.0, 0.0, std::nextafter(1000.0, kInf), 4.0);
+    PrefilterScratch scratch;
+    const PrefilterColumns out = scratch.prepare(frame.size());
+    ASSERT_EQ(filter.apply(KernelBackend::Scalar, frame.view(), out), 2u);
+    EXPECT_EQ(out.velocity[0], 1.0);
+    EXPECT_EQ(out.velocity[1], 2.0);
+
+    // On the exclusion box faces counts as inside.
+    PrefilterConfig boxed;
+    boxed.exclusions.push_back({-10.0, -10.0, -10.0, 10.0, 10.0, 10.0});
+    RadarFrame faces;
+    faces.push(10.0, -10.0, 0.0, 1.0);
+    faces.push(std::nextafter(10.0, kInf), 0.0, 0.0, 2.0);
+    ASSERT_EQ(ReturnPrefilter(boxed).apply(KernelBackend::Scalar, faces.view(), out), 1u);
+    EXPECT_EQ(out.velocity[0], 2.0);
+}
+
+TEST(ReturnPrefilter, NegativeRangeLimitRejectsEverything) {
+    ReturnPrefilter filter;
+    filter.setRangeLimit(-1.0);
+    RadarFrame frame;
+    frame.push(0.0, 0.0, 0.0, 1.0);
+    frame.push(-0.0, 0.0, 0.0, 1.0);
+    frame.push(1.0, 2.0, 3.0, 1.0);
+    PrefilterScratch scratch;
+    EXPECT_EQ(filter.apply(frame.view(), scratch.prepare(frame.size())), 0u);
+    filter.setRangeLimit(kInf);
+    EXPECT_EQ(filter.apply(frame.view(), scratch.prepare(frame.size())), 3u);
+}
+
+} // namespace
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "ScanScheduler.h"
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = ScanScheduler::Clock;
+
+constexpr auto kPeriod = 40ms;
+constexpr auto kOverrun = 4 * kPeriod;
+
+// The second cycle runs several periods long. How many deadlines that
+// skips depends on how late the sleep wakes, so the test checks the
+// invariants rather than exact counts.
+ScanScheduler::Task overrunning(ScanScheduler& s, std::size_t cadence, std::vector<Clock::time_point>& ticks,
+                                Clock::time_point& woke) {
+    for (;;) {
+        const bool running = co_await s.tick(cadence);
+        if (!running) break;
+        ticks.push_back(Clock::now());
+        if (ticks.size() == 2) {
+            std::this_thread::sleep_for(kOverrun);
+            woke = Clock::now();
+        }
+        if (ticks.size() == 3) s.requestStop();
+    }
+}
+
+TEST(ScanScheduler, OverrunSkipsMissedDeadlinesAndKeepsPhase) {
+    ScanScheduler scheduler;
+    const std::size_t cadence = scheduler.addCadence(kPeriod);
+    std::vector<Clock::time_point> ticks;
+    Clock::time_point woke{};
+    scheduler.spawn(overrunning(scheduler, cadence, ticks, woke));
+    scheduler.run();
+
+    ASSERT_EQ(ticks.size(), 3u);
+    const CadenceStats stats = scheduler.stats(cadence);
+    EXPECT_EQ(stats.ticks, 3u);
+    EXPECT_EQ(stats.overruns, 1u);
+    ASSERT_GE(stats.skipped, 1u);
+    EXPECT_GE(stats.max_lateness_us, stats.mean_lateness_us);
+
+    // Deadlines stay on the first tick's grid: the third resumes at
+    // first + (2 + skipped) * period, the first deadline after the sleep,
+    // plus at most the worst lateness measured. The first tick resumes
+    // straight away, so ticks[0] stands in for the grid origin.
+    const auto deadline = (2 + static_cast<long>(stats.skipped)) * kPeriod;
+    const auto lateness = std::chrono::duration<double, std::micro>(stats.max_lateness_us);
+    EXPECT_GE(ticks[1] - ticks[0], kPeriod);
+    EXPECT_GT(ticks[0] + deadline, woke);
+    EXPECT_GE(ticks[2] - ticks[0] + 1ms, deadline);
+    EXPECT_LE(ticks[2] - ticks[0], deadline + lateness + 1ms);
+}
+
+ScanScheduler::Task counting(ScanScheduler& s, std::size_t cadence, int stop_after, int& count) {
+    for (;;) {
+        const bool running = co_await s.tick(cadence);
+        if (!running) break;
+        if (++count == stop_after) s.requestStop();
+    }
+}
+
+TEST(ScanScheduler, CadencesTickIndependentlyAndStopEndsAll) {
+    ScanScheduler scheduler;
+    const std::size_t fast = scheduler.addCadence(5ms);
+    const std::size_t slow = scheduler.addCadence(1h);
+    int fast_count = 0;
+    int slow_count = 0;
+    scheduler.spawn(counting(scheduler, fast, 10, fast_count));
+    scheduler.spawn(counting(scheduler, slow, 0, slow_count));
+    const auto start = Clock::now();
+    scheduler.run();
+
+    // The slow coroutine is parked an hour out; the stop releases it.
+    EXPECT_LT(Clock::now() - start, 10s);
+    EXPECT_EQ(fast_count, 10);
+    EXPECT_EQ(slow_count, 1);
+    EXPECT_EQ(scheduler.stats(fast).ticks, 10u);
+    EXPECT_EQ(scheduler.stats(slow).ticks, 1u);
+    EXPECT_EQ(scheduler.stats(slow).overruns, 0u);
+}
+
+TEST(ScanScheduler, StopFromAnotherThreadWakesTheLoop) {
+    ScanScheduler scheduler;
+    const std::size_t cadence = scheduler.addCadence(1h);
+    int count = 0;
+    scheduler.spawn(counting(scheduler, cadence, 0, count));
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(20ms);
+        scheduler.requestStop();
+    });
+    const auto start = Clock::now();
+    scheduler.run();
+    stopper.join();
+    EXPECT_LT(Clock::now() - start, 10s);
+    EXPECT_EQ(count, 1);
+}
+
+// Reproducer for the note in ScanScheduler.h. With an awaiter that is
+// ready at once, a loop whose condition is, or tests, the co_await itself
+// must run three times and finish; GCC 12.2 at -O0 and -O2 runs it zero
+// times and leaves the coroutine suspended, or crashes.
+struct Countdown {
+    int& remaining;
+    bool await_ready() const noexcept { return true; }
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    bool await_resume() const noexcept { return remaining-- > 0; }
+};
+
+struct Probe {
+    struct promise_type {
+        Probe get_return_object() noexcept { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+    std::coroutine_handle<promise_type> handle;
+};
+
+Probe awaitInWhile(int& remaining, int& loops) {
+    while (co_await Countdown{remaining}) ++loops;
+}
+
+Probe awaitInIf(int& remaining, int& loops) {
+    for (;;) {
+        if (!(co_await Countdown{remaining})) break;
+        ++loops;
+    }
+}
+
+Probe awaitIntoLocal(int& remaining, int& loops) {
+    for (;;) {
+        const bool more = co_await Countdown{remaining};
+        if (!more) break;
+        ++loops;
+    }
+}
+
+TEST(ScanScheduler, AwaitIntoALocalRunsOnEveryCompiler) {
+    int remaining = 3;
+    int loops = 0;
+    const Probe probe = awaitIntoLocal(remaining, loops);
+    probe.handle.resume();
+    EXPECT_TRUE(probe.handle.done());
+    EXPECT_EQ(loops, 3);
+    probe.handle.destroy();
+}
+
+bool runsToCompletion(Probe (*coroutine)(int&, int&)) {
+    int remaining = 3;
+    int loops = 0;
+    const Probe probe = coroutine(remaining, loops);
+    probe.handle.resume();
+    const bool correct = probe.handle.done() && loops == 3;
+    probe.handle.destroy();
+    return correct;
+}
+
+// Skips rather than fails where the compiler is affected, so the result
+// shows whether the note still applies. The probe runs in a child process
+// where there is one, since a miscompiled frame may also crash.
+TEST(ScanScheduler, AwaitAsConditionCompilerCheck) {
+    for (const auto coroutine : {awaitInWhile, awaitInIf}) {
+#ifdef __linux__
+        const pid_t child = ::fork();
+        ASSERT_GE(child, 0);
+        if (child == 0) ::_exit(runsToCompletion(coroutine) ? 0 : 1);
+        int status = 0;
+        ASSERT_EQ(::waitpid(child, &status, 0), child);
+        const bool correct = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+        const bool correct = runsToCompletion(coroutine);
+#endif
+        if (!correct) GTEST_SKIP() << "this compiler miscompiles co_await in a condition";
+    }
+}
+
+} // namespace
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "SeqLock.h"
+
+namespace {
+
+// Several words, all carrying the same counter, so a torn read shows up as
+// words that disagree. The odd size leaves a partial last word.
+struct Snapshot {
+    std::uint64_t words[5];
+    std::uint32_t tail;
+};
+
+Snapshot snapshotOf(std::uint64_t value) {
+    Snapshot snapshot{};
+    for (auto& word : snapshot.words) word = value;
+    snapshot.tail = static_cast<std::uint32_t>(value);
+    return snapshot;
+}
+
+TEST(SeqLock, StartsDefaultAndCountsStores) {
+    SeqLock<Snapshot> lock;
+    EXPECT_EQ(lock.version(), 1u);
+    EXPECT_EQ(lock.load().words[0], 0u);
+    lock.store(snapshotOf(7));
+    lock.store(snapshotOf(8));
+    EXPECT_EQ(lock.version(), 3u);
+    const Snapshot snapshot = lock.load();
+    EXPECT_EQ(snapshot.words[4], 8u);
+    EXPECT_EQ(snapshot.tail, 8u);
+}
+
+TEST(SeqLock, ReadersNeverSeeATornOrOlderValue) {
+    SeqLock<Snapshot> lock;
+    constexpr std::uint64_t kStores = 200000;
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> torn{0};
+    std::atomic<std::uint64_t> backwards{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            std::uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const Snapshot snapshot = lock.load();
+                const std::uint64_t value = snapshot.words[0];
+                bool consistent = snapshot.tail == static_cast<std::uint32_t>(value);
+                for (const auto word : snapshot.words) consistent &= word == value;
+                if (!consistent) torn.fetch_add(1, std::memory_order_relaxed);
+                if (value < last) backwards.fetch_add(1, std::memory_order_relaxed);
+                last = value;
+            }
+        });
+    }
+    for (std::uint64_t i = 1; i <= kStores; ++i) {
+        lock.store(snapshotOf(i));
+        // Let readers in between stores even on one core.
+        if (i % 1024 == 0) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(backwards.load(), 0u);
+    EXPECT_EQ(lock.load().words[0], kStores);
+    EXPECT_EQ(lock.version(), kStores + 1);
+}
+
+} // namespace
@@ -0,0 +1,327 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "RadarFrame.h"
+#include "ShardTransport.h"
+#include "ShardedDetection.h"
+#include "TargetDetector.h"
+#include "TargetTracker.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+const auto kStamp = std::chrono::system_clock::time_point{} + 1'700'000'000s;
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+std::vector<TrackView> sampleTracks() {
+    std::vector<TrackView> tracks;
+    for (std::uint32_t i = 0; i < 5; ++i) {
+        TrackView track;
+        track.id = 0xfffffff0u + i;
+        track.x = -1234.5 + i;
+        track.y = 1e-300 * i;
+        track.z = i == 2 ? -0.0 : 17.25;
+        track.vx = std::numeric_limits<double>::max();
+        track.vy = -250.0 + i;
+        track.vz = std::nextafter(1.0, 2.0);
+        track.position_variance = 25.0 * i;
+        track.velocity_variance = 900.0;
+        track.hits = 0xffffffffu - i;
+        track.misses = 7;
+        tracks.push_back(track);
+    }
+    return tracks;
+}
+
+TEST(ShardHandoff, RoundTripsEveryFieldExactly) {
+    const auto tracks = sampleTracks();
+    std::vector<std::byte> datagram(handoffRecordBytes(tracks.size()));
+    ASSERT_EQ(ShardWorker::encodeHandoff(datagram, 3, 42, kStamp + 123ns, tracks), datagram.size());
+
+    std::vector<TrackView> decoded(1);
+    std::chrono::system_clock::time_point stamp;
+    ASSERT_TRUE(ShardWorker::decodeHandoff(datagram, decoded, stamp));
+    EXPECT_EQ(stamp, kStamp + 123ns);
+    // Appended after what was already there.
+    ASSERT_EQ(decoded.size(), tracks.size() + 1);
+    for (std::size_t i = 0; i < tracks.size(); ++i) {
+        const TrackView& in = tracks[i];
+        const TrackView& out = decoded[i + 1];
+        EXPECT_EQ(out.id, in.id);
+        EXPECT_EQ(out.hits, in.hits);
+        // Handed-off tracks arrive as associated.
+        EXPECT_EQ(out.misses, 0u);
+        EXPECT_TRUE(sameBits(out.x, in.x));
+        EXPECT_TRUE(sameBits(out.y, in.y));
+        EXPECT_TRUE(sameBits(out.z, in.z));
+        EXPECT_TRUE(sameBits(out.vx, in.vx));
+        EXPECT_TRUE(sameBits(out.vy, in.vy));
+        EXPECT_TRUE(sameBits(out.vz, in.vz));
+        EXPECT_TRUE(sameBits(out.position_variance, in.position_variance));
+        EXPECT_TRUE(sameBits(out.velocity_variance, in.velocity_variance));
+    }
+}
+
+TEST(ShardHandoff, EmptyBatchRoundTrips) {
+    std::vector<std::byte> datagram(handoffRecordBytes(0));
+    ASSERT_EQ(ShardWorker::encodeHandoff(datagram, 0, 1, kStamp, {}), kShardHeaderBytes);
+    std::vector<TrackView> decoded;
+    std::chrono::system_clock::time_point stamp;
+    EXPECT_TRUE(ShardWorker::decodeHandoff(datagram, decoded, stamp));
+    EXPECT_TRUE(decoded.empty());
+}
+
+TEST(ShardHandoff, RejectsMalformedDatagrams) {
+    const auto tracks = sampleTracks();
+    std::vector<std::byte> datagram(handoffRecordBytes(tracks.size()));
+    EXPECT_EQ(ShardWorker::encodeHandoff(std::span(datagram).first(datagram.size() - 1), 0, 1, kStamp, tracks), 0u);
+    ASSERT_EQ(ShardWorker::encodeHandoff(datagram, 0, 1, kStamp, tracks), datagram.size());
+
+    std::vector<TrackView> decoded;
+    std::chrono::system_clock::time_point stamp;
+    EXPECT_FALSE(ShardWorker::decodeHandoff(std::span(datagram).first(datagram.size() - 8), decoded, stamp));
+    EXPECT_FALSE(ShardWorker::decodeHandoff(std::span(datagram).first(kShardHeaderBytes - 1), decoded, stamp));
+    auto wrong_magic = datagram;
+    wrong_magic[0] ^= std::byte{1};
+    EXPECT_FALSE(ShardWorker::decodeHandoff(wrong_magic, decoded, stamp));
+    EXPECT_TRUE(decoded.empty());
+}
+
+TrackerConfig shardTracker(std::uint32_t shard) {
+    return ShardWorker::trackerConfig(ShardLayout{}, shard);
+}
+
+TrackView handoffAt(std::uint32_t id, double x, std::uint32_t hits) {
+    TrackView track;
+    track.id = id;
+    track.x = x;
+    track.position_variance = 100.0;
+    track.velocity_variance = 900.0;
+    track.hits = hits;
+    return track;
+}
+
+void scanOne(TargetTracker& tracker, double x, std::chrono::system_clock::time_point stamp) {
+    std::vector<Target> detections = {Target(0, x, 0.0, 0.0, 0.0, 0.9, ThreatLevel::HIGH)};
+    tracker.update(detections, stamp);
+}
+
+TEST(ShardHandoff, AdoptionReplacesYoungerLocalDuplicate) {
+    TargetTracker tracker(shardTracker(1));
+    scanOne(tracker, 10.0, kStamp);
+    ASSERT_EQ(tracker.trackCount(), 1u);
+    const std::uint32_t local = tracker.track(0).id;
+
+    // Shard 0's track of the same target, older than the local one.
+    EXPECT_TRUE(tracker.adoptTrack(handoffAt(1, -10.0, 4), kStamp));
+    ASSERT_EQ(tracker.trackCount(), 1u);
+    EXPECT_EQ(tracker.track(0).id, 1u);
+    EXPECT_NE(tracker.track(0).id, local);
+    EXPECT_EQ(tracker.track(0).hits, 4u);
+}
+
+TEST(ShardHandoff, AdoptionYieldsToOlderLocalTrack) {
+    TargetTracker tracker(shardTracker(1));
+    for (int scan = 0; scan < 5; ++scan) scanOne(tracker, 10.0, kStamp + scan * 100ms);
+    ASSERT_EQ(tracker.trackCount(), 1u);
+    const std::uint32_t local = tracker.track(0).id;
+
+    EXPECT_FALSE(tracker.adoptTrack(handoffAt(1, -10.0, 2), kStamp + 400ms));
+    ASSERT_EQ(tracker.trackCount(), 1u);
+    EXPECT_EQ(tracker.track(0).id, local);
+}
+
+TEST(ShardHandoff, AdoptionOutsideTheGateAddsATrack) {
+    TargetTracker tracker(shardTracker(1));
+    scanOne(tracker, 10.0, kStamp);
+    EXPECT_TRUE(tracker.adoptTrack(handoffAt(1, -1000.0, 4), kStamp));
+    EXPECT_EQ(tracker.trackCount(), 2u);
+}
+
+// A target that shard 1 picks up before shard 0's handoff arrives is
+// reported under one id once the handoff is adopted.
+TEST(ShardHandoff, CoordinatorCountsACrossingTargetOnce) {
+    LoopbackShardNetwork network(2);
+    const ShardLayout layout;
+    TargetDetector detector0(0.4);
+    TargetDetector detector1(0.4);
+    TargetTracker tracker0(ShardWorker::trackerConfig(layout, 0));
+    TargetTracker tracker1(ShardWorker::trackerConfig(layout, 1));
+    ShardWorker shard0(layout, 0, detector0, tracker0, network.endpoint(0));
+    ShardWorker shard1(layout, 1, detector1, tracker1, network.endpoint(1));
+    ShardCoordinator coordinator(2);
+
+    RadarFrame west;
+    west.push(-5.0, 0.0, 0.0, 150.0);
+    RadarFrame east;
+    east.push(5.0, 0.0, 0.0, 150.0);
+
+    // Shard 1 sees the edge of the target first, and its handoff to shard
+    // 0 is lost, so each shard spawns a track of its own.
+    shard1.scan(east, kStamp);
+    while (!network.endpoint(0).receive().empty()) {}
+    shard0.scan(west, kStamp);
+    shard0.scan(west, kStamp + 100ms);
+    shard1.scan(east, kStamp + 100ms);
+    EXPECT_GT(shard1.stats().handoffs_adopted, 0u);
+    ASSERT_EQ(tracker1.trackCount(), 1u);
+    EXPECT_EQ(tracker1.track(0).id, tracker0.track(0).id);
+
+    coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+    const auto threats = coordinator.topThreats();
+    ASSERT_EQ(threats.size(), 1u);
+    EXPECT_EQ(threats[0].id, tracker0.track(0).id);
+}
+
+TEST(ShardCoordinator, KeepsOneRecordPerTrackAndDropsLaggingShards) {
+    LoopbackShardNetwork network(2);
+    ShardLayout layout;
+    layout.handoff_margin = 0.0;
+    TargetDetector detector0(0.4);
+    TargetDetector detector1(0.4);
+    TargetTracker tracker0(ShardWorker::trackerConfig(layout, 0));
+    TargetTracker tracker1(ShardWorker::trackerConfig(layout, 1));
+    ShardWorker shard0(layout, 0, detector0, tracker0, network.endpoint(0));
+    ShardWorker shard1(layout, 1, detector1, tracker1, network.endpoint(1));
+    ShardCoordinatorConfig config;
+    config.max_lag = 150ms;
+    ShardCoordinator coordinator(2, config);
+
+    RadarFrame west;
+    west.push(-800.0, 0.0, 0.0, 10.0);
+    west.push(-200.0, 100.0, 0.0, 200.0);
+    RadarFrame east;
+    east.push(900.0, 0.0, 0.0, 10.0);
+    shard0.scan(west, kStamp);
+    shard1.scan(east, kStamp);
+    coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+    auto threats = coordinator.topThreats();
+    ASSERT_EQ(threats.size(), 3u);
+    EXPECT_EQ(threats[0].threat_level, static_cast<std::uint8_t>(ThreatLevel::CRITICAL));
+
+    // Shard 1 stops reporting; two scans on, its last report is 200 ms
+    // behind and dropped.
+    for (int scan = 1; scan <= 2; ++scan) shard0.scan(west, kStamp + scan * 100ms);
+    coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+    threats = coordinator.topThreats();
+    EXPECT_EQ(threats.size(), 2u);
+}
+
+// One detector, tracker and worker per shard, replaceable to restart one.
+struct ShardNode {
+    ShardNode(const ShardLayout& layout, std::uint32_t id, ShardTransport& transport)
+        : detector(0.4), tracker(ShardWorker::trackerConfig(layout, id)),
+          worker(layout, id, detector, tracker, transport) {}
+    TargetDetector detector;
+    TargetTracker tracker;
+    ShardWorker worker;
+};
+
+// A threat in each half of the default two-shard layout.
+RadarFrame westFrame() {
+    RadarFrame frame;
+    frame.push(-800.0, 0.0, 0.0, 10.0);
+    return frame;
+}
+
+RadarFrame eastFrame() {
+    RadarFrame frame;
+    frame.push(900.0, 0.0, 0.0, 10.0);
+    return frame;
+}
+
+TEST(ShardCoordinator, LateStartingShardIsMerged) {
+    LoopbackShardNetwork network(2);
+    const ShardLayout layout;
+    ShardNode west(layout, 0, network.endpoint(0));
+    ShardNode east(layout, 1, network.endpoint(1));
+    ShardCoordinator coordinator(2);
+    const RadarFrame west_frame = westFrame();
+    const RadarFrame east_frame = eastFrame();
+
+    // Shard 0 is twenty scans in before shard 1 sends its first report.
+    for (int scan = 0; scan < 20; ++scan) west.worker.scan(west_frame, kStamp + scan * 100ms);
+    coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+    EXPECT_EQ(coordinator.topThreats().size(), 1u);
+    east.worker.scan(east_frame, kStamp + 1900ms);
+    coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+    EXPECT_EQ(coordinator.topThreats().size(), 2u);
+    EXPECT_EQ(coordinator.newestStamp(), kStamp + 1900ms);
+
+    // Scanning at a tenth of the rate keeps it in as long as it is within
+    // max_lag of the newest report.
+    for (int scan = 20; scan < 29; ++scan) west.worker.scan(west_frame, kStamp + scan * 100ms);
+    coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+    EXPECT_EQ(coordinator.topThreats().size(), 2u);
+    EXPECT_EQ(coordinator.stats().reordered, 0u);
+}
+
+TEST(ShardCoordinator, RestartedShardIsMergedAgain) {
+    LoopbackShardNetwork network(2);
+    const ShardLayout layout;
+    ShardNode west(layout, 0, network.endpoint(0));
+    auto east = std::make_unique<ShardNode>(layout, 1, network.endpoint(1));
+    ShardCoordinator coordinator(2);
+    const RadarFrame west_frame = westFrame();
+    const RadarFrame east_frame = eastFrame();
+
+    for (int scan = 0; scan < 10; ++scan) {
+        west.worker.scan(west_frame, kStamp + scan * 100ms);
+        east->worker.scan(east_frame, kStamp + scan * 100ms);
+    }
+    coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+    ASSERT_EQ(coordinator.topThreats().size(), 2u);
+
+    // Shard 1 restarts: its scan count begins again at 1, its stamps do not.
+    east = std::make_unique<ShardNode>(layout, 1, network.endpoint(1));
+    for (int scan = 10; scan < 30; ++scan) {
+        west.worker.scan(west_frame, kStamp + scan * 100ms);
+        if (scan >= 25) east->worker.scan(east_frame, kStamp + scan * 100ms);
+    }
+    EXPECT_EQ(east->worker.stats().scans, 5u);
+    coordinator.poll(network.endpoint(ShardTransport::kCoordinator));
+    const auto threats = coordinator.topThreats();
+    ASSERT_EQ(threats.size(), 2u);
+    EXPECT_EQ(threats[0].x + threats[1].x, 100.0);
+    EXPECT_EQ(coordinator.stats().reordered, 0u);
+}
+
+TEST(ShardCoordinator, DropsReorderedReportsAndResyncsOnALargeJumpBack) {
+    LoopbackShardNetwork network(2);
+    const ShardLayout layout;
+    ShardNode west(layout, 0, network.endpoint(0));
+    ShardCoordinator coordinator(2);
+    const RadarFrame west_frame = westFrame();
+    ShardTransport& inbox = network.endpoint(ShardTransport::kCoordinator);
+    const auto reportAt = [&](std::chrono::system_clock::time_point stamp) {
+        west.worker.scan(west_frame, stamp);
+        const auto datagram = inbox.receive();
+        return std::vector<std::byte>(datagram.begin(), datagram.end());
+    };
+
+    const auto first = reportAt(kStamp);
+    const auto second = reportAt(kStamp + 100ms);
+    ASSERT_TRUE(coordinator.accept(second));
+    ASSERT_TRUE(coordinator.accept(first));
+    EXPECT_EQ(coordinator.stats().reordered, 1u);
+    EXPECT_EQ(coordinator.newestStamp(), kStamp + 100ms);
+
+    // The shard's clock steps back by an hour.
+    ASSERT_TRUE(coordinator.accept(reportAt(kStamp - 1h)));
+    EXPECT_EQ(coordinator.stats().resyncs, 1u);
+    EXPECT_EQ(coordinator.newestStamp(), kStamp - 1h);
+    EXPECT_EQ(coordinator.topThreats().size(), 1u);
+    EXPECT_EQ(coordinator.stats().reports, 3u);
+}
+
+} // namespace
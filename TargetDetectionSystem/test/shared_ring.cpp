@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TargetRecordFormat.h"
+#include "TargetSink.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// SharedRingSink against an independent read-only mapping of its file,
+// the way another process consumes it.
+
+namespace {
+
+#ifdef __linux__
+
+class RingMapping {
+public:
+    explicit RingMapping(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        const off_t size = ::lseek(fd, 0, SEEK_END);
+        void* view = ::mmap(nullptr, static_cast<std::size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return;
+        view_ = view;
+        size_ = static_cast<std::size_t>(size);
+    }
+    ~RingMapping() {
+        if (view_) ::munmap(view_, size_);
+    }
+    RingMapping(const RingMapping&) = delete;
+    RingMapping& operator=(const RingMapping&) = delete;
+
+    const SharedRingHeader* header() const noexcept { return static_cast<const SharedRingHeader*>(view_); }
+    const TargetRecord* records() const noexcept { return reinterpret_cast<const TargetRecord*>(header() + 1); }
+
+private:
+    void* view_{nullptr};
+    std::size_t size_{0};
+};
+
+// Every field of record n derives from n, so a record mixing two writes
+// shows up as fields that disagree.
+Target targetFor(std::uint64_t n) {
+    const double v = static_cast<double>(n);
+    return Target(static_cast<std::uint32_t>(n), v, v, v, v, v, ThreatLevel::LOW);
+}
+
+bool intact(const TargetRecord& record) {
+    return record.x == static_cast<double>(record.id) && record.y == record.x && record.z == record.x
+        && record.velocity == record.x && record.confidence == record.x;
+}
+
+void writeBatch(SharedRingSink& sink, std::uint64_t& next, std::size_t count, std::uint64_t sequence) {
+    std::vector<Target> batch;
+    for (std::size_t i = 0; i < count; ++i) batch.push_back(targetFor(next++));
+    ASSERT_TRUE(sink.write(batch, sequence));
+}
+
+std::string ringPath(const char* name) {
+    return ::testing::TempDir() + name + std::to_string(::getpid());
+}
+
+TEST(SharedRing, ReadsPublishedBatchesInOrder) {
+    const std::string path = ringPath("ring_order");
+    SharedRingSink sink(16);
+    ASSERT_TRUE(sink.open(path));
+    RingMapping ring(path);
+    ASSERT_NE(ring.header(), nullptr);
+    EXPECT_EQ(ring.header()->version, kSharedRingVersion);
+
+    std::uint64_t next = 0;
+    writeBatch(sink, next, 5, 1);
+    writeBatch(sink, next, 6, 2);
+
+    std::uint64_t cursor = 0;
+    std::vector<TargetRecord> out(32);
+    ASSERT_EQ(readSharedRing(*ring.header(), ring.records(), cursor, out), 11u);
+    EXPECT_EQ(cursor, 11u);
+    for (std::uint32_t i = 0; i < 11; ++i) {
+        EXPECT_EQ(out[i].id, i);
+        EXPECT_EQ(out[i].sequence, i < 5 ? 1u : 2u);
+    }
+    EXPECT_EQ(ring.header()->last_sequence.load(), 2u);
+    EXPECT_EQ(readSharedRing(*ring.header(), ring.records(), cursor, out), 0u);
+
+    // A short buffer reads the backlog in pieces.
+    writeBatch(sink, next, 4, 3);
+    std::vector<TargetRecord> small(3);
+    ASSERT_EQ(readSharedRing(*ring.header(), ring.records(), cursor, small), 3u);
+    EXPECT_EQ(small[0].id, 11u);
+    ASSERT_EQ(readSharedRing(*ring.header(), ring.records(), cursor, small), 1u);
+    EXPECT_EQ(small[0].id, 14u);
+    sink.close();
+    std::remove(path.c_str());
+}
+
+TEST(SharedRing, LappedReaderSkipsToOldestLiveRecord) {
+    const std::string path = ringPath("ring_lapped");
+    SharedRingSink sink(8);
+    ASSERT_TRUE(sink.open(path));
+    RingMapping ring(path);
+    ASSERT_NE(ring.header(), nullptr);
+
+    std::uint64_t next = 0;
+    writeBatch(sink, next, 6, 1);
+    writeBatch(sink, next, 7, 2);
+    // A batch larger than the ring keeps only its newest records.
+    writeBatch(sink, next, 11, 3);
+    EXPECT_EQ(sink.head(), 24u);
+
+    std::uint64_t cursor = 2;
+    std::vector<TargetRecord> out(16);
+    ASSERT_EQ(readSharedRing(*ring.header(), ring.records(), cursor, out), 8u);
+    EXPECT_EQ(cursor, 24u);
+    for (std::uint32_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(out[i].id, 16 + i);
+        EXPECT_TRUE(intact(out[i]));
+    }
+    sink.close();
+    std::remove(path.c_str());
+}
+
+// A writer lapping a polling reader as fast as it can: whatever the reader
+// keeps must be whole and strictly increasing.
+TEST(SharedRing, ConcurrentReaderNeverKeepsTornRecords) {
+    const std::string path = ringPath("ring_torn");
+    SharedRingSink sink(64);
+    ASSERT_TRUE(sink.open(path));
+    RingMapping ring(path);
+    ASSERT_NE(ring.header(), nullptr);
+
+    constexpr std::uint64_t kRecords = 400000;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        std::uint64_t next = 0;
+        std::uint64_t sequence = 0;
+        while (next < kRecords) {
+            ++sequence;
+            writeBatch(sink, next, 1 + (sequence * 7) % 53, sequence);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    std::uint64_t cursor = 0;
+    std::uint64_t kept = 0;
+    std::int64_t last = -1;
+    std::vector<TargetRecord> out(64);
+    bool ordered = true;
+    bool whole = true;
+    for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        const std::size_t count = readSharedRing(*ring.header(), ring.records(), cursor, out);
+        for (std::size_t i = 0; i < count; ++i) {
+            whole = whole && intact(out[i]);
+            ordered = ordered && static_cast<std::int64_t>(out[i].id) > last;
+            last = out[i].id;
+        }
+        kept += count;
+        if (finished && cursor == sink.head()) break;
+    }
+    writer.join();
+
+    EXPECT_TRUE(whole);
+    EXPECT_TRUE(ordered);
+    EXPECT_GT(kept, 0u);
+    EXPECT_LE(kept, kRecords);
+    sink.close();
+    std::remove(path.c_str());
+}
+
+#else
+
+TEST(SharedRing, ReadsPublishedBatchesInOrder) {
+    GTEST_SKIP() << "the test maps the ring with POSIX mmap";
+}
+
+#endif
+
+} // namespace
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "SpatialGrid.h"
+#include "TargetDetector.h"
+#include "TargetTracker.h"
+
+namespace {
+
+std::vector<Neighbor> bruteForce(const std::vector<double>& x, const std::vector<double>& y,
+                                 const std::vector<double>& z, double qx, double qy, double qz, double radius) {
+    std::vector<Neighbor> out;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        const double dx = x[i] - qx;
+        const double dy = y[i] - qy;
+        const double dz = z[i] - qz;
+        const double distance_sq = dx * dx + dy * dy + dz * dz;
+        if (distance_sq <= radius * radius) out.push_back({static_cast<std::uint32_t>(i), distance_sq});
+    }
+    return out;
+}
+
+std::vector<std::uint32_t> indices(std::vector<Neighbor> neighbors) {
+    std::vector<std::uint32_t> out;
+    for (const auto& neighbor : neighbors) out.push_back(neighbor.index);
+    std::ranges::sort(out);
+    return out;
+}
+
+// Enough inserts into fresh cells to grow the cell table several times.
+TEST(SpatialGrid, InsertedPointsAnswerQueriesLikeARebuild) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> coord(-2000.0, 2000.0);
+    std::vector<double> x, y, z;
+    for (int i = 0; i < 20; ++i) {
+        x.push_back(coord(rng));
+        y.push_back(coord(rng));
+        z.push_back(coord(rng));
+    }
+    SpatialGrid grid(100.0);
+    grid.build(x, y, z);
+    for (int i = 0; i < 500; ++i) {
+        x.push_back(coord(rng));
+        y.push_back(coord(rng));
+        z.push_back(coord(rng));
+        grid.insert(x.back(), y.back(), z.back(), static_cast<std::uint32_t>(x.size() - 1));
+    }
+    // Outside the bounds of the built points, and several in one cell.
+    for (int i = 0; i < 3; ++i) {
+        x.push_back(9000.0 + i);
+        y.push_back(-9000.0);
+        z.push_back(0.0);
+        grid.insert(x.back(), y.back(), z.back(), static_cast<std::uint32_t>(x.size() - 1));
+    }
+    ASSERT_EQ(grid.size(), x.size());
+
+    std::vector<Neighbor> found;
+    for (int q = 0; q < 200; ++q) {
+        const double qx = q == 0 ? 9000.0 : coord(rng);
+        const double qy = q == 0 ? -9000.0 : coord(rng);
+        const double qz = q == 0 ? 0.0 : coord(rng);
+        grid.radiusQuery(qx, qy, qz, 250.0, found);
+        EXPECT_EQ(indices(found), indices(bruteForce(x, y, z, qx, qy, qz, 250.0))) << "query " << q;
+
+        grid.nearest(qx, qy, qz, 4, found);
+        auto expected = bruteForce(x, y, z, qx, qy, qz, 1e9);
+        std::ranges::sort(expected, {}, &Neighbor::distance_sq);
+        ASSERT_EQ(found.size(), 4u);
+        for (std::size_t k = 0; k < found.size(); ++k) EXPECT_EQ(found[k].distance_sq, expected[k].distance_sq);
+    }
+}
+
+TEST(SpatialGrid, RebuildDropsInsertedPoints) {
+    const std::vector<double> x = {0.0}, y = {0.0}, z = {0.0};
+    SpatialGrid grid(100.0);
+    grid.build(x, y, z);
+    grid.insert(10.0, 0.0, 0.0, 1);
+    grid.build(x, y, z);
+    std::vector<Neighbor> found;
+    grid.radiusQuery(0.0, 0.0, 0.0, 50.0, found);
+    EXPECT_EQ(indices(found), std::vector<std::uint32_t>{0});
+
+    grid.clear();
+    grid.insert(10.0, 0.0, 0.0, 3);
+    grid.radiusQuery(0.0, 0.0, 0.0, 50.0, found);
+    EXPECT_EQ(indices(found), std::vector<std::uint32_t>{3});
+}
+
+// A second sensor's correct() in the same scan associates with the track
+// the first one spawned instead of spawning a duplicate.
+TEST(TargetTracker, LaterCorrectionsSeeTracksSpawnedThisScan) {
+    TargetTracker tracker;
+    const auto stamp = std::chrono::system_clock::time_point{} + std::chrono::seconds(1);
+    std::vector<Target> first = {Target(0, 100.0, 0.0, 0.0, 0.0, 0.9, ThreatLevel::HIGH)};
+    tracker.update(first, stamp);
+
+    std::vector<Target> a = {Target(0, 100.0, 0.0, 0.0, 0.0, 0.9, ThreatLevel::HIGH),
+                             Target(0, -600.0, 0.0, 0.0, 0.0, 0.9, ThreatLevel::HIGH)};
+    std::vector<Target> b = {Target(0, -598.0, 1.0, 0.0, 0.0, 0.9, ThreatLevel::HIGH)};
+    tracker.beginScan(stamp + std::chrono::milliseconds(100));
+    tracker.correct(a);
+    tracker.correct(b);
+    tracker.endScan();
+    EXPECT_EQ(tracker.trackCount(), 2u);
+    EXPECT_EQ(b[0].id, a[1].id);
+    EXPECT_EQ(a[0].id, first[0].id);
+}
+
+} // namespace
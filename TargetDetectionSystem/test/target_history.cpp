@@ -0,0 +1,290 @@
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include "BitStream.h"
+#include "RecordingFormat.h"
+#include "TargetHistory.h"
+
+// Round trips through each history codec, on the inputs that sit at the
+// edges of its encoding: word boundaries, the Gorilla window, every
+// delta-of-delta bucket, values a quantum cannot hold, partial decodes
+// and eviction.
+
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+std::chrono::system_clock::time_point at(std::int64_t ns) {
+    return fromStampNs(ns);
+}
+
+Target row(std::uint32_t id, std::int64_t ns, double x, std::uint16_t description = DescriptionTable::kNone) {
+    Target target(id, x, -x, 0.5 * x, x, 0.25, ThreatLevel::MEDIUM, at(ns), description);
+    return target;
+}
+
+bool sameBits(double a, double b) {
+    return std::bit_cast<std::uint64_t>(a) == std::bit_cast<std::uint64_t>(b);
+}
+
+// Rows come back sorted by (id, stamp) per chunk, so tests append in that
+// order and compare position by position.
+void expectSameRows(const std::vector<Target>& in, const std::vector<Target>& out) {
+    ASSERT_EQ(out.size(), in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        EXPECT_EQ(out[i].id, in[i].id) << "row " << i;
+        EXPECT_EQ(out[i].detection_time, in[i].detection_time) << "row " << i;
+        EXPECT_EQ(out[i].threat_level, in[i].threat_level) << "row " << i;
+        EXPECT_EQ(out[i].description_id, in[i].description_id) << "row " << i;
+        EXPECT_TRUE(sameBits(out[i].x, in[i].x)) << "row " << i << ": " << out[i].x << " vs " << in[i].x;
+        EXPECT_TRUE(sameBits(out[i].y, in[i].y)) << "row " << i;
+        EXPECT_TRUE(sameBits(out[i].z, in[i].z)) << "row " << i;
+        EXPECT_TRUE(sameBits(out[i].velocity, in[i].velocity)) << "row " << i;
+        EXPECT_TRUE(sameBits(out[i].confidence, in[i].confidence)) << "row " << i;
+    }
+}
+
+// Appends rows, then one row a span later so they are sealed into a chunk,
+// and queries them back without the sealing row.
+std::vector<Target> roundTrip(TargetHistory& history, const std::vector<Target>& rows, std::int64_t seal_ns) {
+    history.append(rows);
+    history.append(std::vector<Target>{row(0, seal_ns, 0.0)});
+    HistoryQuery query;
+    query.to = at(seal_ns);
+    std::vector<Target> out;
+    history.query(query, out);
+    return out;
+}
+
+TEST(BitStream, RoundTripsEveryWidthAtEveryOffset) {
+    std::mt19937_64 rng(11);
+    std::vector<std::uint64_t> words;
+    std::vector<std::pair<std::uint64_t, unsigned>> written;
+    BitWriter out(words);
+    // A 64-bit value at each of the 64 word offsets, then random widths.
+    for (unsigned offset = 0; offset < 64; ++offset) {
+        if (offset > 0) {
+            written.push_back({rng(), 1});
+            out.put(written.back().first, 1);
+        }
+        written.push_back({rng(), 64});
+        out.put(written.back().first, 64);
+    }
+    for (int i = 0; i < 2000; ++i) {
+        const unsigned bits = static_cast<unsigned>(rng() % 64) + 1;
+        written.push_back({rng(), bits});
+        out.put(written.back().first, bits);
+    }
+    EXPECT_EQ(words.size(), (out.bits() + 63) / 64);
+
+    BitReader in(words);
+    for (std::size_t i = 0; i < written.size(); ++i) {
+        const auto [value, bits] = written[i];
+        const std::uint64_t expected = bits == 64 ? value : value & ((std::uint64_t{1} << bits) - 1);
+        ASSERT_EQ(in.get(bits), expected) << "value " << i << ", " << bits << " bits";
+    }
+    EXPECT_EQ(in.bits(), out.bits());
+}
+
+TEST(BitStream, ValuesEndingExactlyOnAWordBoundary) {
+    std::vector<std::uint64_t> words;
+    BitWriter out(words);
+    out.put(0x5, 3);
+    out.put(~std::uint64_t{0}, 61);
+    EXPECT_EQ(words.size(), 1u);
+    out.put(0x8000000000000001ULL, 64);
+    EXPECT_EQ(words.size(), 2u);
+    out.put(1, 1);
+    EXPECT_EQ(words.size(), 3u);
+
+    BitReader in(words);
+    EXPECT_EQ(in.get(3), 0x5u);
+    EXPECT_EQ(in.get(61), (std::uint64_t{1} << 61) - 1);
+    EXPECT_EQ(in.get(64), 0x8000000000000001ULL);
+    EXPECT_TRUE(in.bit());
+}
+
+// Neighbouring doubles XOR to a few low bits, more than 31 leading zeros,
+// which the 5-bit field caps; repeats of the same XOR shape reuse the
+// window, and a wider XOR forces a new one.
+TEST(TargetHistory, GorillaColumnsRoundTripBitExactly) {
+    TargetHistory history;
+    std::vector<Target> rows;
+    std::int64_t ns = 1'000'000'000;
+    double v = 1.0;
+    for (int i = 0; i < 40; ++i) {
+        rows.push_back(row(1, ns += 1000, v));
+        v = std::nextafter(v, 2.0);
+    }
+    for (int i = 0; i < 10; ++i) rows.push_back(row(1, ns += 1000, i % 2 ? 1.0 : std::nextafter(1.0, 2.0)));
+    rows.push_back(row(1, ns += 1000, 1.0));
+    const double odd[] = {-0.0, 0.0, 1e-310, -1e308, kInf, -kInf, std::numeric_limits<double>::quiet_NaN(),
+                          std::bit_cast<double>(0x7ff0000000000001ULL), std::bit_cast<double>(0xfff8dead00000000ULL),
+                          3.0, 3.0, std::numeric_limits<double>::denorm_min(), 12345.678};
+    for (double value : odd) rows.push_back(row(1, ns += 1000, value));
+    // A track id change also exercises the two-bit id gap codes.
+    for (int i = 0; i < 20; ++i) rows.push_back(row(2 + i / 8, ns += 1000, 1000.0 + i * 0.001));
+    expectSameRows(rows, roundTrip(history, rows, ns + 100'000'000'000));
+}
+
+// Each delta-of-delta bucket at both of its edges, including the 64-bit
+// one for stamps far apart and the jump back when the id changes.
+TEST(TargetHistory, StampDeltaOfDeltaEveryBucket) {
+    HistoryConfig config;
+    config.chunk_span = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::hours(24 * 365 * 200));
+    TargetHistory history(config);
+
+    const std::int64_t edges[] = {0, 1, -1, 63, -64, 64, -65, 255, -256, 256, -257, 2047, -2048, 2048, -2049,
+                                  (std::int64_t{1} << 31) - 1, -(std::int64_t{1} << 31), std::int64_t{1} << 31,
+                                  -(std::int64_t{1} << 31) - 1, std::int64_t{1} << 40};
+    std::vector<Target> rows;
+    // Far enough from the epoch for every negative edge to stay ordered.
+    std::int64_t ns = std::int64_t{1} << 50;
+    std::int64_t delta = std::int64_t{1} << 45;
+    for (std::int64_t dod : edges) {
+        delta += dod;
+        rows.push_back(row(1, ns += delta, 1.0));
+    }
+    // Jumps the 32-bit bucket cannot hold, up to most of the int64 range.
+    rows.push_back(row(1, ns += std::int64_t{1} << 61, 1.0));
+    rows.push_back(row(1, ns += 1, 1.0));
+    rows.push_back(row(1, ns += std::int64_t{1} << 60, 1.0));
+    // A new id restarts at an early stamp: a large negative delta.
+    const std::int64_t restart = (std::int64_t{1} << 50) + 7;
+    rows.push_back(row(2, restart, 1.0));
+    rows.push_back(row(2, restart + 3, 1.0));
+    ASSERT_LT(ns, std::int64_t{1} << 62);
+    expectSameRows(rows, roundTrip(history, rows, (std::int64_t{1} << 62) + (std::int64_t{1} << 61)));
+}
+
+// A column with NaN, an infinity or a value beyond 2^52 quanta falls back
+// to the exact encoding for its chunk; the others stay within half a
+// quantum.
+TEST(TargetHistory, QuantumFallsBackOnValuesItCannotHold) {
+    HistoryConfig config;
+    config.chunk_span = 10s;
+    config.position_quantum = 0.01;
+    config.velocity_quantum = 0.5;
+    TargetHistory history(config);
+
+    const double unrepresentable[] = {std::numeric_limits<double>::quiet_NaN(), kInf, -kInf, 0.01 * 9.1e15};
+    std::int64_t chunk_ns = 0;
+    for (double bad : unrepresentable) {
+        std::vector<Target> rows;
+        for (int i = 0; i < 6; ++i) {
+            Target target = row(1, chunk_ns + 1'000'000'000 + i * 1'000'000, 10.0 + i * 0.123456789);
+            if (i == 3) target.x = bad;
+            rows.push_back(target);
+        }
+        history.append(rows);
+        HistoryQuery query;
+        // Past the row that sealed the previous chunk.
+        query.from = at(chunk_ns + 1'000'000'000);
+        query.to = at(chunk_ns + 10'000'000'000);
+        // Seal this chunk by opening the next one.
+        chunk_ns += 10'000'000'000;
+        history.append(std::vector<Target>{row(0, chunk_ns, 0.0)});
+        std::vector<Target> out;
+        ASSERT_EQ(history.query(query, out), rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            EXPECT_TRUE(sameBits(out[i].x, rows[i].x)) << "row " << i << " x " << out[i].x;
+            EXPECT_NEAR(out[i].y, rows[i].y, 0.005 + 1e-12);
+            EXPECT_NEAR(out[i].z, rows[i].z, 0.005 + 1e-12);
+            EXPECT_NEAR(out[i].velocity, rows[i].velocity, 0.25 + 1e-12);
+            EXPECT_TRUE(sameBits(out[i].confidence, rows[i].confidence));
+        }
+    }
+}
+
+// A query for one id stops decoding at its last row, which leaves the
+// streams, and the description runs in particular, cut off mid-chunk.
+TEST(TargetHistory, PartialDecodeStopsAtTheLastSelectedRow) {
+    TargetHistory history;
+    std::vector<Target> rows;
+    std::int64_t ns = 5'000'000'000;
+    for (std::uint32_t id = 10; id < 16; ++id) {
+        for (int i = 0; i < 7; ++i) {
+            rows.push_back(row(id, ns + i * 100'000'000, id * 100.0 + i * 0.37,
+                               static_cast<std::uint16_t>(i < 4 ? id : id + 1)));
+        }
+    }
+    // Ids 13 and 14 share one description run across the boundary.
+    for (auto& target : rows) {
+        if (target.id == 13 || target.id == 14) target.description_id = 99;
+    }
+    history.append(rows);
+    history.append(std::vector<Target>{row(0, ns + 20'000'000'000, 0.0)});
+
+    for (std::uint32_t id = 10; id < 16; ++id) {
+        for (std::uint32_t columns : {std::uint32_t{kHistoryAll}, std::uint32_t{kHistoryDescription},
+                                      std::uint32_t{kHistoryPosition | kHistoryStamp}}) {
+            HistoryQuery query;
+            query.id = id;
+            query.to = at(ns + 10'000'000'000);
+            std::vector<Target> out;
+            ASSERT_EQ(history.query(query, out, columns), 7u) << "id " << id;
+            for (int i = 0; i < 7; ++i) {
+                const Target& in = rows[(id - 10) * 7 + static_cast<std::size_t>(i)];
+                if (columns & kHistoryDescription) {
+                    EXPECT_EQ(out[i].description_id, in.description_id);
+                }
+                if (columns & kHistoryPosition) {
+                    EXPECT_TRUE(sameBits(out[i].x, in.x));
+                }
+                if (columns & kHistoryStamp) {
+                    EXPECT_EQ(out[i].detection_time, in.detection_time);
+                }
+                if (!(columns & kHistoryId)) {
+                    EXPECT_EQ(out[i].id, 0u);
+                }
+            }
+        }
+    }
+    // Only the later half of each track, so the first selected row is not
+    // the first row of the chunk either.
+    HistoryQuery query;
+    query.id = 12;
+    query.from = at(ns + 400'000'000);
+    query.to = at(ns + 10'000'000'000);
+    std::vector<Target> out;
+    ASSERT_EQ(history.query(query, out), 3u);
+    EXPECT_EQ(out[0].detection_time, at(ns + 400'000'000));
+    EXPECT_EQ(out[0].description_id, 13u);
+    EXPECT_EQ(history.count(query), 3u);
+}
+
+TEST(TargetHistory, RetentionEvictsWholeChunks) {
+    HistoryConfig config;
+    config.chunk_span = 10s;
+    config.retention = 25s;
+    TargetHistory history(config);
+    for (std::int64_t second = 0; second < 60; ++second) {
+        history.append(std::vector<Target>{row(1, second * 1'000'000'000, static_cast<double>(second))});
+    }
+    // Newest row at 59 s: chunks ending before 34 s are gone, so [30, 40)
+    // is the oldest left, plus the open [50, 60).
+    const HistoryStats stats = history.stats();
+    EXPECT_EQ(stats.chunks, 3u);
+    EXPECT_EQ(stats.rows, 30u);
+
+    HistoryQuery everything;
+    std::vector<Target> out;
+    ASSERT_EQ(history.query(everything, out), 30u);
+    EXPECT_EQ(out.front().detection_time, at(30'000'000'000));
+    EXPECT_EQ(out.back().detection_time, at(59'000'000'000));
+    EXPECT_EQ(history.count(everything), 30u);
+
+    HistoryQuery expired;
+    expired.to = at(30'000'000'000);
+    EXPECT_EQ(history.count(expired), 0u);
+}
+
+} // namespace
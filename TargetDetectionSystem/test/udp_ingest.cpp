@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "RadarFrame.h"
+#include "UdpIngest.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Sends datagrams to an UdpIngest bound on loopback. Everything is sent
+// before fill() runs, so a test sees them queued in the order written.
+class Sender {
+public:
+    explicit Sender(std::uint16_t port) : fd_(::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0)) {
+        address_.sin_family = AF_INET;
+        address_.sin_port = htons(port);
+        ::inet_pton(AF_INET, "127.0.0.1", &address_.sin_addr);
+    }
+    ~Sender() {
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    void send(const std::vector<std::byte>& datagram) {
+        ASSERT_EQ(::sendto(fd_, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&address_),
+                           sizeof(address_)),
+                  static_cast<ssize_t>(datagram.size()));
+    }
+
+    // returns returns, each tagged with the packet's sequence as velocity.
+    void send(std::uint64_t sequence, std::uint32_t frame_id, bool end_of_frame, std::size_t returns = 1) {
+        RadarFrame frame;
+        for (std::size_t i = 0; i < returns; ++i) frame.push(1.0, 2.0, 3.0, static_cast<double>(sequence));
+        std::vector<std::byte> datagram(sizeof(IngestPacketHeader) + returns * kIngestReturnBytes);
+        ASSERT_EQ(UdpIngest::encodePacket(datagram, sequence, frame_id, std::chrono::system_clock::now(),
+                                          end_of_frame, frame.view()),
+                  datagram.size());
+        send(datagram);
+    }
+
+private:
+    int fd_;
+    sockaddr_in address_{};
+};
+
+UdpIngestConfig loopback() {
+    UdpIngestConfig config;
+    config.bind_address = "127.0.0.1";
+    config.port = 0;
+    config.poll_interval = 10ms;
+    return config;
+}
+
+std::vector<double> velocities(const RadarFrame& frame) {
+    return {frame.velocity.begin(), frame.velocity.end()};
+}
+
+TEST(UdpIngest, StaleStragglerDoesNotCloseTheOpenFrame) {
+    UdpIngest ingest(loopback());
+    if (!ingest.open()) GTEST_SKIP() << "cannot bind a loopback socket";
+    Sender sender(ingest.boundPort());
+    sender.send(10, 2, false);
+    sender.send(9, 1, false);
+    sender.send(11, 2, true);
+
+    RadarFrame frame;
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{10.0, 11.0}));
+    const UdpIngestStats stats = ingest.stats();
+    EXPECT_EQ(stats.frames, 1u);
+    EXPECT_EQ(stats.incomplete_frames, 0u);
+    EXPECT_EQ(stats.packets_reordered, 1u);
+    EXPECT_EQ(stats.sequence_gaps, 0u);
+    EXPECT_EQ(stats.packets, 3u);
+}
+
+TEST(UdpIngest, SenderRestartResyncsTheSequence) {
+    UdpIngestConfig config = loopback();
+    config.reorder_window = 16;
+    UdpIngest ingest(config);
+    if (!ingest.open()) GTEST_SKIP() << "cannot bind a loopback socket";
+    Sender sender(ingest.boundPort());
+    sender.send(5000, 900, true);
+    // Within the window: a straggler.
+    sender.send(4990, 899, true);
+    // The sender restarts mid-frame; its sequence and frame ids start over.
+    sender.send(5001, 901, false);
+    sender.send(0, 0, false);
+    sender.send(1, 0, true);
+    sender.send(2, 1, true);
+
+    RadarFrame frame;
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{5000.0}));
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{5001.0}));
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{0.0, 1.0}));
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{2.0}));
+    const UdpIngestStats stats = ingest.stats();
+    EXPECT_EQ(stats.packets_reordered, 1u);
+    EXPECT_EQ(stats.sequence_resyncs, 1u);
+    EXPECT_EQ(stats.incomplete_frames, 1u);
+    EXPECT_EQ(stats.sequence_gaps, 0u);
+}
+
+TEST(UdpIngest, OlderFrameIdIsDroppedWithoutClosingTheFrame) {
+    UdpIngest ingest(loopback());
+    if (!ingest.open()) GTEST_SKIP() << "cannot bind a loopback socket";
+    Sender sender(ingest.boundPort());
+    sender.send(0, 5, false);
+    sender.send(1, 4, false);
+    sender.send(2, 5, true);
+
+    RadarFrame frame;
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{0.0, 2.0}));
+    const UdpIngestStats stats = ingest.stats();
+    EXPECT_EQ(stats.incomplete_frames, 0u);
+    EXPECT_EQ(stats.packets_reordered, 1u);
+    // Its sequence number was still consumed.
+    EXPECT_EQ(stats.sequence_gaps, 0u);
+}
+
+TEST(UdpIngest, NewerFrameClosesTheOpenOneAcrossTheWrap) {
+    UdpIngest ingest(loopback());
+    if (!ingest.open()) GTEST_SKIP() << "cannot bind a loopback socket";
+    Sender sender(ingest.boundPort());
+    sender.send(0, 0xffffffffu, false);
+    sender.send(1, 0, false);
+    sender.send(2, 0, true);
+
+    RadarFrame frame;
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{0.0}));
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{1.0, 2.0}));
+    const UdpIngestStats stats = ingest.stats();
+    EXPECT_EQ(stats.frames, 2u);
+    EXPECT_EQ(stats.incomplete_frames, 1u);
+    EXPECT_EQ(stats.packets_reordered, 0u);
+}
+
+TEST(UdpIngest, TruncatedDatagramsAreCountedApartFromMalformed) {
+    UdpIngestConfig config = loopback();
+    config.max_packet_bytes = sizeof(IngestPacketHeader) + 2 * kIngestReturnBytes;
+    UdpIngest ingest(config);
+    if (!ingest.open()) GTEST_SKIP() << "cannot bind a loopback socket";
+    Sender sender(ingest.boundPort());
+    // Past max_packet_bytes even after it is rounded up to a cache line.
+    sender.send(0, 1, false, 8);
+    sender.send(std::vector<std::byte>(7, std::byte{0x5a}));
+    sender.send(1, 1, true);
+
+    RadarFrame frame;
+    ASSERT_TRUE(ingest.fill(frame));
+    EXPECT_EQ(velocities(frame), (std::vector<double>{1.0}));
+    const UdpIngestStats stats = ingest.stats();
+    EXPECT_EQ(stats.truncated_packets, 1u);
+    EXPECT_EQ(stats.malformed_packets, 1u);
+    EXPECT_EQ(stats.packets, 1u);
+}
+
+} // namespace
+
+#endif